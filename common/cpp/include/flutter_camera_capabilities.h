@@ -0,0 +1,61 @@
+#ifndef FLUTTER_WEBRTC_CAMERA_CAPABILITIES_HXX
+#define FLUTTER_WEBRTC_CAMERA_CAPABILITIES_HXX
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace flutter_webrtc_plus_plugin {
+
+// Capture modes offered by each camera, so GetUserVideo can ask libwebrtc
+// for a size and rate the device can actually deliver.
+//
+// RTCVideoDevice::Create only takes width, height and fps, and libwebrtc
+// picks the pixel format itself from the closest matching capability. A
+// request the camera can't meet exactly (1080p30 on a USB webcam that
+// only does it as MJPEG, say) can land on a slow raw mode instead. Snapping
+// the request to an enumerated mode makes that match exact.
+//
+// Modes are enumerated through V4L2 on Linux and cached per device GUID;
+// elsewhere ModesFor() returns nothing and requests pass through as-is.
+class CameraCapabilities {
+ public:
+  struct Mode {
+    // V4L2 fourcc, e.g. "MJPG", "NV12" or "YUYV".
+    std::string pixel_format;
+    int width = 0;
+    int height = 0;
+    // Highest frame rate the camera offers for this format and size.
+    int fps = 0;
+  };
+
+  using Modes = std::vector<Mode>;
+
+  // Modes of the camera with |guid|, enumerated on first use. Never called
+  // with the cache lock held, so a slow device only blocks its own caller.
+  std::shared_ptr<const Modes> ModesFor(const std::string& guid);
+
+  // Forgets every camera; called when the device list changes.
+  void Clear();
+
+  // Picks the mode closest to the requested size, then the one that comes
+  // closest to |fps|, then the cheapest to turn into I420 (raw planar,
+  // then packed YUV, then MJPEG). Returns false if |modes| is empty.
+  static bool Choose(const Modes& modes,
+                     int width,
+                     int height,
+                     int fps,
+                     Mode* mode);
+
+ private:
+  static Modes Enumerate(const std::string& guid);
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<const Modes>> modes_;
+};
+
+}  // namespace flutter_webrtc_plus_plugin
+
+#endif  // !FLUTTER_WEBRTC_CAMERA_CAPABILITIES_HXX
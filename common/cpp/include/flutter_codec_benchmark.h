@@ -0,0 +1,21 @@
+#ifndef FLUTTER_WEBRTC_CODEC_BENCHMARK_HXX
+#define FLUTTER_WEBRTC_CODEC_BENCHMARK_HXX
+
+#include "flutter_common.h"
+
+namespace flutter_webrtc_plus_plugin {
+
+// Encodes and decodes the payloads the plugin sends most often with the
+// StandardMessageCodec it is built against: an SDP string, a stats report,
+// a 64 KB binary data channel message, typed lists and a nested list.
+class FlutterCodecBenchmark {
+ public:
+  // Round-trips every payload |rounds| times. Returns one entry per
+  // payload with its encoded size, mean encode and decode microseconds and
+  // whether the decoded value equals the original.
+  static EncodableMap Run(int rounds);
+};
+
+}  // namespace flutter_webrtc_plus_plugin
+
+#endif  // !FLUTTER_WEBRTC_CODEC_BENCHMARK_HXX
@@ -35,96 +35,115 @@ class TaskRunner;
 // foo.IsString() becomes std::holds_alternative<std::string>(foo)
 
 template <typename T>
-inline bool TypeIs(const EncodableValue val) {
+inline bool TypeIs(const EncodableValue& val) {
   return std::holds_alternative<T>(val);
 }
 
+// Returns a reference into |val|; bind it to a reference only while |val|
+// is alive.
 template <typename T>
-inline const T GetValue(EncodableValue val) {
+inline const T& GetValue(const EncodableValue& val) {
   return std::get<T>(val);
 }
 
-inline EncodableValue findEncodableValue(const EncodableMap& map,
-                                         const std::string& key) {
+// Pointer lookups: return the value stored under |key| without copying it,
+// or nullptr if the key is missing or holds a different type. The result
+// points into |map|.
+inline const EncodableValue* findEncodableValuePtr(const EncodableMap& map,
+                                                   const std::string& key) {
   auto it = map.find(EncodableValue(key));
   if (it != map.end())
-    return it->second;
-  return EncodableValue();
+    return &it->second;
+  return nullptr;
 }
 
-inline EncodableMap findMap(const EncodableMap& map, const std::string& key) {
-  auto it = map.find(EncodableValue(key));
-  if (it != map.end() && TypeIs<EncodableMap>(it->second))
-    return GetValue<EncodableMap>(it->second);
-  return EncodableMap();
+template <typename T>
+inline const T* findPtr(const EncodableMap& map, const std::string& key) {
+  const EncodableValue* value = findEncodableValuePtr(map, key);
+  if (value)
+    return std::get_if<T>(value);
+  return nullptr;
 }
 
-inline EncodableList findList(const EncodableMap& map, const std::string& key) {
-  auto it = map.find(EncodableValue(key));
-  if (it != map.end() && TypeIs<EncodableList>(it->second))
-    return GetValue<EncodableList>(it->second);
-  return EncodableList();
+// The reference-returning finders below fall back to a shared empty value,
+// so callers can bind the result to a const reference to avoid a copy.
+inline const EncodableValue& findEncodableValue(const EncodableMap& map,
+                                                const std::string& key) {
+  static const EncodableValue kEmpty;
+  const EncodableValue* value = findEncodableValuePtr(map, key);
+  return value ? *value : kEmpty;
 }
 
-inline std::string findString(const EncodableMap& map, const std::string& key) {
-  auto it = map.find(EncodableValue(key));
-  if (it != map.end() && TypeIs<std::string>(it->second))
-    return GetValue<std::string>(it->second);
-  return std::string();
+inline const EncodableMap& findMap(const EncodableMap& map,
+                                   const std::string& key) {
+  static const EncodableMap kEmpty;
+  const EncodableMap* value = findPtr<EncodableMap>(map, key);
+  return value ? *value : kEmpty;
+}
+
+inline const EncodableList& findList(const EncodableMap& map,
+                                     const std::string& key) {
+  static const EncodableList kEmpty;
+  const EncodableList* value = findPtr<EncodableList>(map, key);
+  return value ? *value : kEmpty;
+}
+
+inline const std::string& findString(const EncodableMap& map,
+                                     const std::string& key) {
+  static const std::string kEmpty;
+  const std::string* value = findPtr<std::string>(map, key);
+  return value ? *value : kEmpty;
 }
 
 inline int findInt(const EncodableMap& map, const std::string& key) {
-  auto it = map.find(EncodableValue(key));
-  if (it != map.end() && TypeIs<int>(it->second))
-    return GetValue<int>(it->second);
+  const int* value = findPtr<int>(map, key);
+  if (value)
+    return *value;
   return -1;
 }
 
 inline bool findBoolean(const EncodableMap& map, const std::string& key) {
-  auto it = map.find(EncodableValue(key));
-  if (it != map.end() && TypeIs<bool>(it->second))
-    return GetValue<bool>(it->second);
+  const bool* value = findPtr<bool>(map, key);
+  if (value)
+    return *value;
   return false;
 }
 
 inline double findDouble(const EncodableMap& map, const std::string& key) {
-  auto it = map.find(EncodableValue(key));
-  if (it != map.end() && TypeIs<double>(it->second))
-    return GetValue<double>(it->second);
+  const double* value = findPtr<double>(map, key);
+  if (value)
+    return *value;
   return 0.0;
 }
 
 inline std::optional<double> maybeFindDouble(const EncodableMap& map,
                                              const std::string& key) {
-  auto it = map.find(EncodableValue(key));
-  if (it != map.end() && TypeIs<double>(it->second))
-    return GetValue<double>(it->second);
+  const double* value = findPtr<double>(map, key);
+  if (value)
+    return *value;
   return std::nullopt;
 }
 
-inline std::vector<uint8_t> findVector(const EncodableMap& map,
-                                       const std::string& key) {
-  auto it = map.find(EncodableValue(key));
-  if (it != map.end() && TypeIs<std::vector<uint8_t>>(it->second))
-    return GetValue<std::vector<uint8_t>>(it->second);
-  return std::vector<uint8_t>();
+inline const std::vector<uint8_t>& findVector(const EncodableMap& map,
+                                              const std::string& key) {
+  static const std::vector<uint8_t> kEmpty;
+  const std::vector<uint8_t>* value = findPtr<std::vector<uint8_t>>(map, key);
+  return value ? *value : kEmpty;
 }
 
 inline int64_t findLongInt(const EncodableMap& map, const std::string& key) {
-  for (auto it : map) {
-    if (key == GetValue<std::string>(it.first)) {
-      if (TypeIs<int64_t>(it.second)) {
-        return GetValue<int64_t>(it.second);
-      } else if (TypeIs<int32_t>(it.second)) {
-        return GetValue<int32_t>(it.second);
-      }
+  const EncodableValue* value = findEncodableValuePtr(map, key);
+  if (value) {
+    if (TypeIs<int64_t>(*value)) {
+      return GetValue<int64_t>(*value);
+    } else if (TypeIs<int32_t>(*value)) {
+      return GetValue<int32_t>(*value);
     }
   }
-
   return -1;
 }
 
-inline int toInt(flutter::EncodableValue inputVal, int defaultVal) {
+inline int toInt(const flutter::EncodableValue& inputVal, int defaultVal) {
   int intValue = defaultVal;
   if (TypeIs<int>(inputVal)) {
     intValue = GetValue<int>(inputVal);
@@ -183,6 +202,10 @@ class EventChannelProxy {
 
   virtual void Success(const EncodableValue& event,
                        bool cache_event = true) = 0;
+
+  // Takes ownership of |event| so large payloads (e.g. data channel
+  // messages) are moved through the task runner instead of copied.
+  virtual void Success(EncodableValue&& event, bool cache_event = true) = 0;
 };
 
 #endif  // FLUTTER_WEBRTC_COMMON_HXX
@@ -3,6 +3,11 @@
 
 #include "flutter_common.h"
 #include "flutter_webrtc_base.h"
+#include "repeating_timer.h"
+
+#include <atomic>
+#include <deque>
+#include <thread>
 
 namespace flutter_webrtc_plus_plugin {
 
@@ -12,6 +17,10 @@ class FlutterRTCDataChannelObserver : public RTCDataChannelObserver {
                                 BinaryMessenger* messenger,
                                 TaskRunner* task_runner,
                                 const std::string& channel_name);
+  // Delivers events to |event_channel| instead of a Dart event channel; used
+  // by the data channel benchmark.
+  FlutterRTCDataChannelObserver(scoped_refptr<RTCDataChannel> data_channel,
+                                std::unique_ptr<EventChannelProxy> event_channel);
   virtual ~FlutterRTCDataChannelObserver();
 
   virtual void OnStateChange(RTCDataChannelState state) override;
@@ -20,14 +29,124 @@ class FlutterRTCDataChannelObserver : public RTCDataChannelObserver {
 
   scoped_refptr<RTCDataChannel> data_channel() { return data_channel_; }
 
+  // Sends |data| right away if nothing is queued and the SCTP buffer is below
+  // the high watermark; otherwise copies it into the native send queue, which
+  // is drained as the SCTP buffer empties.
+  void Send(const uint8_t* data, size_t size, bool binary);
+
+  // Enables send pacing. A |high_watermark| of 0 turns pacing off; messages
+  // already queued are still flushed in order.
+  void SetSendQueueWatermarks(uint64_t high_watermark, uint64_t low_watermark);
+
+  // SCTP buffered amount plus bytes waiting in the native send queue.
+  uint64_t buffered_amount();
+
+  // Streams the file at |path| as binary messages of |chunk_size| bytes. The
+  // file is read ahead in blocks, and only as fast as the send window drains,
+  // so it is never held in memory as a whole. Progress is reported through
+  // dataChannelFileSendProgress events. Returns false and sets |error| if the
+  // file cannot be opened or another file is still being sent.
+  bool SendFile(const std::string& path,
+                size_t chunk_size,
+                uint64_t* total_bytes,
+                std::string* error);
+
+  // Writes incoming binary messages to |path| instead of emitting them as
+  // dataChannelReceiveMessage events, until |expected_bytes| have arrived, or
+  // until the sink is closed if |expected_bytes| is 0. Text messages are still
+  // delivered as events. An empty |path| closes the current sink. Chunks are
+  // written on a writer thread, so a slow disk never holds up libwebrtc's
+  // network thread; a transfer that falls too far behind fails instead.
+  bool WriteToFile(const std::string& path,
+                   uint64_t expected_bytes,
+                   std::string* error);
+
+  // Enables receive batching: incoming messages are collected and emitted in
+  // order as a single dataChannelReceiveMessages event once |max_messages|
+  // or |max_bytes| is reached, or |max_delay| after the first message of the
+  // batch. A |max_messages| of 1 or less turns batching off again.
+  void SetReceiveBatching(int max_messages,
+                          uint64_t max_bytes,
+                          std::chrono::milliseconds max_delay);
+
  private:
+  struct FileSend;
+  struct FileSink;
+
+  struct PendingMessage {
+    std::vector<uint8_t> data;
+    bool binary;
+  };
+
+  // Timer task: drains the send queue and reports buffered amount changes.
+  // Returns false once there is nothing left to pace or report.
+  bool PumpSendQueue();
+
+  uint64_t SendLimit() const;
+
+  void ReportBufferedAmount(uint64_t amount);
+
+  // Timer task: sends file chunks while the send window has room.
+  bool PumpFileSend();
+
+  // Returns true if |buffer| was consumed by the file sink. Only queues the
+  // chunk; the file_write_timer_ task writes it.
+  bool WriteToFileSink(const char* buffer, int length);
+
+  // Timer task: writes the queued chunks of the current sink.
+  bool DrainFileSink();
+
+  // Writes |chunks| to |sink| and reports progress. Closes the file and
+  // returns true once the transfer is over: when |error| is set, a write
+  // fails or |input_done| says no more chunks will come.
+  bool WriteFileChunks(FileSink* sink,
+                       std::deque<std::vector<uint8_t>>* chunks,
+                       std::string error,
+                       bool input_done);
+
+  // Emits the pending receive batch, if any. Must hold receive_mutex_.
+  void FlushReceiveBatch();
+
+  void ReportFileProgress(const char* event,
+                          const std::string& path,
+                          uint64_t bytes,
+                          uint64_t total_bytes,
+                          bool done,
+                          const std::string& error);
+
   std::unique_ptr<EventChannelProxy> event_channel_;
   scoped_refptr<RTCDataChannel> data_channel_;
+
+  std::mutex send_mutex_;
+  std::deque<PendingMessage> send_queue_;
+  uint64_t queued_bytes_ = 0;
+  uint64_t high_watermark_ = 0;
+  uint64_t low_watermark_ = 0;
+  uint64_t reported_amount_ = 0;
+  bool above_low_watermark_ = false;
+  RepeatingTimer send_timer_;
+
+  std::mutex file_send_mutex_;
+  std::unique_ptr<FileSend> file_send_;
+  RepeatingTimer file_send_timer_;
+
+  std::mutex file_sink_mutex_;
+  std::shared_ptr<FileSink> file_sink_;
+  RepeatingTimer file_write_timer_;
+
+  std::mutex receive_mutex_;
+  int receive_batch_max_messages_ = 0;
+  uint64_t receive_batch_max_bytes_ = 0;
+  std::chrono::milliseconds receive_batch_max_delay_{0};
+  EncodableList receive_batch_;
+  uint64_t receive_batch_bytes_ = 0;
+  RepeatingTimer receive_timer_;
 };
 
 class FlutterDataChannel {
  public:
   FlutterDataChannel(FlutterWebRTCBase* base) : base_(base) {}
+  ~FlutterDataChannel();
 
   void CreateDataChannel(const std::string& peerConnectionId,
                          const std::string& label,
@@ -35,22 +154,58 @@ class FlutterDataChannel {
                          RTCPeerConnection* pc,
                          std::unique_ptr<MethodResultProxy>);
 
-  void DataChannelSend(RTCDataChannel* data_channel,
+  void DataChannelSend(FlutterRTCDataChannelObserver* observer,
                        const std::string& type,
                        const EncodableValue& data,
                        std::unique_ptr<MethodResultProxy>);
 
-  void DataChannelGetBufferedAmount(RTCDataChannel* data_channel,
-                       std::unique_ptr<MethodResultProxy> result);
+  void DataChannelSendBatch(FlutterRTCDataChannelObserver* observer,
+                            const EncodableList& messages,
+                            std::unique_ptr<MethodResultProxy>);
+
+  void DataChannelGetBufferedAmount(FlutterRTCDataChannelObserver* observer,
+                                    std::unique_ptr<MethodResultProxy> result);
+
+  void DataChannelSetSendQueueWatermarks(
+      FlutterRTCDataChannelObserver* observer,
+      const EncodableMap& params,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void DataChannelSendFile(FlutterRTCDataChannelObserver* observer,
+                           const EncodableMap& params,
+                           std::unique_ptr<MethodResultProxy> result);
+
+  void DataChannelWriteToFile(FlutterRTCDataChannelObserver* observer,
+                              const EncodableMap& params,
+                              std::unique_ptr<MethodResultProxy> result);
+
+  void DataChannelSetReceiveBatching(FlutterRTCDataChannelObserver* observer,
+                                     const EncodableMap& params,
+                                     std::unique_ptr<MethodResultProxy> result);
+
+  // Runs FlutterDataChannelBenchmark on |benchmark_thread_|. One benchmark
+  // runs at a time.
+  void DataChannelBenchmark(const EncodableMap& params,
+                            std::unique_ptr<MethodResultProxy> result);
 
   void DataChannelClose(RTCDataChannel* data_channel,
                         const std::string& data_channel_uuid,
                         std::unique_ptr<MethodResultProxy>);
 
-  RTCDataChannel* DataChannelForId(const std::string& id);
+  // Returns a reference taken under the registry lock, like the
+  // FlutterWebRTCBase lookups.
+  scoped_refptr<RTCDataChannel> DataChannelForId(const std::string& id);
+
+  std::shared_ptr<FlutterRTCDataChannelObserver> DataChannelObserverForId(
+      const std::string& id);
 
  private:
   FlutterWebRTCBase* base_;
+  // Drives peer connections from the base's factory, so it is cancelled
+  // and joined before FlutterWebRTCBase terminates libwebrtc.
+  std::thread benchmark_thread_;
+  std::atomic<bool> benchmark_running_{false};
+  std::atomic<bool> benchmark_cancelled_{false};
 };
 
 }  // namespace flutter_webrtc_plus_plugin
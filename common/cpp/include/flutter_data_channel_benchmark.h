@@ -0,0 +1,41 @@
+#ifndef FLUTTER_WEBRTC_DATA_CHANNEL_BENCHMARK_HXX
+#define FLUTTER_WEBRTC_DATA_CHANNEL_BENCHMARK_HXX
+
+#include "flutter_common.h"
+#include "flutter_webrtc_base.h"
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+namespace flutter_webrtc_plus_plugin {
+
+// Measures the plugin's data channel overhead on top of SCTP. Two peer
+// connections are created from the plugin's factory and connected over
+// loopback without any ICE servers, so the run works offline. Messages go
+// through FlutterRTCDataChannelObserver on both ends, but events are counted
+// by an in-process sink instead of being posted to Dart.
+class FlutterDataChannelBenchmark {
+ public:
+  struct Options {
+    std::vector<int> message_sizes;
+    int messages_per_size = 0;
+    // When greater than 1, the receiver batches messages like
+    // dataChannelSetReceiveBatching would.
+    int receive_batch_size = 0;
+    std::chrono::milliseconds timeout{0};
+  };
+
+  // Runs the benchmark and completes |result| with one entry per message
+  // size, or an error if the loopback connection could not be established.
+  // Blocks, so call it from a worker thread; once |cancelled| is set it
+  // stops between steps, closes both ends and leaves |result| alone.
+  static void Run(scoped_refptr<RTCPeerConnectionFactory> factory,
+                  const Options& options,
+                  const std::atomic<bool>& cancelled,
+                  MethodResultProxy* result);
+};
+
+}  // namespace flutter_webrtc_plus_plugin
+
+#endif  // !FLUTTER_WEBRTC_DATA_CHANNEL_BENCHMARK_HXX
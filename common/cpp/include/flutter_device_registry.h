@@ -0,0 +1,108 @@
+#ifndef FLUTTER_WEBRTC_DEVICE_REGISTRY_HXX
+#define FLUTTER_WEBRTC_DEVICE_REGISTRY_HXX
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "rtc_audio_device.h"
+#include "rtc_video_device.h"
+
+#include "repeating_timer.h"
+
+namespace flutter_webrtc_plus_plugin {
+
+using namespace libwebrtc;
+
+// Cached list of the audio and video devices, so getSources, getUserMedia
+// and selectAudioInput/Output don't enumerate every device (tens of ms
+// with PulseAudio or V4L2) on each call.
+//
+// The list is enumerated on first use and marked stale whenever the audio
+// device module reports a change, or, on Linux, when the set of
+// /dev/video* nodes changes. A stale list is re-enumerated on the refresh
+// thread shortly after, and synchronously by the next caller if it gets
+// there first, so device indices are never handed out from a list that is
+// known to be outdated. Where there is no video watcher, the list also
+// expires after a few seconds so new cameras show up.
+//
+// libwebrtc is never called with the registry lock held.
+class DeviceRegistry {
+ public:
+  struct Device {
+    uint32_t index = 0;
+    std::string name;
+    std::string guid;
+  };
+
+  struct Snapshot {
+    std::vector<Device> recording;
+    std::vector<Device> playout;
+    std::vector<Device> video;
+    std::unordered_map<std::string, size_t> recording_by_guid;
+    std::unordered_map<std::string, size_t> playout_by_guid;
+    std::unordered_map<std::string, size_t> video_by_guid;
+    std::chrono::steady_clock::time_point enumerated_at;
+  };
+
+  // |on_changed| runs on the refresh thread once a change has been
+  // enumerated.
+  DeviceRegistry(scoped_refptr<RTCAudioDevice> audio_device,
+                 scoped_refptr<RTCVideoDevice> video_device,
+                 std::function<void()> on_changed);
+  ~DeviceRegistry();
+
+  DeviceRegistry(const DeviceRegistry&) = delete;
+  DeviceRegistry& operator=(const DeviceRegistry&) = delete;
+
+  // The current list, enumerating first if it is missing or stale.
+  std::shared_ptr<const Snapshot> Get();
+
+  // Resolve a deviceId. A miss re-enumerates once before giving up, so a
+  // device plugged in since the last enumeration is still found.
+  bool FindRecording(const std::string& guid, Device* device);
+  bool FindPlayout(const std::string& guid, Device* device);
+  bool FindVideo(const std::string& guid, Device* device);
+
+  // Marks the list stale and schedules a refresh, after which |on_changed|
+  // is called. Safe to call from any thread.
+  void DevicesChanged();
+
+ private:
+  using Index = std::unordered_map<std::string, size_t> Snapshot::*;
+  using List = std::vector<Device> Snapshot::*;
+
+  bool Find(List list, Index index, const std::string& guid, Device* device);
+
+  std::shared_ptr<const Snapshot> Refresh();
+
+  std::shared_ptr<const Snapshot> Enumerate();
+
+#ifdef __linux__
+  // Timer task: compares the /dev/video* nodes against the last poll.
+  bool PollVideoNodes();
+
+  std::vector<std::string> video_nodes_;
+  RepeatingTimer video_watch_timer_;
+#endif
+
+  scoped_refptr<RTCAudioDevice> audio_device_;
+  scoped_refptr<RTCVideoDevice> video_device_;
+  std::function<void()> on_changed_;
+
+  std::mutex mutex_;
+  std::shared_ptr<const Snapshot> snapshot_;
+  // Bumped by DevicesChanged(); the snapshot is stale unless it was
+  // enumerated at the current generation.
+  uint64_t generation_ = 0;
+  uint64_t snapshot_generation_ = 0;
+  RepeatingTimer refresh_timer_;
+};
+
+}  // namespace flutter_webrtc_plus_plugin
+
+#endif  // !FLUTTER_WEBRTC_DEVICE_REGISTRY_HXX
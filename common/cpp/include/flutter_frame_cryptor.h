@@ -30,6 +30,14 @@ class FlutterFrameCryptor {
       std::unique_ptr<MethodResultProxy> result,
       std::unique_ptr<MethodResultProxy>* outResult);
 
+  typedef void (FlutterFrameCryptor::*MethodHandler)(
+      const EncodableMap& constraints,
+      std::unique_ptr<MethodResultProxy> result);
+
+  // The calls HandleFrameCryptorMethodCall answers, keyed by method name.
+  static const std::unordered_map<std::string, MethodHandler>&
+  FrameCryptorMethodHandlers();
+
   void FrameCryptorFactoryCreateFrameCryptor(
       const EncodableMap& constraints,
       std::unique_ptr<MethodResultProxy> result);
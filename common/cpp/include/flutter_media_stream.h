@@ -1,16 +1,37 @@
 #ifndef FLUTTER_WEBRTC_RTC_GET_USERMEDIA_HXX
 #define FLUTTER_WEBRTC_RTC_GET_USERMEDIA_HXX
 
+#include "flutter_camera_capabilities.h"
 #include "flutter_common.h"
+#include "flutter_device_registry.h"
 #include "flutter_webrtc_base.h"
 #include "flutter_virtual_background.h" 
 
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 namespace flutter_webrtc_plus_plugin {
 
 class FlutterMediaStream {
  public:
   FlutterMediaStream(FlutterWebRTCBase* base);
-
+  ~FlutterMediaStream();
+
+  // What GetUserVideo opened, left for the caller to register on the
+  // platform thread, plus how long opening the camera took.
+  struct VideoCapture {
+    std::string track_id;
+    scoped_refptr<RTCVideoCapturer> capturer;
+    std::shared_ptr<FlutterVirtualBackground> processor;
+    double open_ms = 0;
+    double start_capture_ms = 0;
+  };
+
+  // Opens the microphone and the camera concurrently on worker threads and
+  // completes |result| on the platform thread once both are done. The reply
+  // carries per-stage "timings" in milliseconds. Fails, releasing whatever
+  // was opened, if a requested kind of media came back without a track.
   void GetUserMedia(const EncodableMap& constraints,
                     std::unique_ptr<MethodResultProxy> result);
 
@@ -20,7 +41,13 @@ class FlutterMediaStream {
 
   void GetUserVideo(const EncodableMap& constraints,
                     scoped_refptr<RTCMediaStream> stream,
-                    EncodableMap& params);
+                    EncodableMap& params,
+                    VideoCapture* capture);
+
+  // Undoes a getUserMedia that failed part-way: drops the tracks that were
+  // created and stops the camera.
+  void ReleaseUserMedia(scoped_refptr<RTCMediaStream> stream,
+                        const VideoCapture& capture);
 
   void GetSources(std::unique_ptr<MethodResultProxy> result);
 
@@ -64,7 +91,15 @@ class FlutterMediaStream {
 
  private:
   FlutterWebRTCBase* base_;
+  CameraCapabilities camera_capabilities_;
+  std::unique_ptr<DeviceRegistry> devices_;
   std::shared_ptr<FlutterVirtualBackground> virtualBackgroundProcessor_;
+  // GetUserMedia's worker threads by stream id. Platform thread only; a
+  // call's workers are joined when it finishes, the rest on destruction.
+  std::unordered_map<std::string, std::vector<std::thread>> acquisitions_;
+  // Reset on destruction, so a finish task still queued on the platform
+  // thread returns without touching this object.
+  std::shared_ptr<bool> alive_ = std::make_shared<bool>(true);
 };
 
 }  // namespace flutter_webrtc_plus_plugin
@@ -2,8 +2,15 @@
 #define FLUTTER_WEBRTC_RTC_PEER_CONNECTION_HXX
 
 #include "flutter_common.h"
+#include "flutter_peerconnection_pool.h"
+#include "flutter_stats.h"
+#include "flutter_stats_recorder.h"
+#include "flutter_transceiver_state.h"
 #include "flutter_webrtc_base.h"
 
+#include <atomic>
+#include <thread>
+
 namespace flutter_webrtc_plus_plugin {
 
 class FlutterPeerConnectionObserver : public RTCPeerConnectionObserver {
@@ -14,6 +21,7 @@ class FlutterPeerConnectionObserver : public RTCPeerConnectionObserver {
                                 TaskRunner* task_runner,
                                 const std::string& channel_name,
                                 std::string& peerConnectionId);
+  virtual ~FlutterPeerConnectionObserver();
 
   virtual void OnSignalingState(RTCSignalingState state) override;
   virtual void OnPeerConnectionState(RTCPeerConnectionState state) override;
@@ -38,22 +46,87 @@ class FlutterPeerConnectionObserver : public RTCPeerConnectionObserver {
 
   void RemoveStreamForId(const std::string& id);
 
+  // Pushes sampled, derived stats as peerConnectionStats events on this
+  // peer connection's event channel.
+  void StartStatsStream(std::chrono::milliseconds interval,
+                        StatsFieldFilter fields);
+
+  void StopStatsStream();
+
+  // Records stats to a memory-mapped ring file at |path|, replacing any
+  // recording in progress.
+  bool StartStatsRecording(const std::string& path,
+                           std::chrono::milliseconds interval,
+                           uint64_t capacity,
+                           std::string* error);
+
+  // Returns the overhead summary, or an empty map if nothing was recorded.
+  EncodableMap StopStatsRecording();
+
+  TransceiverStateCache* transceiver_states() { return &transceiver_states_; }
+
+  // The configuration this peer connection was created with.
+  const RTCConfiguration& configuration() const { return configuration_; }
+  void set_configuration(const RTCConfiguration& configuration) {
+    configuration_ = configuration;
+  }
+
+  // Coalesces local candidates into onIceCandidates events sent at most
+  // |max_delay| after the first pending one, and when gathering completes.
+  // A zero delay restores one onCandidate event per candidate.
+  void SetIceCandidateBatching(std::chrono::milliseconds max_delay);
+
+ private:
+  void AddRemoteTrack(scoped_refptr<RTCMediaTrack> track);
+
+  void RemoveRemoteTrack(const std::string& id);
+
+  // Sends the pending candidates, in gathering order. Requires
+  // candidate_mutex_.
+  void FlushIceCandidates();
+
  private:
   std::unique_ptr<EventChannelProxy> event_channel_;
   scoped_refptr<RTCPeerConnection> peerconnection_;
   std::map<std::string, scoped_refptr<RTCMediaStream>> remote_streams_;
+  std::unordered_map<std::string, scoped_refptr<RTCMediaTrack>> remote_tracks_;
+  // Guards remote_streams_ and remote_tracks_, which are filled from the
+  // signaling thread and read from the platform thread.
+  std::mutex remote_mutex_;
   FlutterWebRTCBase* base_;
   std::string id_;
+  RTCConfiguration configuration_;
+  std::mutex candidate_mutex_;
+  std::chrono::milliseconds candidate_batch_delay_{0};
+  EncodableList pending_candidates_;
+  RepeatingTimer candidate_timer_;
+  // Declared after event_channel_ so it stops before the channel goes away.
+  std::unique_ptr<StatsSampler> stats_sampler_;
+  std::unique_ptr<StatsRecorder> stats_recorder_;
+  TransceiverStateCache transceiver_states_;
 };
 
 class FlutterPeerConnection {
  public:
   FlutterPeerConnection(FlutterWebRTCBase* base) : base_(base) {}
+  ~FlutterPeerConnection();
 
   void CreateRTCPeerConnection(const EncodableMap& configuration,
                                const EncodableMap& constraints,
                                std::unique_ptr<MethodResultProxy> result);
 
+  // Keeps |size| warm connections for the given configuration and
+  // constraints; createPeerConnection with the same maps takes one of them.
+  void ConfigurePeerConnectionPool(const EncodableMap& params,
+                                   std::unique_ptr<MethodResultProxy> result);
+
+  void PeerConnectionPoolStats(std::unique_ptr<MethodResultProxy> result);
+
+  // Compares cold creation with taking from a filled pool, on
+  // |benchmark_thread_|. One benchmark runs at a time.
+  void PeerConnectionPoolBenchmark(const EncodableMap& params,
+                                   std::unique_ptr<MethodResultProxy> result);
+
   void RTCPeerConnectionClose(RTCPeerConnection* pc,
                               const std::string& uuid,
                               std::unique_ptr<MethodResultProxy> result);
@@ -102,6 +175,13 @@ class FlutterPeerConnection {
   void GetTransceivers(RTCPeerConnection* pc,
                        std::unique_ptr<MethodResultProxy> result);
 
+  // Replies with the transceiver fields that changed after |since_version|;
+  // see TransceiverStateCache::Update.
+  void GetTransceiverChanges(RTCPeerConnection* pc,
+                             FlutterPeerConnectionObserver* observer,
+                             int64_t since_version,
+                             std::unique_ptr<MethodResultProxy> result);
+
   void GetReceivers(RTCPeerConnection* pc,
                     std::unique_ptr<MethodResultProxy> result);
 
@@ -121,7 +201,7 @@ class FlutterPeerConnection {
                              std::unique_ptr<MethodResultProxy> result);
 
   scoped_refptr<RTCRtpParameters> updateRtpParameters(
-      EncodableMap newParameters,
+      const EncodableMap& newParameters,
       scoped_refptr<RTCRtpParameters> parameters);
 
   void RtpSenderSetParameters(RTCPeerConnection* pc,
@@ -138,8 +218,15 @@ class FlutterPeerConnection {
       std::string transceiverId,
       std::unique_ptr<MethodResultProxy> result);
 
+  // Diffs |configuration| against the one |pc| was created with and replies
+  // with {"applied": [...], "unsupported": [...]} naming the changed fields.
+  // The libwebrtc wrapper has no SetConfiguration, so changed fields can
+  // only be reported; |ice_restart| restarts ICE in place, which is
+  // reported as applied.
   void SetConfiguration(RTCPeerConnection* pc,
+                        FlutterPeerConnectionObserver* observer,
                         const EncodableMap& configuration,
+                        bool ice_restart,
                         std::unique_ptr<MethodResultProxy> result);
 
   void CaptureFrame(RTCVideoTrack* track,
@@ -157,7 +244,7 @@ class FlutterPeerConnection {
   void RtpTransceiverSetCodecPreferences(
       RTCPeerConnection* pc,
       std::string transceiverId,
-      const EncodableList codecs,
+      const EncodableList& codecs,
       std::unique_ptr<MethodResultProxy> result);
 
   void GetSenders(RTCPeerConnection* pc,
@@ -167,10 +254,44 @@ class FlutterPeerConnection {
                        RTCPeerConnection* pc,
                        std::unique_ptr<MethodResultProxy> result);
 
+  // Adds |candidates| in order and replies with {"added": n, "failed":
+  // [index, ...]} for the ones that could not be parsed.
+  void AddIceCandidates(const EncodableList& candidates,
+                        RTCPeerConnection* pc,
+                        std::unique_ptr<MethodResultProxy> result);
+
+  void SetIceCandidateBatching(FlutterPeerConnectionObserver* observer,
+                               const EncodableMap& params,
+                               std::unique_ptr<MethodResultProxy> result);
+
   void GetStats(const std::string& track_id,
+                const StatsQuery& query,
                 RTCPeerConnection* pc,
                 std::unique_ptr<MethodResultProxy> result);
 
+  // Runs GetStats on every peer connection in parallel and replies once with
+  // {"peerConnections": {id: reply}, "errors": {id: message}}, where each
+  // reply is shaped by |query| like a single getStats reply.
+  void GetStatsForAll(const StatsQuery& query,
+                      std::unique_ptr<MethodResultProxy> result);
+
+  void StartStatsStream(FlutterPeerConnectionObserver* observer,
+                        const EncodableMap& params,
+                        std::unique_ptr<MethodResultProxy> result);
+
+  void StopStatsStream(FlutterPeerConnectionObserver* observer,
+                       std::unique_ptr<MethodResultProxy> result);
+
+  void StartStatsRecording(FlutterPeerConnectionObserver* observer,
+                           const EncodableMap& params,
+                           std::unique_ptr<MethodResultProxy> result);
+
+  void StopStatsRecording(FlutterPeerConnectionObserver* observer,
+                          std::unique_ptr<MethodResultProxy> result);
+
+  void ExportStatsRecording(const EncodableMap& params,
+                            std::unique_ptr<MethodResultProxy> result);
+
   void MediaStreamAddTrack(scoped_refptr<RTCMediaStream> stream,
                            scoped_refptr<RTCMediaTrack> track,
                            std::unique_ptr<MethodResultProxy> result);
@@ -189,7 +310,15 @@ class FlutterPeerConnection {
                    std::unique_ptr<MethodResultProxy> result);
 
  private:
+  PeerConnectionPool::Factory PoolFactory();
+
   FlutterWebRTCBase* base_;
+  // The pool's refill thread and the benchmark thread both reach |base_|
+  // through PoolFactory(); both are joined before FlutterWebRTCBase goes.
+  std::unique_ptr<PeerConnectionPool> pool_;
+  std::thread benchmark_thread_;
+  std::atomic<bool> benchmark_running_{false};
+  std::atomic<bool> benchmark_cancelled_{false};
 };
 
 std::string RTCMediaTypeToString(RTCMediaType type);
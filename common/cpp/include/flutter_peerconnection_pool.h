@@ -0,0 +1,104 @@
+#ifndef FLUTTER_WEBRTC_PEER_CONNECTION_POOL_HXX
+#define FLUTTER_WEBRTC_PEER_CONNECTION_POOL_HXX
+
+#include "flutter_common.h"
+#include "flutter_webrtc_base.h"
+#include "repeating_timer.h"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <map>
+
+namespace flutter_webrtc_plus_plugin {
+
+// Pre-created peer connections, so createPeerConnection can skip
+// factory->Create and start with candidates already gathered through
+// iceCandidatePoolSize.
+//
+// Connections are pooled per (configuration, constraints) pair; the key is
+// a canonical encoding of both maps, so only a createPeerConnection call
+// with an identical configuration gets a warm connection. Taken connections
+// are replaced in the background.
+class PeerConnectionPool {
+ public:
+  struct Warm {
+    scoped_refptr<RTCPeerConnection> pc;
+    RTCConfiguration configuration;
+    EncodableList dropped_ice_servers;
+  };
+
+  // Creates one connection; called from the refill and benchmark threads.
+  // |pool_size| is the iceCandidatePoolSize to use when |configuration| has
+  // none, or -1.
+  using Factory = std::function<Warm(const EncodableMap& configuration,
+                                     const EncodableMap& constraints,
+                                     int pool_size)>;
+
+  explicit PeerConnectionPool(Factory factory);
+  ~PeerConnectionPool();
+
+  // Keeps |size| warm connections for this configuration. A size of 0
+  // stops pooling it and closes its idle connections.
+  void Configure(const EncodableMap& configuration,
+                 const EncodableMap& constraints,
+                 int size,
+                 int ice_candidate_pool_size);
+
+  // Hands out a warm connection for this configuration, if there is one.
+  bool Take(const EncodableMap& configuration,
+            const EncodableMap& constraints,
+            Warm* warm);
+
+  // Idle and target sizes, hits, misses and the average time it took to
+  // create the pooled connections.
+  EncodableMap Stats();
+
+  // Closes every idle connection and forgets all configurations.
+  void Clear();
+
+  // Times |iterations| cold creations against takes from a filled pool and
+  // completes |result| with the latencies. Both arms time the same thing:
+  // from asking for a connection until ICE gathering completes for an
+  // offer with one data channel, so pre-gathered candidates count for as
+  // much as the skipped factory->Create. Blocks, so call it from a worker
+  // thread; once |cancelled| is set it stops between steps and leaves
+  // |result| alone.
+  static void Benchmark(const Factory& factory,
+                        const EncodableMap& configuration,
+                        const EncodableMap& constraints,
+                        int iterations,
+                        int ice_candidate_pool_size,
+                        const std::atomic<bool>& cancelled,
+                        MethodResultProxy* result);
+
+ private:
+  struct Entry {
+    EncodableMap configuration;
+    EncodableMap constraints;
+    int ice_candidate_pool_size = -1;
+    int size = 0;
+    std::deque<Warm> idle;
+    int64_t hits = 0;
+    int64_t misses = 0;
+  };
+
+  static std::string KeyFor(const EncodableMap& configuration,
+                            const EncodableMap& constraints);
+
+  // Timer task: tops every entry up to its size, one connection at a time.
+  bool Refill();
+
+  void ScheduleRefill();
+
+  Factory factory_;
+  std::mutex mutex_;
+  std::map<std::string, Entry> entries_;
+  int64_t created_ = 0;
+  int64_t total_create_us_ = 0;
+  RepeatingTimer refill_timer_;
+};
+
+}  // namespace flutter_webrtc_plus_plugin
+
+#endif  // !FLUTTER_WEBRTC_PEER_CONNECTION_POOL_HXX
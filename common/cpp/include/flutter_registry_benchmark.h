@@ -0,0 +1,41 @@
+#ifndef FLUTTER_WEBRTC_REGISTRY_BENCHMARK_HXX
+#define FLUTTER_WEBRTC_REGISTRY_BENCHMARK_HXX
+
+#include "flutter_common.h"
+#include "flutter_webrtc_base.h"
+
+#include <chrono>
+
+namespace flutter_webrtc_plus_plugin {
+
+// In-process checks of the FlutterWebRTCBase registries. Every entry they
+// add is keyed by ids of their own and removed again before they return,
+// so they can run next to live peer connections.
+class FlutterRegistryBenchmark {
+ public:
+  // Adds and removes local and remote tracks on |writers| threads, the way
+  // signaling callbacks do, while |readers| threads look them up and use
+  // what they get back, the way method channel handlers do. Runs for
+  // |duration| and returns the operation counts. Meant for builds with
+  // -fsanitize=thread, which report any registry access the locks miss.
+  static EncodableMap Stress(FlutterWebRTCBase* base,
+                             scoped_refptr<RTCPeerConnectionFactory> factory,
+                             int writers,
+                             int readers,
+                             std::chrono::milliseconds duration);
+
+  // Registers |tracks| remote tracks spread over peer connections of
+  // |tracks_per_peer| each, like a large mesh call, then times |rounds|
+  // passes of MediaTracksForId over every id, and over as many unknown
+  // ids. Returns nanoseconds per lookup for hits and misses.
+  static EncodableMap RemoteTrackLookup(
+      FlutterWebRTCBase* base,
+      scoped_refptr<RTCPeerConnectionFactory> factory,
+      int tracks,
+      int tracks_per_peer,
+      int rounds);
+};
+
+}  // namespace flutter_webrtc_plus_plugin
+
+#endif  // !FLUTTER_WEBRTC_REGISTRY_BENCHMARK_HXX
@@ -0,0 +1,103 @@
+#ifndef FLUTTER_WEBRTC_RTP_INDEX_HXX
+#define FLUTTER_WEBRTC_RTP_INDEX_HXX
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "rtc_peerconnection.h"
+
+namespace flutter_webrtc_plus_plugin {
+
+using namespace libwebrtc;
+
+// Id lookups for the senders, receivers and transceivers of one peer
+// connection, so method calls don't walk (and copy) pc->senders() and friends
+// comparing id strings.
+//
+// The index is filled incrementally as objects show up (AddTrack,
+// AddTransceiver, OnTrack, ...). libwebrtc also creates and retires objects
+// without telling us, e.g. transceivers made by SetRemoteDescription or
+// senders whose track was replaced, so every hit is checked against the live
+// object and a stale hit or a miss rebuilds the index from the peer
+// connection once before giving up. After a rebuild the index is complete,
+// so further misses are answered without walking the peer connection again
+// until the next Add*() or Clear().
+//
+// libwebrtc is never called with the index lock held.
+class RtpObjectIndex {
+ public:
+  scoped_refptr<RTCRtpSender> SenderForId(RTCPeerConnection* pc,
+                                          const std::string& id);
+  scoped_refptr<RTCRtpReceiver> ReceiverForId(RTCPeerConnection* pc,
+                                              const std::string& id);
+  scoped_refptr<RTCRtpTransceiver> TransceiverForId(RTCPeerConnection* pc,
+                                                    const std::string& id);
+  scoped_refptr<RTCRtpSender> SenderForTrackId(RTCPeerConnection* pc,
+                                               const std::string& track_id);
+  scoped_refptr<RTCRtpReceiver> ReceiverForTrackId(
+      RTCPeerConnection* pc,
+      const std::string& track_id);
+
+  // The receiver, or failing that the sender, whose track is |track_id|.
+  // Checks both before rebuilding, so a local track id costs one rebuild
+  // at most instead of one per map. Returns false if neither has it.
+  bool TrackForId(RTCPeerConnection* pc,
+                  const std::string& track_id,
+                  scoped_refptr<RTCRtpReceiver>* receiver,
+                  scoped_refptr<RTCRtpSender>* sender);
+
+  void AddSender(scoped_refptr<RTCRtpSender> sender);
+  void AddReceiver(scoped_refptr<RTCRtpReceiver> receiver);
+  // Also indexes the transceiver's sender and receiver.
+  void AddTransceiver(scoped_refptr<RTCRtpTransceiver> transceiver);
+
+  // Drops everything; the next lookup rebuilds from the peer connection.
+  // Called on every signaling state change and after each successful
+  // Set{Local,Remote}Description, since both can create transceivers that
+  // never reach Add*() and retire stopped ones.
+  void Clear();
+
+ private:
+  template <typename T>
+  using Map = std::unordered_map<std::string, scoped_refptr<T>>;
+
+  struct Entries {
+    Map<RTCRtpSender> senders;
+    Map<RTCRtpReceiver> receivers;
+    Map<RTCRtpTransceiver> transceivers;
+    Map<RTCRtpSender> senders_by_track;
+    Map<RTCRtpReceiver> receivers_by_track;
+  };
+
+  // Also reports whether the index was complete when |key| was looked up.
+  template <typename T>
+  scoped_refptr<T> Find(Map<T> Entries::*map,
+                        const std::string& key,
+                        bool* complete);
+
+  // Looks |key| up in |map|, checking a hit with |matches| and rebuilding
+  // the index from |pc| on a stale hit, or on a miss unless it is complete.
+  template <typename T, typename Matches>
+  scoped_refptr<T> Lookup(RTCPeerConnection* pc,
+                          Map<T> Entries::*map,
+                          const std::string& key,
+                          Matches matches);
+
+  void Rebuild(RTCPeerConnection* pc);
+
+  static void IndexSender(Entries* entries, scoped_refptr<RTCRtpSender> sender);
+  static void IndexReceiver(Entries* entries,
+                            scoped_refptr<RTCRtpReceiver> receiver);
+
+  std::mutex mutex_;
+  Entries entries_;
+  // Set by Rebuild() if nothing was added while it walked the peer
+  // connection; Add*() and Clear() reset it.
+  bool complete_ = false;
+  uint64_t generation_ = 0;
+};
+
+}  // namespace flutter_webrtc_plus_plugin
+
+#endif  // !FLUTTER_WEBRTC_RTP_INDEX_HXX
@@ -0,0 +1,77 @@
+#ifndef FLUTTER_WEBRTC_STATS_HXX
+#define FLUTTER_WEBRTC_STATS_HXX
+
+#include "flutter_common.h"
+#include "flutter_webrtc_base.h"
+#include "repeating_timer.h"
+
+#include <unordered_set>
+
+namespace flutter_webrtc_plus_plugin {
+
+// Report type -> member names to keep. An empty member set keeps every
+// member of that report type.
+using StatsFieldFilter =
+    std::unordered_map<std::string, std::unordered_set<std::string>>;
+
+// Builds a filter from a list of "type.member" or "type" strings, e.g.
+// ["inbound-rtp.bytesReceived", "candidate-pair"].
+StatsFieldFilter ParseStatsFields(const EncodableList& fields);
+
+// How getStats should shape its reply.
+struct StatsQuery {
+  // Empty keeps every report and member.
+  StatsFieldFilter fields;
+  // Reply with one table per report type: field names once, then a packed
+  // column per field, instead of one map per report.
+  bool columnar = false;
+};
+
+// Reads the optional "fields" and "format" getStats arguments.
+StatsQuery ParseStatsQuery(const EncodableMap& params);
+
+// Converts one report to the {id, type, timestamp, values} map getStats has
+// always returned, keeping only the members in |filter| when it is non-empty.
+EncodableMap statsToMap(const scoped_refptr<MediaRTCStats>& stats,
+                        const std::unordered_set<std::string>* filter =
+                            nullptr);
+
+// Builds the getStats reply for |reports|: {"stats": [...]} in row format,
+// or {"tables": [...]} when |query| asks for columnar output.
+EncodableMap EncodeStatsReports(
+    const vector<scoped_refptr<MediaRTCStats>>& reports,
+    const StatsQuery& query);
+
+// Samples RTCPeerConnection::GetStats on a timer and emits one
+// peerConnectionStats event per interval with only the filtered members and
+// metrics derived natively from consecutive samples: per-second rates of
+// counters, bitrate, packet loss over the interval, jitter and jitter buffer
+// delay in milliseconds.
+class StatsSampler {
+ public:
+  // |event_channel| must outlive the sampler.
+  StatsSampler(scoped_refptr<RTCPeerConnection> peerconnection,
+               EventChannelProxy* event_channel);
+  ~StatsSampler();
+
+  // Starts sampling, or restarts with a new interval and filter. An empty
+  // |fields| filter selects the members most dashboards need.
+  void Start(std::chrono::milliseconds interval, StatsFieldFilter fields);
+
+  void Stop();
+
+ private:
+  struct State;
+
+  // Timer task: requests a new sample unless the previous one is still in
+  // flight.
+  bool Sample();
+
+  scoped_refptr<RTCPeerConnection> peerconnection_;
+  std::shared_ptr<State> state_;
+  RepeatingTimer timer_;
+};
+
+}  // namespace flutter_webrtc_plus_plugin
+
+#endif  // !FLUTTER_WEBRTC_STATS_HXX
@@ -0,0 +1,107 @@
+#ifndef FLUTTER_WEBRTC_STATS_RECORDER_HXX
+#define FLUTTER_WEBRTC_STATS_RECORDER_HXX
+
+#include "flutter_common.h"
+#include "flutter_webrtc_base.h"
+#include "repeating_timer.h"
+
+#include <cstdint>
+
+namespace flutter_webrtc_plus_plugin {
+
+// On-disk layout of a stats recording. All values are little endian; the
+// file is a header followed by |capacity| fixed-size records used as a ring.
+constexpr char kStatsRecordingMagic[8] = {'F', 'W', 'R', 'S',
+                                          'T', 'A', 'T', 'S'};
+constexpr uint32_t kStatsRecordingVersion = 1;
+constexpr uint32_t kStatsRecordingHeaderSize = 64;
+
+struct StatsRecordingHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t header_size;
+  uint32_t record_size;
+  uint32_t interval_ms;
+  uint64_t capacity;
+  // Total records ever written; the next one goes to
+  // records_written % capacity.
+  uint64_t records_written;
+};
+
+enum StatsRecordKind : uint8_t {
+  kStatsRecordInboundAudio = 1,
+  kStatsRecordInboundVideo,
+  kStatsRecordOutboundAudio,
+  kStatsRecordOutboundVideo,
+  kStatsRecordRemoteInboundAudio,
+  kStatsRecordRemoteInboundVideo,
+  kStatsRecordCandidatePair,
+};
+
+// Columns of every record. Fields a report kind does not have are NaN.
+enum StatsRecordField {
+  kStatsFieldBytes,
+  kStatsFieldPackets,
+  kStatsFieldPacketsLost,
+  kStatsFieldJitter,
+  kStatsFieldRoundTripTime,
+  kStatsFieldFramesPerSecond,
+  kStatsFieldFrames,
+  kStatsFieldFrameWidth,
+  kStatsFieldFrameHeight,
+  kStatsFieldNackCount,
+  kStatsFieldAvailableOutgoingBitrate,
+  kStatsFieldJitterBufferDelay,
+  kStatsFieldCount,
+};
+
+struct StatsRecord {
+  int64_t timestamp_us;
+  uint32_t ssrc;
+  uint8_t kind;
+  uint8_t reserved[3];
+  double values[kStatsFieldCount];
+};
+
+static_assert(sizeof(StatsRecordingHeader) <= kStatsRecordingHeaderSize,
+              "stats recording header does not fit");
+static_assert(sizeof(StatsRecord) == 112, "stats record layout changed");
+
+// Converts a recording to CSV, oldest record first. Does not depend on the
+// plugin, so it can also be built into a standalone tool.
+bool StatsRecordingToCsv(const std::string& recording_path,
+                         const std::string& csv_path,
+                         std::string* error);
+
+// Samples GetStats on a timer and appends fixed-schema records for RTP
+// streams and nominated candidate pairs to a memory-mapped ring file, so
+// high-resolution history never crosses the method channel.
+class StatsRecorder {
+ public:
+  explicit StatsRecorder(scoped_refptr<RTCPeerConnection> peerconnection);
+  ~StatsRecorder();
+
+  bool Start(const std::string& path,
+             std::chrono::milliseconds interval,
+             uint64_t capacity,
+             std::string* error);
+
+  // Stops recording, flushes the file and returns the recording overhead:
+  // records, samples, skippedSamples, averageWriteUs and maxWriteUs.
+  EncodableMap Stop();
+
+  bool IsRecording() const;
+
+ private:
+  struct State;
+
+  bool Sample();
+
+  scoped_refptr<RTCPeerConnection> peerconnection_;
+  std::shared_ptr<State> state_;
+  RepeatingTimer timer_;
+};
+
+}  // namespace flutter_webrtc_plus_plugin
+
+#endif  // !FLUTTER_WEBRTC_STATS_RECORDER_HXX
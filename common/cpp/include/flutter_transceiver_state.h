@@ -0,0 +1,58 @@
+#ifndef FLUTTER_WEBRTC_TRANSCEIVER_STATE_HXX
+#define FLUTTER_WEBRTC_TRANSCEIVER_STATE_HXX
+
+#include "flutter_common.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace flutter_webrtc_plus_plugin {
+
+// Versioned copy of the transceiver maps last reported for one peer
+// connection, so getTransceivers can send only what changed.
+//
+// Every field of a transceiver map, and every field of its nested "sender"
+// and "receiver" maps, remembers the version at which it last changed. A
+// caller that has applied everything up to version N asks for changes since
+// N and gets back only the newer fields, plus the ids of transceivers that
+// went away.
+class TransceiverStateCache {
+ public:
+  // |current| holds (transceiverId, transceiverToMap()) for every live
+  // transceiver. Records what changed, then returns
+  //   {"version": v, "full": bool,
+  //    "transceivers": [{"transceiverId": id, <changed fields>}, ...],
+  //    "removed": [id, ...]}.
+  // Nested "sender"/"receiver" maps only carry their changed fields and
+  // their senderId/receiverId. The reply is "full" (every field, nothing
+  // removed) when |since_version| is negative or not a version this cache
+  // handed out.
+  EncodableMap Update(
+      const std::vector<std::pair<std::string, EncodableMap>>& current,
+      int64_t since_version);
+
+ private:
+  // (section, name): section is "" for top-level fields, or "sender" /
+  // "receiver" for fields of the nested maps.
+  using FieldKey = std::pair<std::string, std::string>;
+
+  struct Field {
+    EncodableValue value;
+    int64_t version;
+  };
+
+  struct Entry {
+    std::map<FieldKey, Field> fields;
+  };
+
+  std::mutex mutex_;
+  int64_t version_ = 0;
+  std::map<std::string, Entry> entries_;
+  // Transceiver id -> version at which it was removed.
+  std::map<std::string, int64_t> removed_;
+};
+
+}  // namespace flutter_webrtc_plus_plugin
+
+#endif  // !FLUTTER_WEBRTC_TRANSCEIVER_STATE_HXX
@@ -3,10 +3,12 @@
 
 #include "flutter_common.h"
 
+#include "flutter_codec_benchmark.h"
 #include "flutter_data_channel.h"
 #include "flutter_frame_cryptor.h"
 #include "flutter_media_stream.h"
 #include "flutter_peerconnection.h"
+#include "flutter_registry_benchmark.h"
 #include "flutter_screen_capture.h"
 #include "flutter_video_renderer.h"
 
@@ -38,6 +40,307 @@ class FlutterWebRTC : public FlutterWebRTCBase,
 
   void HandleMethodCall(const MethodCallProxy& method_call,
                         std::unique_ptr<MethodResultProxy> result);
+
+ private:
+  typedef void (FlutterWebRTC::*MethodHandler)(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  // The calls HandleMethodCall answers itself, keyed by method name.
+  static const std::unordered_map<std::string, MethodHandler>&
+  MethodHandlers();
+
+  // One handler per method channel call; each decodes its own arguments.
+  void HandleInitialize(const MethodCallProxy& method_call,
+                        std::unique_ptr<MethodResultProxy> result);
+
+  void HandleCreatePeerConnection(const MethodCallProxy& method_call,
+                                  std::unique_ptr<MethodResultProxy> result);
+
+  void HandleConfigurePeerConnectionPool(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandlePeerConnectionPoolStats(const MethodCallProxy& method_call,
+                                     std::unique_ptr<MethodResultProxy> result);
+
+  void HandlePeerConnectionPoolBenchmark(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRegistryStressTest(const MethodCallProxy& method_call,
+                                std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRemoteTrackLookupBenchmark(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleMethodDispatchBenchmark(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleCodecBenchmark(const MethodCallProxy& method_call,
+                            std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetUserMedia(const MethodCallProxy& method_call,
+                          std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetDisplayMedia(const MethodCallProxy& method_call,
+                             std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetDesktopSources(const MethodCallProxy& method_call,
+                               std::unique_ptr<MethodResultProxy> result);
+
+  void HandleUpdateDesktopSources(const MethodCallProxy& method_call,
+                                  std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetDesktopSourceThumbnail(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetSources(const MethodCallProxy& method_call,
+                        std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSelectAudioInput(const MethodCallProxy& method_call,
+                              std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSelectAudioOutput(const MethodCallProxy& method_call,
+                               std::unique_ptr<MethodResultProxy> result);
+
+  void HandleMediaStreamGetTracks(const MethodCallProxy& method_call,
+                                  std::unique_ptr<MethodResultProxy> result);
+
+  void HandleCreateOffer(const MethodCallProxy& method_call,
+                         std::unique_ptr<MethodResultProxy> result);
+
+  void HandleCreateAnswer(const MethodCallProxy& method_call,
+                          std::unique_ptr<MethodResultProxy> result);
+
+  void HandleAddStream(const MethodCallProxy& method_call,
+                       std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRemoveStream(const MethodCallProxy& method_call,
+                          std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSetLocalDescription(const MethodCallProxy& method_call,
+                                 std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSetRemoteDescription(const MethodCallProxy& method_call,
+                                  std::unique_ptr<MethodResultProxy> result);
+
+  void HandleAddCandidate(const MethodCallProxy& method_call,
+                          std::unique_ptr<MethodResultProxy> result);
+
+  void HandleAddCandidates(const MethodCallProxy& method_call,
+                           std::unique_ptr<MethodResultProxy> result);
+
+  void HandlePeerConnectionSetIceCandidateBatching(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetStats(const MethodCallProxy& method_call,
+                      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetStatsForAll(const MethodCallProxy& method_call,
+                            std::unique_ptr<MethodResultProxy> result);
+
+  void HandlePeerConnectionStartStatsStream(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandlePeerConnectionStopStatsStream(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandlePeerConnectionStartStatsRecording(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandlePeerConnectionStopStatsRecording(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleExportStatsRecording(const MethodCallProxy& method_call,
+                                  std::unique_ptr<MethodResultProxy> result);
+
+  void HandleCreateDataChannel(const MethodCallProxy& method_call,
+                               std::unique_ptr<MethodResultProxy> result);
+
+  void HandleDataChannelSend(const MethodCallProxy& method_call,
+                             std::unique_ptr<MethodResultProxy> result);
+
+  void HandleDataChannelSendBatch(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleDataChannelGetBufferedAmount(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleDataChannelSetSendQueueWatermarks(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleDataChannelSendFile(const MethodCallProxy& method_call,
+                                 std::unique_ptr<MethodResultProxy> result);
+
+  void HandleDataChannelWriteToFile(const MethodCallProxy& method_call,
+                                    std::unique_ptr<MethodResultProxy> result);
+
+  void HandleDataChannelSetReceiveBatching(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleDataChannelBenchmark(const MethodCallProxy& method_call,
+                                  std::unique_ptr<MethodResultProxy> result);
+
+  void HandleDataChannelClose(const MethodCallProxy& method_call,
+                              std::unique_ptr<MethodResultProxy> result);
+
+  void HandleStreamDispose(const MethodCallProxy& method_call,
+                           std::unique_ptr<MethodResultProxy> result);
+
+  void HandleMediaStreamTrackSetEnable(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleTrackDispose(const MethodCallProxy& method_call,
+                          std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRestartIce(const MethodCallProxy& method_call,
+                        std::unique_ptr<MethodResultProxy> result);
+
+  void HandlePeerConnectionClose(const MethodCallProxy& method_call,
+                                 std::unique_ptr<MethodResultProxy> result);
+
+  void HandlePeerConnectionDispose(const MethodCallProxy& method_call,
+                                   std::unique_ptr<MethodResultProxy> result);
+
+  void HandleCreateVideoRenderer(const MethodCallProxy& method_call,
+                                 std::unique_ptr<MethodResultProxy> result);
+
+  void HandleVideoRendererDispose(const MethodCallProxy& method_call,
+                                  std::unique_ptr<MethodResultProxy> result);
+
+  void HandleVideoRendererSetSrcObject(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleMediaStreamTrackSwitchCamera(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSetVolume(const MethodCallProxy& method_call,
+                       std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetLocalDescription(const MethodCallProxy& method_call,
+                                 std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetRemoteDescription(const MethodCallProxy& method_call,
+                                  std::unique_ptr<MethodResultProxy> result);
+
+  void HandleMediaStreamAddTrack(const MethodCallProxy& method_call,
+                                 std::unique_ptr<MethodResultProxy> result);
+
+  void HandleMediaStreamRemoveTrack(const MethodCallProxy& method_call,
+                                    std::unique_ptr<MethodResultProxy> result);
+
+  void HandleAddTrack(const MethodCallProxy& method_call,
+                      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRemoveTrack(const MethodCallProxy& method_call,
+                         std::unique_ptr<MethodResultProxy> result);
+
+  void HandleAddTransceiver(const MethodCallProxy& method_call,
+                            std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetTransceivers(const MethodCallProxy& method_call,
+                             std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetReceivers(const MethodCallProxy& method_call,
+                          std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetSenders(const MethodCallProxy& method_call,
+                        std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRtpSenderSetTrack(const MethodCallProxy& method_call,
+                               std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRtpSenderSetStreams(const MethodCallProxy& method_call,
+                                 std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRtpSenderReplaceTrack(const MethodCallProxy& method_call,
+                                   std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRtpSenderSetParameters(const MethodCallProxy& method_call,
+                                    std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRtpTransceiverStop(const MethodCallProxy& method_call,
+                                std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRtpTransceiverGetCurrentDirection(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleRtpTransceiverSetDirection(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSetConfiguration(const MethodCallProxy& method_call,
+                              std::unique_ptr<MethodResultProxy> result);
+
+  void HandleCaptureFrame(const MethodCallProxy& method_call,
+                          std::unique_ptr<MethodResultProxy> result);
+
+  void HandleCreateLocalMediaStream(const MethodCallProxy& method_call,
+                                    std::unique_ptr<MethodResultProxy> result);
+
+  void HandleCanInsertDtmf(const MethodCallProxy& method_call,
+                           std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSendDtmf(const MethodCallProxy& method_call,
+                      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetRtpSenderCapabilities(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetRtpReceiverCapabilities(
+      const MethodCallProxy& method_call,
+      std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSetCodecPreferences(const MethodCallProxy& method_call,
+                                 std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetSignalingState(const MethodCallProxy& method_call,
+                               std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetIceGatheringState(const MethodCallProxy& method_call,
+                                  std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetIceConnectionState(const MethodCallProxy& method_call,
+                                   std::unique_ptr<MethodResultProxy> result);
+
+  void HandleGetConnectionState(const MethodCallProxy& method_call,
+                                std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSetThinValue(const MethodCallProxy& method_call,
+                          std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSetBigEyeValue(const MethodCallProxy& method_call,
+                            std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSetSmoothValue(const MethodCallProxy& method_call,
+                            std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSetLipstickValue(const MethodCallProxy& method_call,
+                              std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSetBlusherValue(const MethodCallProxy& method_call,
+                             std::unique_ptr<MethodResultProxy> result);
+
+  void HandleSetWhiteValue(const MethodCallProxy& method_call,
+                           std::unique_ptr<MethodResultProxy> result);
 };
 
 }  // namespace flutter_webrtc_plus_plugin
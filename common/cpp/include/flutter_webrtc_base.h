@@ -2,12 +2,15 @@
 #define FLUTTER_WEBRTC_BASE_HXX
 
 #include "flutter_common.h"
+#include "flutter_rtp_index.h"
 
 #include <string.h>
 #include <list>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 
 #include "libwebrtc.h"
 
@@ -48,15 +51,15 @@ class FlutterWebRTCBase {
 
   std::string GenerateUUID();
 
-  RTCPeerConnection* PeerConnectionForId(const std::string& id);
+  // The lookups return references taken under the registry lock, so the
+  // object stays alive for the caller even if it is removed meanwhile.
+  scoped_refptr<RTCPeerConnection> PeerConnectionForId(const std::string& id);
 
   void RemovePeerConnectionForId(const std::string& id);
 
-  RTCMediaTrack* MediaTrackForId(const std::string& id);
-
   void RemoveMediaTrackForId(const std::string& id);
 
-  FlutterPeerConnectionObserver* PeerConnectionObserversForId(
+  std::shared_ptr<FlutterPeerConnectionObserver> PeerConnectionObserversForId(
       const std::string& id);
 
   void RemovePeerConnectionObserversForId(const std::string& id);
@@ -73,15 +76,31 @@ class FlutterWebRTCBase {
   scoped_refptr<RTCMediaConstraints> ParseMediaConstraints(
       const EncodableMap& constraints);
 
+  // Fills |configuration| from |map|. ICE server URLs that don't fit in
+  // RTCConfiguration::ice_servers are appended to |dropped_ice_servers|.
   bool ParseRTCConfiguration(const EncodableMap& map,
-                             RTCConfiguration& configuration);
+                             RTCConfiguration& configuration,
+                             EncodableList* dropped_ice_servers = nullptr);
 
   scoped_refptr<RTCMediaTrack> MediaTracksForId(const std::string& id);
 
   void RemoveTracksForId(const std::string& id);
 
+  void AddLocalTrack(scoped_refptr<RTCMediaTrack> track);
+
+  void AddRemoteTrack(const std::string& peerconnection_id,
+                      scoped_refptr<RTCMediaTrack> track);
+
+  // Only drops the entry of |peerconnection_id|, so a connection going
+  // away doesn't take another connection's track with the same id along.
+  void RemoveRemoteTrack(const std::string& peerconnection_id,
+                         const std::string& id);
+
   EventChannelProxy* event_channel();
 
+  // Returns the id index of |pc|, or nullptr if |pc| is not registered.
+  std::shared_ptr<RtpObjectIndex> RtpIndexFor(RTCPeerConnection* pc);
+
   libwebrtc::scoped_refptr<libwebrtc::RTCRtpSender> GetRtpSenderById(
       RTCPeerConnection* pc,
       std::string id);
@@ -95,8 +114,13 @@ class FlutterWebRTCBase {
                         scoped_refptr<RTCMediaConstraints> mediaConstraints,
                         ParseConstraintType type = kMandatory);
 
+  // Expands every URL of every server into its own slot of |ice_servers|,
+  // STUN and UDP TURN first, then TURN over TCP, then TURN over TLS, and
+  // clears the slots left over. URLs beyond kMaxIceServerSize go to
+  // |dropped|.
   bool CreateIceServers(const EncodableList& iceServersArray,
-                        IceServer* ice_servers);
+                        IceServer* ice_servers,
+                        EncodableList* dropped);
 
  protected:
   scoped_refptr<RTCPeerConnectionFactory> factory_;
@@ -105,19 +129,46 @@ class FlutterWebRTCBase {
   scoped_refptr<RTCDesktopDevice> desktop_device_;
   RTCConfiguration configuration_;
 
-  std::map<std::string, scoped_refptr<RTCPeerConnection>> peerconnections_;
-  std::map<std::string, scoped_refptr<RTCMediaStream>> local_streams_;
-  std::map<std::string, scoped_refptr<RTCMediaTrack>> local_tracks_;
-  std::map<std::string, scoped_refptr<RTCVideoCapturer>> video_capturers_;
+  std::unordered_map<std::string, scoped_refptr<RTCPeerConnection>>
+      peerconnections_;
+  // Platform thread only, like video_capturers_ and renders_ below: these
+  // are unlocked and must not be touched from worker or libwebrtc threads.
+  std::unordered_map<std::string, scoped_refptr<RTCMediaStream>>
+      local_streams_;
+  std::unordered_map<std::string, scoped_refptr<RTCMediaTrack>> local_tracks_;
+  // Index of every remote track across all peer connections, maintained by
+  // FlutterPeerConnectionObserver so track lookups don't have to walk the
+  // remote streams of each connection. Remote peers pick the ids, and SDKs
+  // that use fixed track ids give every connection of a mesh the same ones,
+  // so the index maps track id -> peer connection id -> track.
+  std::unordered_map<std::string,
+                     std::map<std::string, scoped_refptr<RTCMediaTrack>>>
+      remote_tracks_;
+  std::unordered_map<std::string, scoped_refptr<RTCVideoCapturer>>
+      video_capturers_;
   std::map<int64_t, std::shared_ptr<FlutterVideoRenderer>> renders_;
-  std::map<std::string, std::shared_ptr<FlutterRTCDataChannelObserver>>
+  std::unordered_map<std::string,
+                     std::shared_ptr<FlutterRTCDataChannelObserver>>
       data_channel_observers_;
-  std::map<std::string, std::shared_ptr<FlutterPeerConnectionObserver>>
+  std::unordered_map<std::string,
+                     std::shared_ptr<FlutterPeerConnectionObserver>>
       peerconnection_observers_;
-  mutable std::mutex mutex_;
-
-  void lock() { mutex_.lock(); }
-  void unlock() { mutex_.unlock(); }
+  std::unordered_map<const RTCPeerConnection*,
+                     std::shared_ptr<RtpObjectIndex>>
+      rtp_indexes_;
+
+  // The registries are read from the platform thread and written from WebRTC
+  // signaling callbacks, so each group has its own reader-writer lock instead
+  // of sharing one mutex:
+  //   peerconnections_mutex_ guards peerconnections_,
+  //                          peerconnection_observers_ and rtp_indexes_,
+  //   tracks_mutex_          guards local_tracks_ and remote_tracks_,
+  //   data_channels_mutex_   guards data_channel_observers_.
+  // Never call into libwebrtc while holding one of these; callbacks may come
+  // back synchronously and take the same lock.
+  mutable std::shared_mutex peerconnections_mutex_;
+  mutable std::shared_mutex tracks_mutex_;
+  mutable std::shared_mutex data_channels_mutex_;
 
  protected:
   BinaryMessenger* messenger_;
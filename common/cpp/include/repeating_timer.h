@@ -0,0 +1,60 @@
+#ifndef FLUTTER_WEBRTC_REPEATING_TIMER_HXX
+#define FLUTTER_WEBRTC_REPEATING_TIMER_HXX
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace flutter_webrtc_plus_plugin {
+
+// Runs a task periodically on its own worker thread.
+//
+// libwebrtc's C++ wrapper has no callbacks for things like buffered amount
+// changes, so features that need to pace or poll native state use this
+// instead of round-tripping through Dart. The task returns false to let the
+// timer go idle; Start() can be called again at any time to wake it up.
+class RepeatingTimer {
+ public:
+  // Returns true to keep running, false to go idle.
+  using Task = std::function<bool()>;
+
+  RepeatingTimer() = default;
+  ~RepeatingTimer();
+
+  RepeatingTimer(const RepeatingTimer&) = delete;
+  RepeatingTimer& operator=(const RepeatingTimer&) = delete;
+
+  // Calls |task| every |interval| until it returns false or Stop() is
+  // called. If the timer is already running, the current task and interval
+  // are replaced and the timer is kept from going idle after the in-flight
+  // run.
+  void Start(std::chrono::milliseconds interval, Task task);
+
+  // Stops the timer and waits for an in-flight run to finish, unless called
+  // from the task itself. In that case the run ends once the task returns,
+  // even if Start() is called again first.
+  void Stop();
+
+  bool IsRunning() const;
+
+ private:
+  void Run(std::shared_ptr<bool> stop);
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread thread_;
+  std::chrono::milliseconds interval_{0};
+  Task task_;
+  bool running_ = false;
+  bool restart_ = false;
+  // Stop flag of the current run. Each run gets its own, so a run whose
+  // thread was detached by Stop() can't be revived by a later Start().
+  std::shared_ptr<bool> stop_;
+};
+
+}  // namespace flutter_webrtc_plus_plugin
+
+#endif  // FLUTTER_WEBRTC_REPEATING_TIMER_HXX
@@ -0,0 +1,200 @@
+#include "flutter_camera_capabilities.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <tuple>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/videodev2.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace flutter_webrtc_plus_plugin {
+
+// Formats libwebrtc's V4L2 capturer can consume, by how much work it takes
+// to get I420 out of them.
+static const std::pair<const char*, int> kFormatCosts[] = {
+    {"YU12", 0}, {"NV12", 1}, {"YUYV", 2}, {"UYVY", 2},
+    {"MJPG", 3}, {"JPEG", 3},
+};
+
+static int FormatCost(const std::string& pixel_format) {
+  for (const auto& entry : kFormatCosts) {
+    if (pixel_format == entry.first)
+      return entry.second;
+  }
+  return -1;
+}
+
+#ifdef __linux__
+static int Ioctl(int fd, unsigned long request, void* arg) {
+  int ret;
+  do {
+    ret = ioctl(fd, request, arg);
+  } while (ret == -1 && errno == EINTR);
+  return ret;
+}
+
+static std::string FourCc(uint32_t format) {
+  std::string fourcc;
+  for (int i = 0; i < 4; i++)
+    fourcc.push_back(static_cast<char>((format >> (8 * i)) & 0xff));
+  return fourcc;
+}
+
+// Highest frame rate |format| offers at |width|x|height|, or 0.
+static int MaxFps(int fd, uint32_t format, uint32_t width, uint32_t height) {
+  struct v4l2_frmivalenum interval;
+  memset(&interval, 0, sizeof(interval));
+  interval.pixel_format = format;
+  interval.width = width;
+  interval.height = height;
+  int fps = 0;
+  for (; Ioctl(fd, VIDIOC_ENUM_FRAMEINTERVALS, &interval) == 0;
+       interval.index++) {
+    // Stepwise and continuous ranges only report their bounds.
+    const struct v4l2_fract& shortest =
+        interval.type == V4L2_FRMIVAL_TYPE_DISCRETE ? interval.discrete
+                                                    : interval.stepwise.min;
+    if (shortest.numerator > 0)
+      fps = std::max(fps, static_cast<int>(shortest.denominator /
+                                           shortest.numerator));
+    if (interval.type != V4L2_FRMIVAL_TYPE_DISCRETE)
+      break;
+  }
+  return fps;
+}
+
+static void AddSize(int fd,
+                    uint32_t format,
+                    uint32_t width,
+                    uint32_t height,
+                    CameraCapabilities::Modes* modes) {
+  int fps = MaxFps(fd, format, width, height);
+  if (fps <= 0)
+    return;
+  CameraCapabilities::Mode mode;
+  mode.pixel_format = FourCc(format);
+  mode.width = static_cast<int>(width);
+  mode.height = static_cast<int>(height);
+  mode.fps = fps;
+  modes->push_back(mode);
+}
+
+// Opens the capture node whose id matches |guid|. libwebrtc names V4L2
+// cameras by bus_info, or by card when the driver leaves bus_info empty.
+static int OpenCamera(const std::string& guid) {
+  DIR* dir = opendir("/dev");
+  if (!dir)
+    return -1;
+  int found = -1;
+  while (struct dirent* entry = readdir(dir)) {
+    if (strncmp(entry->d_name, "video", 5) != 0)
+      continue;
+    std::string path = std::string("/dev/") + entry->d_name;
+    int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK);
+    if (fd < 0)
+      continue;
+    struct v4l2_capability cap;
+    memset(&cap, 0, sizeof(cap));
+    if (Ioctl(fd, VIDIOC_QUERYCAP, &cap) == 0) {
+      uint32_t caps = (cap.capabilities & V4L2_CAP_DEVICE_CAPS)
+                          ? cap.device_caps
+                          : cap.capabilities;
+      const char* id = cap.bus_info[0] != 0
+                           ? reinterpret_cast<const char*>(cap.bus_info)
+                           : reinterpret_cast<const char*>(cap.card);
+      if ((caps & V4L2_CAP_VIDEO_CAPTURE) && guid == id) {
+        found = fd;
+        break;
+      }
+    }
+    close(fd);
+  }
+  closedir(dir);
+  return found;
+}
+#endif
+
+std::shared_ptr<const CameraCapabilities::Modes> CameraCapabilities::ModesFor(
+    const std::string& guid) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = modes_.find(guid);
+    if (it != modes_.end())
+      return it->second;
+  }
+  auto modes = std::make_shared<const Modes>(Enumerate(guid));
+  std::lock_guard<std::mutex> lock(mutex_);
+  return modes_.emplace(guid, modes).first->second;
+}
+
+void CameraCapabilities::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  modes_.clear();
+}
+
+bool CameraCapabilities::Choose(const Modes& modes,
+                                int width,
+                                int height,
+                                int fps,
+                                Mode* mode) {
+  const Mode* best = nullptr;
+  std::tuple<int, int, int> best_score;
+  for (const Mode& candidate : modes) {
+    std::tuple<int, int, int> score(
+        abs(candidate.width - width) + abs(candidate.height - height),
+        std::max(0, fps - candidate.fps), FormatCost(candidate.pixel_format));
+    if (!best || score < best_score) {
+      best = &candidate;
+      best_score = score;
+    }
+  }
+  if (!best)
+    return false;
+  *mode = *best;
+  return true;
+}
+
+CameraCapabilities::Modes CameraCapabilities::Enumerate(
+    const std::string& guid) {
+  Modes modes;
+#ifdef __linux__
+  int fd = OpenCamera(guid);
+  if (fd < 0)
+    return modes;
+  struct v4l2_fmtdesc format;
+  memset(&format, 0, sizeof(format));
+  format.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  for (; Ioctl(fd, VIDIOC_ENUM_FMT, &format) == 0; format.index++) {
+    if (FormatCost(FourCc(format.pixelformat)) < 0)
+      continue;
+    struct v4l2_frmsizeenum size;
+    memset(&size, 0, sizeof(size));
+    size.pixel_format = format.pixelformat;
+    for (; Ioctl(fd, VIDIOC_ENUM_FRAMESIZES, &size) == 0; size.index++) {
+      if (size.type == V4L2_FRMSIZE_TYPE_DISCRETE) {
+        AddSize(fd, format.pixelformat, size.discrete.width,
+                size.discrete.height, &modes);
+        continue;
+      }
+      // Stepwise and continuous ranges: offer both ends.
+      AddSize(fd, format.pixelformat, size.stepwise.min_width,
+              size.stepwise.min_height, &modes);
+      AddSize(fd, format.pixelformat, size.stepwise.max_width,
+              size.stepwise.max_height, &modes);
+      break;
+    }
+  }
+  close(fd);
+#endif
+  return modes;
+}
+
+}  // namespace flutter_webrtc_plus_plugin
@@ -0,0 +1,146 @@
+#include "flutter_codec_benchmark.h"
+
+#include <chrono>
+#include <utility>
+#include <vector>
+
+namespace flutter_webrtc_plus_plugin {
+
+namespace {
+
+constexpr size_t kSdpBytes = 3 * 1024;
+constexpr size_t kBinaryBytes = 64 * 1024;
+constexpr size_t kTypedListLength = 1024;
+constexpr int kStatsReports = 20;
+
+EncodableValue SdpPayload() {
+  std::string sdp =
+      "v=0\r\no=- 4611731400430051336 2 IN IP4 127.0.0.1\r\ns=-\r\nt=0 0\r\n"
+      "a=group:BUNDLE 0 1\r\n";
+  for (int i = 0; sdp.size() < kSdpBytes; i++) {
+    sdp += "a=candidate:" + std::to_string(i) +
+           " 1 udp 2122260223 192.168.1." + std::to_string(i % 255) + " " +
+           std::to_string(50000 + i) + " typ host generation 0\r\n";
+  }
+  return EncodableValue(sdp);
+}
+
+EncodableValue StatsPayload() {
+  EncodableList reports;
+  for (int i = 0; i < kStatsReports; i++) {
+    EncodableMap values;
+    values[EncodableValue("ssrc")] = EncodableValue(int64_t{1000000 + i});
+    values[EncodableValue("kind")] = EncodableValue(i % 2 ? "audio" : "video");
+    values[EncodableValue("packetsReceived")] = EncodableValue(int64_t{i} * 97);
+    values[EncodableValue("bytesReceived")] = EncodableValue(int64_t{i} << 20);
+    values[EncodableValue("jitter")] = EncodableValue(0.0125 * i);
+    values[EncodableValue("codecId")] =
+        EncodableValue("RTCCodec_0_Inbound_" + std::to_string(96 + i));
+    EncodableMap report;
+    report[EncodableValue("id")] =
+        EncodableValue("RTCInboundRTPStream_" + std::to_string(i));
+    report[EncodableValue("type")] = EncodableValue("inbound-rtp");
+    report[EncodableValue("timestamp")] = EncodableValue(1700000000000.0 + i);
+    report[EncodableValue("values")] = EncodableValue(values);
+    reports.push_back(EncodableValue(report));
+  }
+  EncodableMap params;
+  params[EncodableValue("stats")] = EncodableValue(reports);
+  return EncodableValue(params);
+}
+
+EncodableValue BinaryPayload() {
+  std::vector<uint8_t> data(kBinaryBytes);
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = static_cast<uint8_t>(i * 31);
+  EncodableMap params;
+  params[EncodableValue("event")] = EncodableValue("dataChannelReceiveMessage");
+  params[EncodableValue("type")] = EncodableValue("binary");
+  params[EncodableValue("data")] = EncodableValue(std::move(data));
+  return EncodableValue(params);
+}
+
+EncodableValue TypedListPayload() {
+  std::vector<int32_t> int32s(kTypedListLength);
+  std::vector<int64_t> int64s(kTypedListLength);
+  std::vector<float> float32s(kTypedListLength);
+  std::vector<double> float64s(kTypedListLength);
+  for (size_t i = 0; i < kTypedListLength; i++) {
+    int32s[i] = static_cast<int32_t>(i) - 512;
+    int64s[i] = static_cast<int64_t>(i) << 33;
+    float32s[i] = static_cast<float>(i) / 3;
+    float64s[i] = static_cast<double>(i) / 7;
+  }
+  // Odd element counts so each list starts at a different alignment.
+  EncodableList lists;
+  lists.push_back(EncodableValue(std::vector<uint8_t>{1, 2, 3}));
+  lists.push_back(EncodableValue(std::move(int32s)));
+  lists.push_back(EncodableValue(std::vector<uint8_t>{4}));
+  lists.push_back(EncodableValue(std::move(int64s)));
+  lists.push_back(EncodableValue(std::vector<uint8_t>{5, 6}));
+  lists.push_back(EncodableValue(std::move(float32s)));
+  lists.push_back(EncodableValue(std::move(float64s)));
+  return EncodableValue(lists);
+}
+
+EncodableValue NestedPayload() {
+  EncodableValue value = EncodableValue("leaf");
+  for (int depth = 0; depth < 16; depth++) {
+    EncodableList list;
+    list.push_back(EncodableValue(depth));
+    list.push_back(EncodableValue(depth % 2 == 0));
+    list.push_back(EncodableValue());
+    list.push_back(std::move(value));
+    value = EncodableValue(std::move(list));
+  }
+  return value;
+}
+
+EncodableMap RoundTrip(const EncodableValue& value, int rounds) {
+  const flutter::StandardMessageCodec& codec =
+      flutter::StandardMessageCodec::GetInstance();
+  std::chrono::duration<double, std::micro> encode_time{0};
+  std::chrono::duration<double, std::micro> decode_time{0};
+  size_t encoded_bytes = 0;
+  bool equal = true;
+  for (int i = 0; i < rounds; i++) {
+    auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<std::vector<uint8_t>> encoded = codec.EncodeMessage(value);
+    auto encoded_at = std::chrono::steady_clock::now();
+    std::unique_ptr<EncodableValue> decoded =
+        codec.DecodeMessage(encoded->data(), encoded->size());
+    decode_time += std::chrono::steady_clock::now() - encoded_at;
+    encode_time += encoded_at - start;
+    encoded_bytes = encoded->size();
+    equal = equal && decoded && *decoded == value;
+  }
+  EncodableMap params;
+  params[EncodableValue("bytes")] =
+      EncodableValue(static_cast<int64_t>(encoded_bytes));
+  params[EncodableValue("encodeUs")] =
+      EncodableValue(encode_time.count() / rounds);
+  params[EncodableValue("decodeUs")] =
+      EncodableValue(decode_time.count() / rounds);
+  params[EncodableValue("roundTrip")] = EncodableValue(equal);
+  return params;
+}
+
+}  // namespace
+
+EncodableMap FlutterCodecBenchmark::Run(int rounds) {
+  std::vector<std::pair<std::string, EncodableValue>> payloads;
+  payloads.emplace_back("sdp", SdpPayload());
+  payloads.emplace_back("stats", StatsPayload());
+  payloads.emplace_back("binary", BinaryPayload());
+  payloads.emplace_back("typedLists", TypedListPayload());
+  payloads.emplace_back("nested", NestedPayload());
+
+  EncodableMap params;
+  for (const auto& payload : payloads) {
+    params[EncodableValue(payload.first)] =
+        EncodableValue(RoundTrip(payload.second, rounds));
+  }
+  return params;
+}
+
+}  // namespace flutter_webrtc_plus_plugin
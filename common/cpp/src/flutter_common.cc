@@ -83,10 +83,11 @@ class EventChannelProxyImpl : public EventChannelProxy {
          [&](const EncodableValue* arguments,
              std::unique_ptr<flutter::EventSink<EncodableValue>>&& events)
              -> std::unique_ptr<flutter::StreamHandlerError<EncodableValue>> {
+           std::lock_guard<std::mutex> lock(mutex_);
            sink_ = std::move(events);
            std::weak_ptr<EventSink> weak_sink = sink_;
            for (auto& event : event_queue_) {
-            PostEvent(event);
+            PostEvent(std::move(event));
            }
            event_queue_.clear();
            on_listen_called_ = true;
@@ -94,6 +95,7 @@ class EventChannelProxyImpl : public EventChannelProxy {
          },
          [&](const EncodableValue* arguments)
              -> std::unique_ptr<flutter::StreamHandlerError<EncodableValue>> {
+           std::lock_guard<std::mutex> lock(mutex_);
            on_listen_called_ = false;
            return nullptr;
          });
@@ -104,19 +106,25 @@ class EventChannelProxyImpl : public EventChannelProxy {
    virtual ~EventChannelProxyImpl() {}
  
    void Success(const EncodableValue& event, bool cache_event = true) override {
+     Success(EncodableValue(event), cache_event);
+   }
+
+   void Success(EncodableValue&& event, bool cache_event = true) override {
+     // Events can come from WebRTC threads and native timers concurrently.
+     std::lock_guard<std::mutex> lock(mutex_);
      if (on_listen_called_) {
-       PostEvent(event);
+       PostEvent(std::move(event));
      } else {
        if (cache_event) {
-         event_queue_.push_back(event);
+         event_queue_.push_back(std::move(event));
        }
      }
    }
 
-   void PostEvent(const EncodableValue& event) {
+   void PostEvent(EncodableValue event) {
      if(task_runner_) {
       std::weak_ptr<EventSink> weak_sink = sink_;
-       task_runner_->EnqueueTask([weak_sink, event]() {
+       task_runner_->EnqueueTask([weak_sink, event = std::move(event)]() {
         auto sink = weak_sink.lock();
         if (sink) {
           sink->Success(event);
@@ -132,6 +140,7 @@ class EventChannelProxyImpl : public EventChannelProxy {
    std::shared_ptr<flutter::EventSink<flutter::EncodableValue>> sink_;
    std::list<EncodableValue> event_queue_;
    bool on_listen_called_ = false;
+   std::mutex mutex_;
    TaskRunner* task_runner_;
  };
 
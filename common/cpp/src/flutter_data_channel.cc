@@ -1,9 +1,82 @@
 #include "flutter_data_channel.h"
+#include "flutter_data_channel_benchmark.h"
 
+#include <algorithm>
+#include <limits>
 #include <vector>
 
+#if defined(_WIN32)
+#include "ghc/filesystem.hpp"
+// ghc's streams treat std::string paths as UTF-8, which is what Dart sends.
+using FileInputStream = ghc::filesystem::ifstream;
+using FileOutputStream = ghc::filesystem::ofstream;
+#else
+#include <fstream>
+using FileInputStream = std::ifstream;
+using FileOutputStream = std::ofstream;
+#endif
+
 namespace flutter_webrtc_plus_plugin {
 
+// How often a paced channel re-checks its SCTP buffer to drain the native
+// send queue and report buffered amount changes.
+static constexpr std::chrono::milliseconds kSendQueuePollInterval(5);
+
+// Chunk size used by dataChannelSendFile when none is given. 16 KiB is the
+// largest message size every SCTP implementation is known to accept.
+static constexpr int kDefaultFileChunkSize = 16 * 1024;
+
+// libwebrtc rejects data channel messages larger than 256 KiB.
+static constexpr int kMaxFileChunkSize = 256 * 1024;
+
+// Receive batching defaults for limits that dataChannelSetReceiveBatching
+// leaves out.
+static constexpr int64_t kDefaultReceiveBatchMaxBytes = 256 * 1024;
+static constexpr int kDefaultReceiveBatchMaxDelayMs = 16;
+
+// File chunks are read from disk in blocks of about this size.
+static constexpr size_t kFileReadAheadSize = 256 * 1024;
+
+// How many bytes a file transfer keeps buffered when no send queue
+// watermarks have been set.
+static constexpr uint64_t kDefaultFileSendWindow = 1024 * 1024;
+
+// Received file chunks allowed to wait for the disk. A transfer whose
+// writes fall further behind fails rather than buffering without bound.
+static constexpr size_t kFileSinkQueueLimit = 16 * 1024 * 1024;
+
+// Minimum time between two file transfer progress events.
+static constexpr std::chrono::milliseconds kFileProgressInterval(100);
+
+struct FlutterRTCDataChannelObserver::FileSend {
+  std::string path;
+  FileInputStream file;
+  std::vector<uint8_t> buffer;
+  size_t buffer_offset = 0;
+  size_t buffer_size = 0;
+  size_t chunk_size = 0;
+  uint64_t total_bytes = 0;
+  uint64_t bytes_sent = 0;
+  std::chrono::steady_clock::time_point last_progress;
+};
+
+struct FlutterRTCDataChannelObserver::FileSink {
+  std::string path;
+  uint64_t expected_bytes = 0;
+
+  // Guarded by file_sink_mutex_; filled from the network thread.
+  std::deque<std::vector<uint8_t>> pending;
+  size_t pending_bytes = 0;
+  uint64_t bytes_received = 0;
+  std::string overflow_error;
+
+  // Guarded by write_mutex; only touched by whoever writes.
+  std::mutex write_mutex;
+  FileOutputStream file;
+  uint64_t bytes_written = 0;
+  std::chrono::steady_clock::time_point last_progress;
+};
+
 FlutterRTCDataChannelObserver::FlutterRTCDataChannelObserver(
     scoped_refptr<RTCDataChannel> data_channel,
     BinaryMessenger* messenger,
@@ -14,7 +87,394 @@ FlutterRTCDataChannelObserver::FlutterRTCDataChannelObserver(
   data_channel_->RegisterObserver(this);
 }
 
-FlutterRTCDataChannelObserver::~FlutterRTCDataChannelObserver() {}
+FlutterRTCDataChannelObserver::FlutterRTCDataChannelObserver(
+    scoped_refptr<RTCDataChannel> data_channel,
+    std::unique_ptr<EventChannelProxy> event_channel)
+    : event_channel_(std::move(event_channel)), data_channel_(data_channel) {
+  data_channel_->RegisterObserver(this);
+}
+
+FlutterRTCDataChannelObserver::~FlutterRTCDataChannelObserver() {
+  receive_timer_.Stop();
+  file_write_timer_.Stop();
+  file_send_timer_.Stop();
+  send_timer_.Stop();
+  data_channel_->UnregisterObserver();
+}
+
+void FlutterRTCDataChannelObserver::Send(const uint8_t* data,
+                                         size_t size,
+                                         bool binary) {
+  std::unique_lock<std::mutex> lock(send_mutex_);
+  if (send_queue_.empty() && data_channel_->buffered_amount() < SendLimit()) {
+    data_channel_->Send(data, static_cast<uint32_t>(size), binary);
+  } else {
+    send_queue_.push_back({std::vector<uint8_t>(data, data + size), binary});
+    queued_bytes_ += size;
+  }
+
+  if (high_watermark_ == 0 && send_queue_.empty())
+    return;
+
+  if (data_channel_->buffered_amount() + queued_bytes_ > low_watermark_)
+    above_low_watermark_ = true;
+  lock.unlock();
+
+  send_timer_.Start(kSendQueuePollInterval,
+                    [this]() { return PumpSendQueue(); });
+}
+
+void FlutterRTCDataChannelObserver::SetSendQueueWatermarks(
+    uint64_t high_watermark,
+    uint64_t low_watermark) {
+  {
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    high_watermark_ = high_watermark;
+    low_watermark_ =
+        high_watermark > 0 ? std::min(low_watermark, high_watermark) : 0;
+    if (send_queue_.empty() && !above_low_watermark_)
+      return;
+  }
+  send_timer_.Start(kSendQueuePollInterval,
+                    [this]() { return PumpSendQueue(); });
+}
+
+uint64_t FlutterRTCDataChannelObserver::buffered_amount() {
+  std::lock_guard<std::mutex> lock(send_mutex_);
+  return data_channel_->buffered_amount() + queued_bytes_;
+}
+
+uint64_t FlutterRTCDataChannelObserver::SendLimit() const {
+  return high_watermark_ > 0 ? high_watermark_
+                             : std::numeric_limits<uint64_t>::max();
+}
+
+bool FlutterRTCDataChannelObserver::PumpSendQueue() {
+  std::lock_guard<std::mutex> lock(send_mutex_);
+  RTCDataChannelState state = data_channel_->state();
+  if (state == RTCDataChannelClosing || state == RTCDataChannelClosed) {
+    send_queue_.clear();
+    queued_bytes_ = 0;
+    above_low_watermark_ = false;
+    return false;
+  }
+
+  if (state == RTCDataChannelOpen) {
+    uint64_t limit = SendLimit();
+    while (!send_queue_.empty() && data_channel_->buffered_amount() < limit) {
+      PendingMessage& message = send_queue_.front();
+      data_channel_->Send(message.data.data(),
+                          static_cast<uint32_t>(message.data.size()),
+                          message.binary);
+      queued_bytes_ -= message.data.size();
+      send_queue_.pop_front();
+    }
+  }
+
+  uint64_t amount = data_channel_->buffered_amount() + queued_bytes_;
+  ReportBufferedAmount(amount);
+
+  if (above_low_watermark_ && amount <= low_watermark_) {
+    above_low_watermark_ = false;
+    EncodableMap params;
+    params[EncodableValue("event")] =
+        EncodableValue("dataChannelBufferedAmountLow");
+    params[EncodableValue("id")] = EncodableValue(data_channel_->id());
+    params[EncodableValue("bufferedAmount")] =
+        EncodableValue(static_cast<int64_t>(amount));
+    event_channel_->Success(EncodableValue(std::move(params)), false);
+  }
+
+  return !send_queue_.empty() || above_low_watermark_;
+}
+
+void FlutterRTCDataChannelObserver::ReportBufferedAmount(uint64_t amount) {
+  if (amount == reported_amount_)
+    return;
+  EncodableMap params;
+  params[EncodableValue("event")] =
+      EncodableValue("dataChannelBufferedAmountChange");
+  params[EncodableValue("id")] = EncodableValue(data_channel_->id());
+  params[EncodableValue("bufferedAmount")] =
+      EncodableValue(static_cast<int64_t>(amount));
+  // Like the mobile implementations, changedAmount carries the previous
+  // buffered amount.
+  params[EncodableValue("changedAmount")] =
+      EncodableValue(static_cast<int64_t>(reported_amount_));
+  reported_amount_ = amount;
+  event_channel_->Success(EncodableValue(std::move(params)), false);
+}
+
+bool FlutterRTCDataChannelObserver::SendFile(const std::string& path,
+                                             size_t chunk_size,
+                                             uint64_t* total_bytes,
+                                             std::string* error) {
+  std::unique_ptr<FileSend> transfer(new FileSend());
+  transfer->file.open(path, std::ios::binary | std::ios::ate);
+  if (!transfer->file.is_open()) {
+    *error = "Unable to open " + path;
+    return false;
+  }
+  transfer->path = path;
+  transfer->total_bytes = static_cast<uint64_t>(transfer->file.tellg());
+  transfer->file.seekg(0, std::ios::beg);
+  transfer->chunk_size = chunk_size;
+  // Keep whole chunks in the read-ahead buffer so no chunk straddles a read.
+  transfer->buffer.resize(
+      std::max(chunk_size, kFileReadAheadSize / chunk_size * chunk_size));
+  *total_bytes = transfer->total_bytes;
+
+  {
+    std::lock_guard<std::mutex> lock(file_send_mutex_);
+    if (file_send_) {
+      *error = "Already sending " + file_send_->path;
+      return false;
+    }
+    file_send_ = std::move(transfer);
+  }
+  file_send_timer_.Start(kSendQueuePollInterval,
+                         [this]() { return PumpFileSend(); });
+  return true;
+}
+
+bool FlutterRTCDataChannelObserver::PumpFileSend() {
+  std::lock_guard<std::mutex> lock(file_send_mutex_);
+  if (!file_send_)
+    return false;
+  FileSend& transfer = *file_send_;
+
+  std::string error;
+  RTCDataChannelState state = data_channel_->state();
+  if (state == RTCDataChannelClosing || state == RTCDataChannelClosed) {
+    error = "Data channel closed";
+  } else if (state == RTCDataChannelOpen) {
+    uint64_t window;
+    {
+      std::lock_guard<std::mutex> send_lock(send_mutex_);
+      window = high_watermark_ > 0 ? high_watermark_ : kDefaultFileSendWindow;
+    }
+    while (transfer.bytes_sent < transfer.total_bytes &&
+           buffered_amount() < window) {
+      if (transfer.buffer_offset == transfer.buffer_size) {
+        transfer.file.read(reinterpret_cast<char*>(transfer.buffer.data()),
+                           transfer.buffer.size());
+        transfer.buffer_offset = 0;
+        transfer.buffer_size = static_cast<size_t>(transfer.file.gcount());
+        if (transfer.buffer_size == 0) {
+          error = "Unable to read " + transfer.path;
+          break;
+        }
+      }
+      size_t size = std::min(transfer.chunk_size,
+                             transfer.buffer_size - transfer.buffer_offset);
+      Send(transfer.buffer.data() + transfer.buffer_offset, size, true);
+      transfer.buffer_offset += size;
+      transfer.bytes_sent += size;
+    }
+  }
+
+  bool done = !error.empty() || transfer.bytes_sent >= transfer.total_bytes;
+  auto now = std::chrono::steady_clock::now();
+  if (done || now - transfer.last_progress >= kFileProgressInterval) {
+    transfer.last_progress = now;
+    ReportFileProgress("dataChannelFileSendProgress", transfer.path,
+                       transfer.bytes_sent, transfer.total_bytes, done, error);
+  }
+  if (done) {
+    file_send_.reset();
+    return false;
+  }
+  return true;
+}
+
+bool FlutterRTCDataChannelObserver::WriteToFile(const std::string& path,
+                                                uint64_t expected_bytes,
+                                                std::string* error) {
+  std::shared_ptr<FileSink> sink;
+  if (!path.empty()) {
+    sink = std::make_shared<FileSink>();
+    sink->file.open(path, std::ios::binary | std::ios::trunc);
+    if (!sink->file.is_open()) {
+      *error = "Unable to open " + path;
+      return false;
+    }
+    sink->path = path;
+    sink->expected_bytes = expected_bytes;
+  }
+
+  std::shared_ptr<FileSink> previous;
+  std::deque<std::vector<uint8_t>> chunks;
+  std::string previous_error;
+  {
+    std::lock_guard<std::mutex> lock(file_sink_mutex_);
+    previous = std::move(file_sink_);
+    file_sink_ = std::move(sink);
+    if (previous) {
+      chunks.swap(previous->pending);
+      previous_error = previous->overflow_error;
+    }
+  }
+  // Finish the replaced transfer here, so everything it received is on
+  // disk before this call returns.
+  if (previous)
+    WriteFileChunks(previous.get(), &chunks, previous_error, true);
+  return true;
+}
+
+bool FlutterRTCDataChannelObserver::WriteToFileSink(const char* buffer,
+                                                    int length) {
+  {
+    std::lock_guard<std::mutex> lock(file_sink_mutex_);
+    if (!file_sink_)
+      return false;
+    FileSink& sink = *file_sink_;
+    // Everything expected has arrived; later messages are events again.
+    if (sink.expected_bytes > 0 && sink.bytes_received >= sink.expected_bytes)
+      return false;
+    sink.bytes_received += length;
+    if (!sink.overflow_error.empty())
+      return true;
+    if (sink.pending_bytes + length > kFileSinkQueueLimit) {
+      sink.overflow_error = "Unable to write " + sink.path + " fast enough";
+      sink.pending.clear();
+      sink.pending_bytes = 0;
+    } else {
+      const uint8_t* bytes = reinterpret_cast<const uint8_t*>(buffer);
+      sink.pending.emplace_back(bytes, bytes + length);
+      sink.pending_bytes += length;
+    }
+  }
+  file_write_timer_.Start(kSendQueuePollInterval,
+                          [this]() { return DrainFileSink(); });
+  return true;
+}
+
+bool FlutterRTCDataChannelObserver::DrainFileSink() {
+  std::shared_ptr<FileSink> sink;
+  std::deque<std::vector<uint8_t>> chunks;
+  std::string error;
+  bool input_done;
+  {
+    std::lock_guard<std::mutex> lock(file_sink_mutex_);
+    sink = file_sink_;
+    if (!sink)
+      return false;
+    chunks.swap(sink->pending);
+    sink->pending_bytes = 0;
+    error = sink->overflow_error;
+    input_done = sink->expected_bytes > 0 &&
+                 sink->bytes_received >= sink->expected_bytes;
+  }
+  bool wrote = !chunks.empty();
+  if (!WriteFileChunks(sink.get(), &chunks, error, input_done)) {
+    // Go idle when there was nothing to write; the next chunk restarts us.
+    return wrote;
+  }
+  std::lock_guard<std::mutex> lock(file_sink_mutex_);
+  if (file_sink_ == sink)
+    file_sink_.reset();
+  return false;
+}
+
+bool FlutterRTCDataChannelObserver::WriteFileChunks(
+    FileSink* sink,
+    std::deque<std::vector<uint8_t>>* chunks,
+    std::string error,
+    bool input_done) {
+  std::lock_guard<std::mutex> lock(sink->write_mutex);
+  if (!sink->file.is_open())
+    return true;
+  for (const std::vector<uint8_t>& chunk : *chunks) {
+    if (!error.empty())
+      break;
+    sink->file.write(reinterpret_cast<const char*>(chunk.data()),
+                     chunk.size());
+    if (!sink->file) {
+      error = "Unable to write " + sink->path;
+    }
+    sink->bytes_written += chunk.size();
+  }
+  chunks->clear();
+
+  bool done = !error.empty() || input_done;
+  auto now = std::chrono::steady_clock::now();
+  if (done) {
+    sink->file.close();
+  }
+  if (done || now - sink->last_progress >= kFileProgressInterval) {
+    sink->last_progress = now;
+    ReportFileProgress("dataChannelFileReceiveProgress", sink->path,
+                       sink->bytes_written, sink->expected_bytes, done, error);
+  }
+  return done;
+}
+
+void FlutterRTCDataChannelObserver::ReportFileProgress(
+    const char* event,
+    const std::string& path,
+    uint64_t bytes,
+    uint64_t total_bytes,
+    bool done,
+    const std::string& error) {
+  EncodableMap params;
+  params[EncodableValue("event")] = EncodableValue(event);
+  params[EncodableValue("id")] = EncodableValue(data_channel_->id());
+  params[EncodableValue("path")] = EncodableValue(path);
+  params[EncodableValue("bytes")] = EncodableValue(static_cast<int64_t>(bytes));
+  params[EncodableValue("totalBytes")] =
+      EncodableValue(static_cast<int64_t>(total_bytes));
+  params[EncodableValue("done")] = EncodableValue(done);
+  if (!error.empty()) {
+    params[EncodableValue("error")] = EncodableValue(error);
+  }
+  // Only the final event is worth replaying to a late listener.
+  event_channel_->Success(EncodableValue(std::move(params)), done);
+}
+
+// Largest stream id an SCTP data channel can use.
+static constexpr int kMaxDataChannelId = 65534;
+
+// Fills |init| from an RTCDataChannelInit dictionary. Missing keys keep the
+// WebRTC defaults (ordered, fully reliable, not negotiated). Returns false
+// and sets |error| for combinations the spec rejects.
+static bool ParseDataChannelInit(const EncodableMap& dict,
+                                 RTCDataChannelInit* init,
+                                 std::string* error) {
+  if (const bool* ordered = findPtr<bool>(dict, "ordered"))
+    init->ordered = *ordered;
+
+  // maxPacketLifeTime is the spec name; older clients send
+  // maxRetransmitTime.
+  int max_packet_life_time = findInt(dict, "maxPacketLifeTime");
+  if (max_packet_life_time < 0)
+    max_packet_life_time = findInt(dict, "maxRetransmitTime");
+  int max_retransmits = findInt(dict, "maxRetransmits");
+  if (max_packet_life_time >= 0 && max_retransmits >= 0) {
+    *error = "maxPacketLifeTime and maxRetransmits cannot both be set";
+    return false;
+  }
+  init->maxRetransmitTime = max_packet_life_time >= 0 ? max_packet_life_time
+                                                      : -1;
+  init->maxRetransmits = max_retransmits >= 0 ? max_retransmits : -1;
+  init->reliable = init->maxRetransmitTime < 0 && init->maxRetransmits < 0;
+
+  if (const std::string* protocol = findPtr<std::string>(dict, "protocol"))
+    init->protocol = *protocol;
+
+  init->negotiated = findBoolean(dict, "negotiated");
+  int id = findInt(dict, "id");
+  if (id > kMaxDataChannelId) {
+    *error = "id must be between 0 and " + std::to_string(kMaxDataChannelId);
+    return false;
+  }
+  if (init->negotiated && id < 0) {
+    *error = "negotiated data channels require an id";
+    return false;
+  }
+  // -1 lets SCTP pick the stream id for in-band negotiated channels.
+  init->id = id >= 0 ? id : -1;
+  return true;
+}
 
 void FlutterDataChannel::CreateDataChannel(
     const std::string& peerConnectionId,
@@ -23,31 +483,19 @@ void FlutterDataChannel::CreateDataChannel(
     RTCPeerConnection* pc,
     std::unique_ptr<MethodResultProxy> result) {
   RTCDataChannelInit init;
-  init.id = GetValue<int>(dataChannelDict.find(EncodableValue("id"))->second);
-  init.ordered =
-      GetValue<bool>(dataChannelDict.find(EncodableValue("ordered"))->second);
-
-  if (dataChannelDict.find(EncodableValue("maxRetransmits")) !=
-      dataChannelDict.end()) {
-    init.maxRetransmits = GetValue<int>(
-        dataChannelDict.find(EncodableValue("maxRetransmits"))->second);
+  std::string error;
+  if (!ParseDataChannelInit(dataChannelDict, &init, &error)) {
+    result->Error("createDataChannelFailed", "createDataChannel() " + error);
+    return;
   }
 
-  std::string protocol = "sctp";
-
-  if (dataChannelDict.find(EncodableValue("protocol")) ==
-      dataChannelDict.end()) {
-    protocol = GetValue<std::string>(
-        dataChannelDict.find(EncodableValue("protocol"))->second);
-  }
-
-  init.protocol = protocol;
-
-  init.negotiated = GetValue<bool>(
-      dataChannelDict.find(EncodableValue("negotiated"))->second);
-
   scoped_refptr<RTCDataChannel> data_channel =
       pc->CreateDataChannel(label.c_str(), &init);
+  if (!data_channel) {
+    result->Error("createDataChannelFailed",
+                  "createDataChannel() could not create the data channel");
+    return;
+  }
 
   std::string uuid = base_->GenerateUUID();
   std::string event_channel =
@@ -57,62 +505,243 @@ void FlutterDataChannel::CreateDataChannel(
       new FlutterRTCDataChannelObserver(data_channel, base_->messenger_, base_->task_runner_,
                                         event_channel));
 
-  base_->lock();
-  base_->data_channel_observers_[uuid] = std::move(observer);
-  base_->unlock();
+  {
+    std::unique_lock<std::shared_mutex> lock(base_->data_channels_mutex_);
+    base_->data_channel_observers_[uuid] = std::move(observer);
+  }
 
   EncodableMap params;
-  params[EncodableValue("id")] = EncodableValue(init.id);
+  params[EncodableValue("id")] = EncodableValue(data_channel->id());
   params[EncodableValue("label")] =
       EncodableValue(data_channel->label().std_string());
   params[EncodableValue("flutterId")] = EncodableValue(uuid);
   result->Success(EncodableValue(params));
 }
 
+// Sends |data| straight from the decoded method call storage. Returns false
+// if |data| is neither a string nor a byte list.
+static bool SendEncodableValue(FlutterRTCDataChannelObserver* observer,
+                               const EncodableValue& data,
+                               bool binary) {
+  if (const auto* bytes = std::get_if<std::vector<uint8_t>>(&data)) {
+    observer->Send(bytes->data(), bytes->size(), binary);
+    return true;
+  }
+  if (const auto* str = std::get_if<std::string>(&data)) {
+    observer->Send(reinterpret_cast<const uint8_t*>(str->data()), str->size(),
+                   binary);
+    return true;
+  }
+  return false;
+}
+
 void FlutterDataChannel::DataChannelSend(
-    RTCDataChannel* data_channel,
+    FlutterRTCDataChannelObserver* observer,
     const std::string& type,
     const EncodableValue& data,
     std::unique_ptr<MethodResultProxy> result) {
-  bool is_binary = type == "binary";
-  if (is_binary && TypeIs<std::vector<uint8_t>>(data)) {
-    std::vector<uint8_t> buffer = GetValue<std::vector<uint8_t>>(data);
-    data_channel->Send(buffer.data(), static_cast<uint32_t>(buffer.size()),
-                       true);
-  } else {
-    std::string str = GetValue<std::string>(data);
-    data_channel->Send(reinterpret_cast<const uint8_t*>(str.c_str()),
-                       static_cast<uint32_t>(str.length()), false);
+  bool is_binary = type == "binary" && TypeIs<std::vector<uint8_t>>(data);
+  if (!SendEncodableValue(observer, data, is_binary)) {
+    result->Error("dataChannelSendFailed",
+                  "dataChannelSend() data must be a String or Uint8List");
+    return;
   }
   result->Success();
 }
 
-void FlutterDataChannel::DataChannelGetBufferedAmount(RTCDataChannel* data_channel,
-                             std::unique_ptr<MethodResultProxy> result) {
+void FlutterDataChannel::DataChannelSendBatch(
+    FlutterRTCDataChannelObserver* observer,
+    const EncodableList& messages,
+    std::unique_ptr<MethodResultProxy> result) {
+  // Each entry is sent as binary if it is a Uint8List and as text if it is a
+  // String, in list order.
+  int sent = 0;
+  for (const EncodableValue& message : messages) {
+    bool is_binary = TypeIs<std::vector<uint8_t>>(message);
+    if (!SendEncodableValue(observer, message, is_binary)) {
+      result->Error("dataChannelSendBatchFailed",
+                    "dataChannelSendBatch() message " + std::to_string(sent) +
+                        " must be a String or Uint8List");
+      return;
+    }
+    sent++;
+  }
+
+  EncodableMap params;
+  params[EncodableValue("sent")] = EncodableValue(sent);
+  params[EncodableValue("bufferedAmount")] =
+      EncodableValue(static_cast<int64_t>(observer->buffered_amount()));
+  result->Success(EncodableValue(params));
+}
+
+void FlutterDataChannel::DataChannelGetBufferedAmount(
+    FlutterRTCDataChannelObserver* observer,
+    std::unique_ptr<MethodResultProxy> result) {
   EncodableMap params;
-  params[EncodableValue("bufferedAmount")] = EncodableValue((int64_t)data_channel->buffered_amount());
+  params[EncodableValue("bufferedAmount")] =
+      EncodableValue(static_cast<int64_t>(observer->buffered_amount()));
   result->Success(EncodableValue(params));
 }
 
+void FlutterDataChannel::DataChannelSetSendQueueWatermarks(
+    FlutterRTCDataChannelObserver* observer,
+    const EncodableMap& params,
+    std::unique_ptr<MethodResultProxy> result) {
+  int64_t high_watermark = findLongInt(params, "highWatermark");
+  int64_t low_watermark = findLongInt(params, "lowWatermark");
+  if (high_watermark < 0)
+    high_watermark = 0;
+  if (low_watermark < 0)
+    low_watermark = 0;
+  if (high_watermark > 0 && low_watermark > high_watermark) {
+    result->Error("dataChannelSetSendQueueWatermarksFailed",
+                  "lowWatermark must not exceed highWatermark");
+    return;
+  }
+  observer->SetSendQueueWatermarks(static_cast<uint64_t>(high_watermark),
+                                   static_cast<uint64_t>(low_watermark));
+  result->Success();
+}
+
+void FlutterDataChannel::DataChannelSendFile(
+    FlutterRTCDataChannelObserver* observer,
+    const EncodableMap& params,
+    std::unique_ptr<MethodResultProxy> result) {
+  const std::string& path = findString(params, "path");
+  int chunk_size = findInt(params, "chunkSize");
+  if (chunk_size <= 0)
+    chunk_size = kDefaultFileChunkSize;
+  if (path.empty() || chunk_size > kMaxFileChunkSize) {
+    result->Error("dataChannelSendFileFailed",
+                  "dataChannelSendFile() requires a path and a chunkSize of "
+                  "at most " + std::to_string(kMaxFileChunkSize));
+    return;
+  }
+
+  uint64_t total_bytes = 0;
+  std::string error;
+  if (!observer->SendFile(path, static_cast<size_t>(chunk_size), &total_bytes,
+                          &error)) {
+    result->Error("dataChannelSendFileFailed", error);
+    return;
+  }
+
+  EncodableMap response;
+  response[EncodableValue("totalBytes")] =
+      EncodableValue(static_cast<int64_t>(total_bytes));
+  result->Success(EncodableValue(response));
+}
+
+void FlutterDataChannel::DataChannelWriteToFile(
+    FlutterRTCDataChannelObserver* observer,
+    const EncodableMap& params,
+    std::unique_ptr<MethodResultProxy> result) {
+  int64_t expected_bytes = findLongInt(params, "expectedBytes");
+  if (expected_bytes < 0)
+    expected_bytes = 0;
+
+  std::string error;
+  if (!observer->WriteToFile(findString(params, "path"),
+                             static_cast<uint64_t>(expected_bytes), &error)) {
+    result->Error("dataChannelWriteToFileFailed", error);
+    return;
+  }
+  result->Success();
+}
+
+void FlutterDataChannel::DataChannelSetReceiveBatching(
+    FlutterRTCDataChannelObserver* observer,
+    const EncodableMap& params,
+    std::unique_ptr<MethodResultProxy> result) {
+  int max_messages = findInt(params, "maxMessages");
+  int64_t max_bytes = findLongInt(params, "maxBytes");
+  int max_delay_ms = findInt(params, "maxDelayMs");
+  if (max_bytes <= 0)
+    max_bytes = kDefaultReceiveBatchMaxBytes;
+  if (max_delay_ms <= 0)
+    max_delay_ms = kDefaultReceiveBatchMaxDelayMs;
+  observer->SetReceiveBatching(max_messages, static_cast<uint64_t>(max_bytes),
+                               std::chrono::milliseconds(max_delay_ms));
+  result->Success();
+}
+
+FlutterDataChannel::~FlutterDataChannel() {
+  benchmark_cancelled_ = true;
+  if (benchmark_thread_.joinable())
+    benchmark_thread_.join();
+}
+
+void FlutterDataChannel::DataChannelBenchmark(
+    const EncodableMap& params,
+    std::unique_ptr<MethodResultProxy> result) {
+  FlutterDataChannelBenchmark::Options options;
+  for (const EncodableValue& size : findList(params, "messageSizes")) {
+    if (TypeIs<int>(size) && GetValue<int>(size) > 0 &&
+        GetValue<int>(size) <= kMaxFileChunkSize) {
+      options.message_sizes.push_back(GetValue<int>(size));
+    }
+  }
+  if (options.message_sizes.empty())
+    options.message_sizes = {64, 1024, 16 * 1024, 64 * 1024};
+  options.messages_per_size = findInt(params, "messagesPerSize");
+  if (options.messages_per_size <= 0)
+    options.messages_per_size = 1000;
+  options.receive_batch_size = findInt(params, "receiveBatchSize");
+  int timeout_ms = findInt(params, "timeoutMs");
+  options.timeout = std::chrono::milliseconds(timeout_ms > 0 ? timeout_ms
+                                                             : 30000);
+  if (benchmark_running_) {
+    result->Error("dataChannelBenchmarkFailed",
+                  "A benchmark is already running");
+    return;
+  }
+  // The previous run has finished, so this doesn't block.
+  if (benchmark_thread_.joinable())
+    benchmark_thread_.join();
+  benchmark_running_ = true;
+  std::shared_ptr<MethodResultProxy> result_ptr(result.release());
+  benchmark_thread_ = std::thread([this, factory = base_->factory_,
+                                   options = std::move(options),
+                                   result_ptr]() {
+    FlutterDataChannelBenchmark::Run(factory, options, benchmark_cancelled_,
+                                     result_ptr.get());
+    benchmark_running_ = false;
+  });
+}
+
 void FlutterDataChannel::DataChannelClose(
     RTCDataChannel* data_channel,
     const std::string& data_channel_uuid,
     std::unique_ptr<MethodResultProxy> result) {
   data_channel->Close();
-  auto it = base_->data_channel_observers_.find(data_channel_uuid);
-  if (it != base_->data_channel_observers_.end())
-    base_->data_channel_observers_.erase(it);
+  std::shared_ptr<FlutterRTCDataChannelObserver> observer;
+  {
+    std::unique_lock<std::shared_mutex> lock(base_->data_channels_mutex_);
+    auto it = base_->data_channel_observers_.find(data_channel_uuid);
+    if (it != base_->data_channel_observers_.end()) {
+      observer = std::move(it->second);
+      base_->data_channel_observers_.erase(it);
+    }
+  }
   result->Success();
 }
 
-RTCDataChannel* FlutterDataChannel::DataChannelForId(const std::string& uuid) {
+scoped_refptr<RTCDataChannel> FlutterDataChannel::DataChannelForId(
+    const std::string& uuid) {
+  std::shared_lock<std::shared_mutex> lock(base_->data_channels_mutex_);
   auto it = base_->data_channel_observers_.find(uuid);
 
-  if (it != base_->data_channel_observers_.end()) {
-    FlutterRTCDataChannelObserver* observer = it->second.get();
-    scoped_refptr<RTCDataChannel> data_channel = observer->data_channel();
-    return data_channel.get();
-  }
+  if (it != base_->data_channel_observers_.end())
+    return it->second->data_channel();
+  return nullptr;
+}
+
+std::shared_ptr<FlutterRTCDataChannelObserver>
+FlutterDataChannel::DataChannelObserverForId(const std::string& uuid) {
+  std::shared_lock<std::shared_mutex> lock(base_->data_channels_mutex_);
+  auto it = base_->data_channel_observers_.find(uuid);
+  if (it != base_->data_channel_observers_.end())
+    return it->second;
   return nullptr;
 }
 
@@ -136,23 +765,81 @@ void FlutterRTCDataChannelObserver::OnStateChange(RTCDataChannelState state) {
   params[EncodableValue("id")] = EncodableValue(data_channel_->id());
   params[EncodableValue("state")] = EncodableValue(DataStateString(state));
   auto data = EncodableValue(params);
+  // Messages received before the state change must reach Dart first.
+  std::lock_guard<std::mutex> lock(receive_mutex_);
+  FlushReceiveBatch();
   event_channel_->Success(data);
 }
 
 void FlutterRTCDataChannelObserver::OnMessage(const char* buffer,
                                               int length,
                                               bool binary) {
+  if (binary && WriteToFileSink(buffer, length))
+    return;
+
+  // Build the payload once, straight from the SCTP buffer, and move it all
+  // the way into the event sink.
+  EncodableValue data;
+  if (binary) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(buffer);
+    data = EncodableValue(std::vector<uint8_t>(bytes, bytes + length));
+  } else {
+    data = EncodableValue(std::string(buffer, length));
+  }
+
+  std::lock_guard<std::mutex> lock(receive_mutex_);
+  if (receive_batch_max_messages_ > 1) {
+    bool start_timer = receive_batch_.empty();
+    receive_batch_.push_back(std::move(data));
+    receive_batch_bytes_ += length;
+    if (static_cast<int>(receive_batch_.size()) >=
+            receive_batch_max_messages_ ||
+        receive_batch_bytes_ >= receive_batch_max_bytes_) {
+      FlushReceiveBatch();
+    } else if (start_timer) {
+      receive_timer_.Start(receive_batch_max_delay_, [this]() {
+        std::lock_guard<std::mutex> lock(receive_mutex_);
+        FlushReceiveBatch();
+        return false;
+      });
+    }
+    return;
+  }
+
   EncodableMap params;
   params[EncodableValue("event")] = EncodableValue("dataChannelReceiveMessage");
 
   params[EncodableValue("id")] = EncodableValue(data_channel_->id());
   params[EncodableValue("type")] = EncodableValue(binary ? "binary" : "text");
-  std::string str(buffer, length);
-  params[EncodableValue("data")] =
-      binary ? EncodableValue(std::vector<uint8_t>(str.begin(), str.end()))
-             : EncodableValue(str);
+  params[EncodableValue("data")] = std::move(data);
 
-  auto data = EncodableValue(params);
-  event_channel_->Success(data);
+  event_channel_->Success(EncodableValue(std::move(params)));
+}
+
+void FlutterRTCDataChannelObserver::SetReceiveBatching(
+    int max_messages,
+    uint64_t max_bytes,
+    std::chrono::milliseconds max_delay) {
+  std::lock_guard<std::mutex> lock(receive_mutex_);
+  FlushReceiveBatch();
+  receive_batch_max_messages_ = max_messages;
+  receive_batch_max_bytes_ = max_bytes;
+  receive_batch_max_delay_ = max_delay;
+}
+
+void FlutterRTCDataChannelObserver::FlushReceiveBatch() {
+  if (receive_batch_.empty())
+    return;
+  // Each entry is a String for text messages and a Uint8List for binary
+  // ones, so the list needs no per-message maps.
+  EncodableMap params;
+  params[EncodableValue("event")] =
+      EncodableValue("dataChannelReceiveMessages");
+  params[EncodableValue("id")] = EncodableValue(data_channel_->id());
+  params[EncodableValue("messages")] =
+      EncodableValue(std::move(receive_batch_));
+  receive_batch_ = EncodableList();
+  receive_batch_bytes_ = 0;
+  event_channel_->Success(EncodableValue(std::move(params)));
 }
 }  // namespace flutter_webrtc_plus_plugin
@@ -0,0 +1,437 @@
+#include "flutter_data_channel_benchmark.h"
+
+#include "flutter_data_channel.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <future>
+
+namespace flutter_webrtc_plus_plugin {
+
+namespace {
+
+// Keeps the SCTP buffer busy without letting it grow unbounded; libwebrtc
+// closes a channel whose buffer overflows.
+constexpr uint64_t kBenchmarkHighWatermark = 1024 * 1024;
+constexpr uint64_t kBenchmarkLowWatermark = 256 * 1024;
+
+constexpr std::chrono::milliseconds kCancelPollInterval(50);
+
+int64_t NowNanoseconds() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Stands in for the Dart event channel. Every received message carries its
+// send time in the first eight bytes, so the sink can record end-to-end
+// latency through the observer.
+class CountingEventSink : public EventChannelProxy {
+ public:
+  void Success(const EncodableValue& event, bool cache_event) override {
+    Count(event);
+  }
+
+  void Success(EncodableValue&& event, bool cache_event) override {
+    Count(event);
+  }
+
+  void Reset(size_t expected_messages) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    latencies_.clear();
+    latencies_.reserve(expected_messages);
+    expected_messages_ = expected_messages;
+    events_ = 0;
+    last_receive_ = 0;
+  }
+
+  bool WaitForOpen(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, timeout, [this] { return open_; });
+  }
+
+  // Wakes up every |kCancelPollInterval| to check |cancelled|, so a run
+  // being torn down doesn't sit out the whole timeout.
+  bool WaitForMessages(std::chrono::milliseconds timeout,
+                       const std::atomic<bool>& cancelled) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!cancelled && std::chrono::steady_clock::now() < deadline) {
+      if (cv_.wait_for(lock, kCancelPollInterval, [this] {
+            return latencies_.size() >= expected_messages_;
+          })) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Returns the recorded latencies in nanoseconds, the number of events
+  // delivered and the time the last message arrived.
+  std::vector<int64_t> TakeLatencies(int* events, int64_t* last_receive) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    *events = events_;
+    *last_receive = last_receive_;
+    return std::move(latencies_);
+  }
+
+ private:
+  void Count(const EncodableValue& event) {
+    const EncodableMap& map = GetValue<EncodableMap>(event);
+    const std::string& name = findString(map, "event");
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (name == "dataChannelStateChanged") {
+      open_ = findString(map, "state") == "open";
+      cv_.notify_all();
+    } else if (name == "dataChannelReceiveMessage") {
+      events_++;
+      Record(findEncodableValue(map, "data"));
+    } else if (name == "dataChannelReceiveMessages") {
+      events_++;
+      for (const EncodableValue& data : findList(map, "messages")) {
+        Record(data);
+      }
+    }
+  }
+
+  void Record(const EncodableValue& data) {
+    const auto* bytes = std::get_if<std::vector<uint8_t>>(&data);
+    if (!bytes || bytes->size() < sizeof(int64_t))
+      return;
+    int64_t sent;
+    memcpy(&sent, bytes->data(), sizeof(sent));
+    last_receive_ = NowNanoseconds();
+    latencies_.push_back(last_receive_ - sent);
+    if (latencies_.size() >= expected_messages_)
+      cv_.notify_all();
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool open_ = false;
+  std::vector<int64_t> latencies_;
+  size_t expected_messages_ = 0;
+  int events_ = 0;
+  int64_t last_receive_ = 0;
+};
+
+// Peer connection observer for one end of the loopback pair. Only tracks
+// what the benchmark waits on: ICE gathering and the remote data channel.
+class LoopbackObserver : public RTCPeerConnectionObserver {
+ public:
+  bool WaitForGatheringComplete(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, timeout, [this] { return gathered_; });
+  }
+
+  bool WaitForDataChannel(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, timeout, [this] { return !!receiver_; });
+  }
+
+  void set_receive_batch_size(int size) { receive_batch_size_ = size; }
+
+  CountingEventSink* receiver_sink() { return receiver_sink_; }
+
+  void Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    receiver_.reset();
+  }
+
+  void OnIceGatheringState(RTCIceGatheringState state) override {
+    if (state != RTCIceGatheringStateComplete)
+      return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    gathered_ = true;
+    cv_.notify_all();
+  }
+
+  void OnDataChannel(scoped_refptr<RTCDataChannel> data_channel) override {
+    std::unique_ptr<CountingEventSink> sink(new CountingEventSink());
+    CountingEventSink* sink_ptr = sink.get();
+    std::unique_ptr<FlutterRTCDataChannelObserver> receiver(
+        new FlutterRTCDataChannelObserver(data_channel, std::move(sink)));
+    if (receive_batch_size_ > 1) {
+      receiver->SetReceiveBatching(receive_batch_size_,
+                                   kBenchmarkHighWatermark,
+                                   std::chrono::milliseconds(1));
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    receiver_sink_ = sink_ptr;
+    receiver_ = std::move(receiver);
+    cv_.notify_all();
+  }
+
+  void OnSignalingState(RTCSignalingState state) override {}
+  void OnPeerConnectionState(RTCPeerConnectionState state) override {}
+  void OnIceConnectionState(RTCIceConnectionState state) override {}
+  void OnIceCandidate(scoped_refptr<RTCIceCandidate> candidate) override {}
+  void OnAddStream(scoped_refptr<RTCMediaStream> stream) override {}
+  void OnRemoveStream(scoped_refptr<RTCMediaStream> stream) override {}
+  void OnRenegotiationNeeded() override {}
+  void OnTrack(scoped_refptr<RTCRtpTransceiver> transceiver) override {}
+  void OnAddTrack(vector<scoped_refptr<RTCMediaStream>> streams,
+                  scoped_refptr<RTCRtpReceiver> receiver) override {}
+  void OnRemoveTrack(scoped_refptr<RTCRtpReceiver> receiver) override {}
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool gathered_ = false;
+  int receive_batch_size_ = 0;
+  CountingEventSink* receiver_sink_ = nullptr;
+  std::unique_ptr<FlutterRTCDataChannelObserver> receiver_;
+};
+
+// Completion state shared with libwebrtc callbacks, which may outlive a
+// timed-out wait.
+struct SdpCompletion {
+  std::promise<std::string> error;
+  std::string sdp;
+  std::string type;
+};
+
+bool AwaitSdp(std::shared_ptr<SdpCompletion> completion,
+              std::chrono::milliseconds timeout,
+              const char* step,
+              std::string* error) {
+  std::future<std::string> future = completion->error.get_future();
+  if (future.wait_for(timeout) != std::future_status::ready) {
+    *error = std::string(step) + " timed out";
+    return false;
+  }
+  std::string message = future.get();
+  if (!message.empty()) {
+    *error = std::string(step) + " failed: " + message;
+    return false;
+  }
+  return true;
+}
+
+bool CreateDescription(RTCPeerConnection* pc,
+                       bool offer,
+                       std::chrono::milliseconds timeout,
+                       std::string* sdp,
+                       std::string* type,
+                       std::string* error) {
+  auto completion = std::make_shared<SdpCompletion>();
+  auto on_success = [completion](const libwebrtc::string sdp,
+                                 const libwebrtc::string type) {
+    completion->sdp = sdp.std_string();
+    completion->type = type.std_string();
+    completion->error.set_value(std::string());
+  };
+  auto on_failure = [completion](const char* error) {
+    completion->error.set_value(error ? error : "unknown error");
+  };
+  if (offer) {
+    pc->CreateOffer(on_success, on_failure, RTCMediaConstraints::Create());
+  } else {
+    pc->CreateAnswer(on_success, on_failure, RTCMediaConstraints::Create());
+  }
+  if (!AwaitSdp(completion, timeout, offer ? "createOffer" : "createAnswer",
+                error)) {
+    return false;
+  }
+  *sdp = completion->sdp;
+  *type = completion->type;
+  return true;
+}
+
+bool SetDescription(RTCPeerConnection* pc,
+                    bool local,
+                    const std::string& sdp,
+                    const std::string& type,
+                    std::chrono::milliseconds timeout,
+                    std::string* error) {
+  auto completion = std::make_shared<SdpCompletion>();
+  auto on_success = [completion]() {
+    completion->error.set_value(std::string());
+  };
+  auto on_failure = [completion](const char* error) {
+    completion->error.set_value(error ? error : "unknown error");
+  };
+  if (local) {
+    pc->SetLocalDescription(sdp, type, on_success, on_failure);
+  } else {
+    pc->SetRemoteDescription(sdp, type, on_success, on_failure);
+  }
+  return AwaitSdp(completion, timeout,
+                  local ? "setLocalDescription" : "setRemoteDescription",
+                  error);
+}
+
+// Returns the local description once gathering is complete, so candidates
+// are exchanged inside the SDP and no trickle ICE is needed.
+bool GatheredLocalDescription(RTCPeerConnection* pc,
+                              LoopbackObserver* observer,
+                              std::chrono::milliseconds timeout,
+                              std::string* sdp,
+                              std::string* type,
+                              std::string* error) {
+  if (!observer->WaitForGatheringComplete(timeout)) {
+    *error = "ICE gathering timed out";
+    return false;
+  }
+  auto completion = std::make_shared<SdpCompletion>();
+  pc->GetLocalDescription(
+      [completion](const char* sdp, const char* type) {
+        completion->sdp = sdp;
+        completion->type = type;
+        completion->error.set_value(std::string());
+      },
+      [completion](const char* error) {
+        completion->error.set_value(error ? error : "unknown error");
+      });
+  if (!AwaitSdp(completion, timeout, "getLocalDescription", error))
+    return false;
+  *sdp = completion->sdp;
+  *type = completion->type;
+  return true;
+}
+
+bool Connect(RTCPeerConnection* offerer,
+             LoopbackObserver* offerer_observer,
+             RTCPeerConnection* answerer,
+             LoopbackObserver* answerer_observer,
+             std::chrono::milliseconds timeout,
+             std::string* error) {
+  std::string sdp, type;
+  return CreateDescription(offerer, true, timeout, &sdp, &type, error) &&
+         SetDescription(offerer, true, sdp, type, timeout, error) &&
+         GatheredLocalDescription(offerer, offerer_observer, timeout, &sdp,
+                                  &type, error) &&
+         SetDescription(answerer, false, sdp, type, timeout, error) &&
+         CreateDescription(answerer, false, timeout, &sdp, &type, error) &&
+         SetDescription(answerer, true, sdp, type, timeout, error) &&
+         GatheredLocalDescription(answerer, answerer_observer, timeout, &sdp,
+                                  &type, error) &&
+         SetDescription(offerer, false, sdp, type, timeout, error);
+}
+
+int64_t Percentile(const std::vector<int64_t>& sorted, int percent) {
+  if (sorted.empty())
+    return 0;
+  size_t index = std::min(sorted.size() - 1, sorted.size() * percent / 100);
+  return sorted[index];
+}
+
+EncodableMap RunMessageSize(FlutterRTCDataChannelObserver* sender,
+                            CountingEventSink* receiver_sink,
+                            int message_size,
+                            int messages,
+                            std::chrono::milliseconds timeout,
+                            const std::atomic<bool>& cancelled) {
+  size_t size = std::max<size_t>(message_size, sizeof(int64_t));
+  std::vector<uint8_t> payload(size, 0x5a);
+  receiver_sink->Reset(messages);
+
+  int64_t start = NowNanoseconds();
+  for (int i = 0; i < messages; i++) {
+    int64_t now = NowNanoseconds();
+    memcpy(payload.data(), &now, sizeof(now));
+    sender->Send(payload.data(), payload.size(), true);
+  }
+  bool completed = receiver_sink->WaitForMessages(timeout, cancelled);
+
+  int events = 0;
+  int64_t end = 0;
+  std::vector<int64_t> latencies = receiver_sink->TakeLatencies(&events, &end);
+  std::sort(latencies.begin(), latencies.end());
+  double seconds = (std::max(end, start) - start) / 1e9;
+  double received = static_cast<double>(latencies.size());
+
+  EncodableMap params;
+  params[EncodableValue("messageSize")] =
+      EncodableValue(static_cast<int>(size));
+  params[EncodableValue("messages")] = EncodableValue(messages);
+  params[EncodableValue("received")] =
+      EncodableValue(static_cast<int>(latencies.size()));
+  params[EncodableValue("events")] = EncodableValue(events);
+  params[EncodableValue("timedOut")] = EncodableValue(!completed);
+  params[EncodableValue("seconds")] = EncodableValue(seconds);
+  params[EncodableValue("messagesPerSecond")] =
+      EncodableValue(seconds > 0 ? received / seconds : 0.0);
+  params[EncodableValue("megabytesPerSecond")] =
+      EncodableValue(seconds > 0 ? received * size / seconds / 1e6 : 0.0);
+  params[EncodableValue("p50LatencyUs")] =
+      EncodableValue(Percentile(latencies, 50) / 1000);
+  params[EncodableValue("p99LatencyUs")] =
+      EncodableValue(Percentile(latencies, 99) / 1000);
+  return params;
+}
+
+}  // namespace
+
+void FlutterDataChannelBenchmark::Run(
+    scoped_refptr<RTCPeerConnectionFactory> factory,
+    const Options& options,
+    const std::atomic<bool>& cancelled,
+    MethodResultProxy* result) {
+  RTCConfiguration configuration;
+  configuration.offer_to_receive_audio = false;
+  configuration.offer_to_receive_video = false;
+  scoped_refptr<RTCPeerConnection> offerer =
+      factory->Create(configuration, RTCMediaConstraints::Create());
+  scoped_refptr<RTCPeerConnection> answerer =
+      factory->Create(configuration, RTCMediaConstraints::Create());
+  LoopbackObserver offerer_observer;
+  LoopbackObserver answerer_observer;
+  answerer_observer.set_receive_batch_size(options.receive_batch_size);
+  offerer->RegisterRTCPeerConnectionObserver(&offerer_observer);
+  answerer->RegisterRTCPeerConnectionObserver(&answerer_observer);
+
+  RTCDataChannelInit init;
+  init.ordered = true;
+  init.reliable = true;
+  std::unique_ptr<CountingEventSink> sender_sink(new CountingEventSink());
+  CountingEventSink* sender_events = sender_sink.get();
+  std::unique_ptr<FlutterRTCDataChannelObserver> sender(
+      new FlutterRTCDataChannelObserver(
+          offerer->CreateDataChannel("benchmark", &init),
+          std::move(sender_sink)));
+  sender->SetSendQueueWatermarks(kBenchmarkHighWatermark,
+                                 kBenchmarkLowWatermark);
+
+  std::string error;
+  if (Connect(offerer.get(), &offerer_observer, answerer.get(),
+              &answerer_observer, options.timeout, &error)) {
+    if (!sender_events->WaitForOpen(options.timeout) ||
+        !answerer_observer.WaitForDataChannel(options.timeout)) {
+      error = "data channel did not open";
+    }
+  }
+
+  EncodableList runs;
+  if (error.empty()) {
+    for (int message_size : options.message_sizes) {
+      if (cancelled)
+        break;
+      runs.push_back(EncodableValue(RunMessageSize(
+          sender.get(), answerer_observer.receiver_sink(), message_size,
+          options.messages_per_size, options.timeout, cancelled)));
+    }
+  }
+
+  sender.reset();
+  answerer_observer.Reset();
+  offerer->DeRegisterRTCPeerConnectionObserver();
+  answerer->DeRegisterRTCPeerConnectionObserver();
+  offerer->Close();
+  answerer->Close();
+  factory->Delete(offerer);
+  factory->Delete(answerer);
+
+  if (cancelled)
+    return;
+  if (!error.empty()) {
+    result->Error("dataChannelBenchmarkFailed", error);
+    return;
+  }
+  EncodableMap params;
+  params[EncodableValue("runs")] = EncodableValue(std::move(runs));
+  result->Success(EncodableValue(params));
+}
+
+}  // namespace flutter_webrtc_plus_plugin
@@ -0,0 +1,174 @@
+#include "flutter_device_registry.h"
+
+#ifdef __linux__
+#include <dirent.h>
+#include <string.h>
+
+#include <algorithm>
+#endif
+
+namespace flutter_webrtc_plus_plugin {
+
+// Device change notifications tend to come in bursts (one per endpoint
+// and role), so the refresh waits for them to settle.
+static constexpr std::chrono::milliseconds kRefreshDelay(100);
+
+#ifdef __linux__
+// Listing /dev is cheap; opening the nodes is what V4L2 enumeration pays.
+static constexpr std::chrono::milliseconds kVideoPollInterval(1000);
+
+static std::vector<std::string> ListVideoNodes() {
+  std::vector<std::string> nodes;
+  if (DIR* dir = opendir("/dev")) {
+    while (struct dirent* entry = readdir(dir)) {
+      if (strncmp(entry->d_name, "video", 5) == 0)
+        nodes.push_back(entry->d_name);
+    }
+    closedir(dir);
+  }
+  std::sort(nodes.begin(), nodes.end());
+  return nodes;
+}
+#else
+// Nothing reports camera hotplug here, so the list just expires.
+static constexpr std::chrono::seconds kListTtl(3);
+#endif
+
+DeviceRegistry::DeviceRegistry(scoped_refptr<RTCAudioDevice> audio_device,
+                               scoped_refptr<RTCVideoDevice> video_device,
+                               std::function<void()> on_changed)
+    : audio_device_(audio_device),
+      video_device_(video_device),
+      on_changed_(std::move(on_changed)) {
+#ifdef __linux__
+  video_nodes_ = ListVideoNodes();
+  video_watch_timer_.Start(kVideoPollInterval,
+                           [this]() { return PollVideoNodes(); });
+#endif
+}
+
+DeviceRegistry::~DeviceRegistry() {
+  refresh_timer_.Stop();
+#ifdef __linux__
+  video_watch_timer_.Stop();
+#endif
+}
+
+std::shared_ptr<const DeviceRegistry::Snapshot> DeviceRegistry::Get() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool fresh = snapshot_ && snapshot_generation_ == generation_;
+#ifndef __linux__
+    fresh = fresh &&
+            std::chrono::steady_clock::now() - snapshot_->enumerated_at <
+                kListTtl;
+#endif
+    if (fresh)
+      return snapshot_;
+  }
+  return Refresh();
+}
+
+bool DeviceRegistry::FindRecording(const std::string& guid, Device* device) {
+  return Find(&Snapshot::recording, &Snapshot::recording_by_guid, guid,
+              device);
+}
+
+bool DeviceRegistry::FindPlayout(const std::string& guid, Device* device) {
+  return Find(&Snapshot::playout, &Snapshot::playout_by_guid, guid, device);
+}
+
+bool DeviceRegistry::FindVideo(const std::string& guid, Device* device) {
+  return Find(&Snapshot::video, &Snapshot::video_by_guid, guid, device);
+}
+
+void DeviceRegistry::DevicesChanged() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    generation_++;
+  }
+  refresh_timer_.Start(kRefreshDelay, [this]() {
+    Refresh();
+    if (on_changed_)
+      on_changed_();
+    return false;
+  });
+}
+
+bool DeviceRegistry::Find(List list,
+                          Index index,
+                          const std::string& guid,
+                          Device* device) {
+  if (guid.empty())
+    return false;
+  std::shared_ptr<const Snapshot> snapshot = Get();
+  auto it = ((*snapshot).*index).find(guid);
+  if (it == ((*snapshot).*index).end()) {
+    snapshot = Refresh();
+    it = ((*snapshot).*index).find(guid);
+    if (it == ((*snapshot).*index).end())
+      return false;
+  }
+  *device = ((*snapshot).*list)[it->second];
+  return true;
+}
+
+std::shared_ptr<const DeviceRegistry::Snapshot> DeviceRegistry::Refresh() {
+  uint64_t generation;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    generation = generation_;
+  }
+  std::shared_ptr<const Snapshot> snapshot = Enumerate();
+  std::lock_guard<std::mutex> lock(mutex_);
+  // A change reported while enumerating leaves the result stale.
+  if (!snapshot_ || generation >= snapshot_generation_) {
+    snapshot_ = snapshot;
+    snapshot_generation_ = generation;
+  }
+  return snapshot;
+}
+
+std::shared_ptr<const DeviceRegistry::Snapshot> DeviceRegistry::Enumerate() {
+  auto snapshot = std::make_shared<Snapshot>();
+  char name[RTCAudioDevice::kAdmMaxDeviceNameSize + 1] = {0};
+  char guid[RTCAudioDevice::kAdmMaxGuidSize + 1] = {0};
+
+  int16_t recording_devices = audio_device_->RecordingDevices();
+  for (uint16_t i = 0; i < recording_devices; i++) {
+    audio_device_->RecordingDeviceName(i, name, guid);
+    snapshot->recording_by_guid.emplace(guid, snapshot->recording.size());
+    snapshot->recording.push_back(Device{i, name, guid});
+  }
+
+  int16_t playout_devices = audio_device_->PlayoutDevices();
+  for (uint16_t i = 0; i < playout_devices; i++) {
+    audio_device_->PlayoutDeviceName(i, name, guid);
+    snapshot->playout_by_guid.emplace(guid, snapshot->playout.size());
+    snapshot->playout.push_back(Device{i, name, guid});
+  }
+
+  uint32_t video_devices = video_device_->NumberOfDevices();
+  for (uint32_t i = 0; i < video_devices; i++) {
+    video_device_->GetDeviceName(i, name, sizeof(name), guid, sizeof(guid));
+    snapshot->video_by_guid.emplace(guid, snapshot->video.size());
+    snapshot->video.push_back(Device{i, name, guid});
+  }
+
+  snapshot->enumerated_at = std::chrono::steady_clock::now();
+  return snapshot;
+}
+
+#ifdef __linux__
+bool DeviceRegistry::PollVideoNodes() {
+  // Only the watch thread touches |video_nodes_| once it has started.
+  std::vector<std::string> nodes = ListVideoNodes();
+  if (nodes != video_nodes_) {
+    video_nodes_ = std::move(nodes);
+    DevicesChanged();
+  }
+  return true;
+}
+#endif
+
+}  // namespace flutter_webrtc_plus_plugin
@@ -47,66 +47,57 @@ void FlutterFrameCryptorObserver::OnFrameCryptionStateChanged(
   event_channel_->Success(EncodableValue(params));
 }
 
+const std::unordered_map<std::string, FlutterFrameCryptor::MethodHandler>&
+FlutterFrameCryptor::FrameCryptorMethodHandlers() {
+  static const std::unordered_map<std::string, MethodHandler> handlers = {
+      {"frameCryptorFactoryCreateFrameCryptor",
+       &FlutterFrameCryptor::FrameCryptorFactoryCreateFrameCryptor},
+      {"frameCryptorSetKeyIndex",
+       &FlutterFrameCryptor::FrameCryptorSetKeyIndex},
+      {"frameCryptorGetKeyIndex",
+       &FlutterFrameCryptor::FrameCryptorGetKeyIndex},
+      {"frameCryptorSetEnabled", &FlutterFrameCryptor::FrameCryptorSetEnabled},
+      {"frameCryptorGetEnabled", &FlutterFrameCryptor::FrameCryptorGetEnabled},
+      {"frameCryptorDispose", &FlutterFrameCryptor::FrameCryptorDispose},
+      {"frameCryptorFactoryCreateKeyProvider",
+       &FlutterFrameCryptor::FrameCryptorFactoryCreateKeyProvider},
+      {"keyProviderSetSharedKey",
+       &FlutterFrameCryptor::KeyProviderSetSharedKey},
+      {"keyProviderRatchetSharedKey",
+       &FlutterFrameCryptor::KeyProviderRatchetSharedKey},
+      {"keyProviderExportSharedKey",
+       &FlutterFrameCryptor::KeyProviderExportSharedKey},
+      {"keyProviderSetKey", &FlutterFrameCryptor::KeyProviderSetKey},
+      {"keyProviderRatchetKey", &FlutterFrameCryptor::KeyProviderRatchetKey},
+      {"keyProviderExportKey", &FlutterFrameCryptor::KeyProviderExportKey},
+      {"keyProviderSetSifTrailer",
+       &FlutterFrameCryptor::KeyProviderSetSifTrailer},
+      {"keyProviderDispose", &FlutterFrameCryptor::KeyProviderDispose},
+  };
+  return handlers;
+}
+
 bool FlutterFrameCryptor::HandleFrameCryptorMethodCall(
     const MethodCallProxy& method_call,
     std::unique_ptr<MethodResultProxy> result,
     std::unique_ptr<MethodResultProxy>* outResult) {
-  const std::string& method_name = method_call.method_name();
+  // Every call that reaches here without arguments is answered, known
+  // method or not, as the dispatcher always has.
   if (!method_call.arguments()) {
     result->Error("Bad Arguments", "Null arguments received");
     return true;
   }
-  const EncodableMap params = GetValue<EncodableMap>(*method_call.arguments());
 
-  if (method_name == "frameCryptorFactoryCreateFrameCryptor") {
-    FrameCryptorFactoryCreateFrameCryptor(params, std::move(result));
-    return true;
-  } else if (method_name == "frameCryptorSetKeyIndex") {
-    FrameCryptorSetKeyIndex(params, std::move(result));
-    return true;
-  } else if (method_name == "frameCryptorGetKeyIndex") {
-    FrameCryptorGetKeyIndex(params, std::move(result));
-    return true;
-  } else if (method_name == "frameCryptorSetEnabled") {
-    FrameCryptorSetEnabled(params, std::move(result));
-    return true;
-  } else if (method_name == "frameCryptorGetEnabled") {
-    FrameCryptorGetEnabled(params, std::move(result));
-    return true;
-  } else if (method_name == "frameCryptorDispose") {
-    FrameCryptorDispose(params, std::move(result));
-    return true;
-  } else if (method_name == "frameCryptorFactoryCreateKeyProvider") {
-    FrameCryptorFactoryCreateKeyProvider(params, std::move(result));
-    return true;
-  } else if (method_name == "keyProviderSetSharedKey") {
-    KeyProviderSetSharedKey(params, std::move(result));
-    return true;
-  } else if (method_name == "keyProviderRatchetSharedKey") {
-    KeyProviderRatchetSharedKey(params, std::move(result));
-    return true;
-  } else if (method_name == "keyProviderExportSharedKey") {
-    KeyProviderExportSharedKey(params, std::move(result));
-    return true;
-  } else if (method_name == "keyProviderSetKey") {
-    KeyProviderSetKey(params, std::move(result));
-    return true;
-  } else if (method_name == "keyProviderRatchetKey") {
-    KeyProviderRatchetKey(params, std::move(result));
-    return true;
-  } else if (method_name == "keyProviderExportKey") {
-    KeyProviderExportKey(params, std::move(result));
-    return true;
-  } else if (method_name == "keyProviderSetSifTrailer") {
-    KeyProviderSetSifTrailer(params, std::move(result));
-    return true;
-  } else if (method_name == "keyProviderDispose") {
-    KeyProviderDispose(params, std::move(result));
-    return true;
+  const auto& handlers = FrameCryptorMethodHandlers();
+  auto it = handlers.find(method_call.method_name());
+  if (it == handlers.end()) {
+    *outResult = std::move(result);
+    return false;
   }
 
-  *outResult = std::move(result);
-  return false;
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  (this->*(it->second))(params, std::move(result));
+  return true;
 }
 
 void FlutterFrameCryptor::FrameCryptorFactoryCreateFrameCryptor(
@@ -126,7 +117,8 @@ void FlutterFrameCryptor::FrameCryptorFactoryCreateFrameCryptor(
     return;
   }
 
-  RTCPeerConnection* pc = base_->PeerConnectionForId(peerConnectionId);
+  scoped_refptr<RTCPeerConnection> pc =
+      base_->PeerConnectionForId(peerConnectionId);
   if (pc == nullptr) {
     result->Error(
         "FrameCryptorFactoryCreateFrameCryptorFailed",
@@ -1,5 +1,10 @@
 #include "flutter_media_stream.h"
 #include "flutter_virtual_background.h"
+#include "task_runner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
 
 #define DEFAULT_WIDTH 1280
 #define DEFAULT_HEIGHT 720
@@ -8,54 +13,195 @@
 namespace flutter_webrtc_plus_plugin {
 
 FlutterMediaStream::FlutterMediaStream(FlutterWebRTCBase* base) : base_(base) {
-  base_->audio_device_->OnDeviceChange([&] {
-    EncodableMap info;
-    info[EncodableValue("event")] = "onDeviceChange";
-    base_->event_channel()->Success(EncodableValue(info), false);
-  });
+  // onDeviceChange is sent once the new device list has been enumerated,
+  // so a getSources call in response sees it.
+  devices_.reset(
+      new DeviceRegistry(base_->audio_device_, base_->video_device_, [this] {
+        camera_capabilities_.Clear();
+        EncodableMap info;
+        info[EncodableValue("event")] = "onDeviceChange";
+        base_->event_channel()->Success(EncodableValue(info), false);
+      }));
+  base_->audio_device_->OnDeviceChange([this] { devices_->DevicesChanged(); });
+}
+
+FlutterMediaStream::~FlutterMediaStream() {
+  // The audio device outlives this object and would otherwise call into
+  // |devices_| after it is gone.
+  base_->audio_device_->OnDeviceChange([] {});
+  // Workers still opening a device use |base_|, |devices_| and
+  // |camera_capabilities_|, so they have to finish before those go.
+  alive_.reset();
+  for (auto& kv : acquisitions_) {
+    for (std::thread& worker : kv.second)
+      worker.join();
+  }
+}
+
+static double ElapsedMs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+static bool WantsMedia(const EncodableMap& constraints, const char* kind) {
+  auto it = constraints.find(EncodableValue(kind));
+  if (it == constraints.end())
+    return false;
+  if (TypeIs<bool>(it->second))
+    return GetValue<bool>(it->second);
+  return TypeIs<EncodableMap>(it->second);
 }
 
 void FlutterMediaStream::GetUserMedia(
     const EncodableMap& constraints,
     std::unique_ptr<MethodResultProxy> result) {
-  std::string uuid = base_->GenerateUUID();
-  scoped_refptr<RTCMediaStream> stream =
-      base_->factory_->CreateStream(uuid.c_str());
-
-  EncodableMap params;
-  params[EncodableValue("streamId")] = EncodableValue(uuid);
+  struct Join {
+    std::mutex mutex;
+    int pending = 0;
+    std::chrono::steady_clock::time_point start;
+    std::string uuid;
+    scoped_refptr<RTCMediaStream> stream;
+    bool audio = false;
+    bool video = false;
+    EncodableMap audio_params;
+    EncodableMap video_params;
+    VideoCapture capture;
+    double audio_ms = 0;
+    double video_ms = 0;
+    std::unique_ptr<MethodResultProxy> result;
+  };
+  auto join = std::make_shared<Join>();
+  join->start = std::chrono::steady_clock::now();
+  join->uuid = base_->GenerateUUID();
+  join->stream = base_->factory_->CreateStream(join->uuid.c_str());
+  join->audio = WantsMedia(constraints, "audio");
+  join->video = WantsMedia(constraints, "video");
+  join->result = std::move(result);
+
+  // Runs on the platform thread: local_streams_ and video_capturers_ are
+  // only ever touched there.
+  std::weak_ptr<bool> alive = alive_;
+  auto finish = [this, alive, join]() {
+    if (alive.expired())
+      return;
+    auto workers = acquisitions_.find(join->uuid);
+    if (workers != acquisitions_.end()) {
+      // Both have queued this task, which is the last thing they do.
+      for (std::thread& worker : workers->second)
+        worker.join();
+      acquisitions_.erase(workers);
+    }
 
-  auto it = constraints.find(EncodableValue("audio"));
-  if (it != constraints.end()) {
-    EncodableValue audio = it->second;
-    if (TypeIs<bool>(audio)) {
-      if (true == GetValue<bool>(audio)) {
-        GetUserAudio(constraints, stream, params);
-      }
-    } else if (TypeIs<EncodableMap>(audio)) {
-      GetUserAudio(constraints, stream, params);
-    } else {
-      params[EncodableValue("audioTracks")] = EncodableValue(EncodableList());
+    const VideoCapture& capture = join->capture;
+    bool audio_failed =
+        join->audio && !join->audio_params.count(EncodableValue("audioTracks"));
+    bool video_failed = join->video && !capture.capturer.get();
+    if (audio_failed || video_failed) {
+      ReleaseUserMedia(join->stream, capture);
+      join->result->Error(
+          "getUserMediaFailed",
+          audio_failed && video_failed
+              ? "Unable to open a microphone or a camera"
+              : (audio_failed ? "Unable to open a microphone"
+                              : "Unable to open a camera"));
+      return;
     }
-  } else {
+
+    EncodableMap params;
+    params[EncodableValue("streamId")] = EncodableValue(join->uuid);
     params[EncodableValue("audioTracks")] = EncodableValue(EncodableList());
+    params[EncodableValue("videoTracks")] = EncodableValue(EncodableList());
+    for (const auto& kv : join->audio_params)
+      params[kv.first] = kv.second;
+    for (const auto& kv : join->video_params)
+      params[kv.first] = kv.second;
+
+    if (capture.capturer.get()) {
+      base_->video_capturers_[capture.track_id] = capture.capturer;
+      virtualBackgroundProcessor_ = capture.processor;
+    }
+    base_->local_streams_[join->uuid] = join->stream;
+
+    EncodableMap timings;
+    if (join->audio)
+      timings[EncodableValue("audioMs")] = EncodableValue(join->audio_ms);
+    if (join->video) {
+      timings[EncodableValue("videoMs")] = EncodableValue(join->video_ms);
+      timings[EncodableValue("videoOpenMs")] = EncodableValue(capture.open_ms);
+      timings[EncodableValue("videoStartCaptureMs")] =
+          EncodableValue(capture.start_capture_ms);
+    }
+    timings[EncodableValue("totalMs")] =
+        EncodableValue(ElapsedMs(join->start));
+    params[EncodableValue("timings")] = EncodableValue(timings);
+    join->result->Success(EncodableValue(params));
+  };
+
+  // Without a task runner there is no way back to the platform thread, so
+  // acquire serially, as before.
+  if (!base_->task_runner_ || (!join->audio && !join->video)) {
+    auto start = std::chrono::steady_clock::now();
+    if (join->audio) {
+      GetUserAudio(constraints, join->stream, join->audio_params);
+      join->audio_ms = ElapsedMs(start);
+    }
+    start = std::chrono::steady_clock::now();
+    if (join->video) {
+      GetUserVideo(constraints, join->stream, join->video_params,
+                   &join->capture);
+      join->video_ms = ElapsedMs(start);
+    }
+    finish();
+    return;
   }
 
-  it = constraints.find(EncodableValue("video"));
-  params[EncodableValue("videoTracks")] = EncodableValue(EncodableList());
-  if (it != constraints.end()) {
-    EncodableValue video = it->second;
-    if (TypeIs<bool>(video)) {
-      if (true == GetValue<bool>(video)) {
-        GetUserVideo(constraints, stream, params);
-      }
-    } else if (TypeIs<EncodableMap>(video)) {
-      GetUserVideo(constraints, stream, params);
+  join->pending = (join->audio ? 1 : 0) + (join->video ? 1 : 0);
+  auto done = [this, join, finish]() {
+    {
+      std::lock_guard<std::mutex> lock(join->mutex);
+      if (--join->pending > 0)
+        return;
     }
+    base_->task_runner_->EnqueueTask(finish);
+  };
+  std::vector<std::thread>& workers = acquisitions_[join->uuid];
+  if (join->audio) {
+    workers.emplace_back([this, join, constraints, done]() {
+      auto start = std::chrono::steady_clock::now();
+      GetUserAudio(constraints, join->stream, join->audio_params);
+      join->audio_ms = ElapsedMs(start);
+      done();
+    });
+  }
+  if (join->video) {
+    workers.emplace_back([this, join, constraints, done]() {
+      auto start = std::chrono::steady_clock::now();
+      GetUserVideo(constraints, join->stream, join->video_params,
+                   &join->capture);
+      join->video_ms = ElapsedMs(start);
+      done();
+    });
   }
+}
 
-  base_->local_streams_[uuid] = stream;
-  result->Success(EncodableValue(params));
+void FlutterMediaStream::ReleaseUserMedia(scoped_refptr<RTCMediaStream> stream,
+                                          const VideoCapture& capture) {
+  vector<scoped_refptr<RTCAudioTrack>> audio_tracks = stream->audio_tracks();
+  for (auto track : audio_tracks.std_vector()) {
+    stream->RemoveTrack(track);
+    base_->RemoveMediaTrackForId(track->id().std_string());
+  }
+
+  vector<scoped_refptr<RTCVideoTrack>> video_tracks = stream->video_tracks();
+  for (auto track : video_tracks.std_vector()) {
+    if (capture.processor)
+      track->RemoveRenderer(capture.processor.get());
+    stream->RemoveTrack(track);
+    base_->RemoveMediaTrackForId(track->id().std_string());
+  }
+  if (capture.capturer.get() && capture.capturer->CaptureStarted())
+    capture.capturer->StopCapture();
 }
 
 void addDefaultAudioConstraints(
@@ -122,33 +268,18 @@ void FlutterMediaStream::GetUserAudio(const EncodableMap& constraints,
   // deviceId
 
   if (enable_audio) {
-    char strRecordingName[256];
-    char strRecordingGuid[256];
-    int playout_devices = base_->audio_device_->PlayoutDevices();
-    int recording_devices = base_->audio_device_->RecordingDevices();
-
-    for (uint16_t i = 0; i < recording_devices; i++) {
-      base_->audio_device_->RecordingDeviceName(i, strRecordingName,
-                                                strRecordingGuid);
-      if (sourceId != "" && sourceId == strRecordingGuid) {
-        base_->audio_device_->SetRecordingDevice(i);
-      }
-    }
-
-    if (sourceId == "") {
-      base_->audio_device_->RecordingDeviceName(0, strRecordingName,
-                                                strRecordingGuid);
-      sourceId = strRecordingGuid;
+    DeviceRegistry::Device device;
+    if (sourceId != "") {
+      if (devices_->FindRecording(sourceId, &device))
+        base_->audio_device_->SetRecordingDevice(device.index);
+    } else {
+      auto devices = devices_->Get();
+      if (!devices->recording.empty())
+        sourceId = devices->recording[0].guid;
     }
 
-    char strPlayoutName[256];
-    char strPlayoutGuid[256];
-    for (uint16_t i = 0; i < playout_devices; i++) {
-      base_->audio_device_->PlayoutDeviceName(i, strPlayoutName,
-                                              strPlayoutGuid);
-      if (deviceId != "" && deviceId == strPlayoutGuid) {
-        base_->audio_device_->SetPlayoutDevice(i);
-      }
+    if (deviceId != "" && devices_->FindPlayout(deviceId, &device)) {
+      base_->audio_device_->SetPlayoutDevice(device.index);
     }
 
     scoped_refptr<RTCAudioSource> source =
@@ -182,7 +313,7 @@ void FlutterMediaStream::GetUserAudio(const EncodableMap& constraints,
     params[EncodableValue("audioTracks")] = EncodableValue(audioTracks);
     stream->AddTrack(track);
 
-    base_->local_tracks_[track->id().std_string()] = track;
+    base_->AddLocalTrack(track);
   }
 }
 
@@ -217,7 +348,8 @@ EncodableValue getConstrainInt(const EncodableMap& constraints,
 
 void FlutterMediaStream::GetUserVideo(const EncodableMap& constraints,
                                       scoped_refptr<RTCMediaStream> stream,
-                                      EncodableMap& params) {
+                                      EncodableMap& params,
+                                      VideoCapture* capture) {
   EncodableMap video_constraints;
   EncodableMap video_mandatory;
   auto it = constraints.find(EncodableValue("video"));
@@ -259,37 +391,57 @@ void FlutterMediaStream::GetUserVideo(const EncodableMap& constraints,
     fpsValue = findEncodableValue(video_mandatory, "frameRate");
 
   scoped_refptr<RTCVideoCapturer> video_capturer;
-  char strNameUTF8[256];
-  char strGuidUTF8[256];
-  int nb_video_devices = base_->video_device_->NumberOfDevices();
-
-  int32_t width = toInt(widthValue, DEFAULT_WIDTH);
-  int32_t height = toInt(heightValue, DEFAULT_HEIGHT);
-  int32_t fps = toInt(fpsValue, DEFAULT_FPS);
-
-  for (int i = 0; i < nb_video_devices; i++) {
-    base_->video_device_->GetDeviceName(i, strNameUTF8, 256, strGuidUTF8, 256);
-    if (sourceId != "" && sourceId == strGuidUTF8) {
-      video_capturer =
-          base_->video_device_->Create(strNameUTF8, i, width, height, fps);
-      break;
+
+  const int32_t requested_width = toInt(widthValue, DEFAULT_WIDTH);
+  const int32_t requested_height = toInt(heightValue, DEFAULT_HEIGHT);
+  const int32_t requested_fps = toInt(fpsValue, DEFAULT_FPS);
+  int32_t width = requested_width;
+  int32_t height = requested_height;
+  int32_t fps = requested_fps;
+  std::string pixel_format;
+
+  // Asks for a mode the camera has, so libwebrtc's closest-capability
+  // match can't fall back to a slow raw format at the requested size.
+  auto open = [&](const DeviceRegistry::Device& device) {
+    CameraCapabilities::Mode mode;
+    if (CameraCapabilities::Choose(
+            *camera_capabilities_.ModesFor(device.guid), requested_width,
+            requested_height, requested_fps, &mode)) {
+      width = mode.width;
+      height = mode.height;
+      fps = std::min(requested_fps, mode.fps);
+      pixel_format = mode.pixel_format;
     }
+    return base_->video_device_->Create(device.name.c_str(), device.index,
+                                        width, height, fps);
+  };
+
+  auto open_start = std::chrono::steady_clock::now();
+  DeviceRegistry::Device device;
+  if (devices_->FindVideo(sourceId, &device)) {
+    video_capturer = open(device);
   }
 
-  if (nb_video_devices == 0)
-    return;
-
   if (!video_capturer.get()) {
-    base_->video_device_->GetDeviceName(0, strNameUTF8, 128, strGuidUTF8, 128);
-    sourceId = strGuidUTF8;
-    video_capturer =
-        base_->video_device_->Create(strNameUTF8, 0, width, height, fps);
+    auto devices = devices_->Get();
+    if (devices->video.empty())
+      return;
+    device = devices->video[0];
+    sourceId = device.guid;
+    width = requested_width;
+    height = requested_height;
+    fps = requested_fps;
+    pixel_format.clear();
+    video_capturer = open(device);
   }
 
   if (!video_capturer.get())
     return;
+  capture->open_ms = ElapsedMs(open_start);
 
+  auto start_capture_start = std::chrono::steady_clock::now();
   video_capturer->StartCapture();
+  capture->start_capture_ms = ElapsedMs(start_capture_start);
 
   const char* video_source_label = "video_input";
   scoped_refptr<RTCVideoSource> source = base_->factory_->CreateVideoSource(
@@ -300,11 +452,11 @@ void FlutterMediaStream::GetUserVideo(const EncodableMap& constraints,
   scoped_refptr<RTCVideoTrack> track =
       base_->factory_->CreateVideoTrack(source, uuid.c_str());
 
-  virtualBackgroundProcessor_ = std::make_shared<FlutterVirtualBackground>(track.get());
+  capture->processor = std::make_shared<FlutterVirtualBackground>(track.get());
 
   std::cout << "Virtual background processor created." << std::endl;
 
-  track->AddRenderer(virtualBackgroundProcessor_.get());
+  track->AddRenderer(capture->processor.get());
   std::cout << "Renderer added to track." << std::endl;
 
   EncodableList videoTracks;
@@ -320,6 +472,12 @@ void FlutterMediaStream::GetUserVideo(const EncodableMap& constraints,
   settings[EncodableValue("width")] = EncodableValue(width);
   settings[EncodableValue("height")] = EncodableValue(height);
   settings[EncodableValue("frameRate")] = EncodableValue(fps);
+  // Only the format of the mode that was asked for: libwebrtc picks the
+  // capability itself, so the camera may be delivering another one.
+  if (!pixel_format.empty()) {
+    settings[EncodableValue("requestedPixelFormat")] =
+        EncodableValue(pixel_format);
+  }
   info[EncodableValue("settings")] = EncodableValue(settings);
 
   videoTracks.push_back(EncodableValue(info));
@@ -327,48 +485,38 @@ void FlutterMediaStream::GetUserVideo(const EncodableMap& constraints,
 
   stream->AddTrack(track);
 
-  base_->local_tracks_[track->id().std_string()] = track;
-  base_->video_capturers_[track->id().std_string()] = video_capturer;
+  base_->AddLocalTrack(track);
+  capture->track_id = track->id().std_string();
+  capture->capturer = video_capturer;
 }
 
 void FlutterMediaStream::GetSources(std::unique_ptr<MethodResultProxy> result) {
   EncodableList sources;
+  auto devices = devices_->Get();
 
-  int nb_audio_devices = base_->audio_device_->RecordingDevices();
-  char strNameUTF8[RTCAudioDevice::kAdmMaxDeviceNameSize + 1] = {0};
-  char strGuidUTF8[RTCAudioDevice::kAdmMaxGuidSize + 1] = {0};
-
-  for (uint16_t i = 0; i < nb_audio_devices; i++) {
-    base_->audio_device_->RecordingDeviceName(i, strNameUTF8, strGuidUTF8);
+  for (const DeviceRegistry::Device& device : devices->recording) {
     EncodableMap audio;
-    audio[EncodableValue("label")] = EncodableValue(std::string(strNameUTF8));
-    audio[EncodableValue("deviceId")] =
-        EncodableValue(std::string(strGuidUTF8));
+    audio[EncodableValue("label")] = EncodableValue(device.name);
+    audio[EncodableValue("deviceId")] = EncodableValue(device.guid);
     audio[EncodableValue("facing")] = "";
     audio[EncodableValue("kind")] = "audioinput";
     sources.push_back(EncodableValue(audio));
   }
 
-  nb_audio_devices = base_->audio_device_->PlayoutDevices();
-  for (uint16_t i = 0; i < nb_audio_devices; i++) {
-    base_->audio_device_->PlayoutDeviceName(i, strNameUTF8, strGuidUTF8);
+  for (const DeviceRegistry::Device& device : devices->playout) {
     EncodableMap audio;
-    audio[EncodableValue("label")] = EncodableValue(std::string(strNameUTF8));
-    audio[EncodableValue("deviceId")] =
-        EncodableValue(std::string(strGuidUTF8));
+    audio[EncodableValue("label")] = EncodableValue(device.name);
+    audio[EncodableValue("deviceId")] = EncodableValue(device.guid);
     audio[EncodableValue("facing")] = "";
     audio[EncodableValue("kind")] = "audiooutput";
     sources.push_back(EncodableValue(audio));
   }
 
-  int nb_video_devices = base_->video_device_->NumberOfDevices();
-  for (int i = 0; i < nb_video_devices; i++) {
-    base_->video_device_->GetDeviceName(i, strNameUTF8, 128, strGuidUTF8, 128);
+  for (const DeviceRegistry::Device& device : devices->video) {
     EncodableMap video;
-    video[EncodableValue("label")] = EncodableValue(std::string(strNameUTF8));
-    video[EncodableValue("deviceId")] =
-        EncodableValue(std::string(strGuidUTF8));
-    video[EncodableValue("facing")] = i == 1 ? "front" : "back";
+    video[EncodableValue("label")] = EncodableValue(device.name);
+    video[EncodableValue("deviceId")] = EncodableValue(device.guid);
+    video[EncodableValue("facing")] = device.index == 1 ? "front" : "back";
     video[EncodableValue("kind")] = "videoinput";
     sources.push_back(EncodableValue(video));
   }
@@ -380,45 +528,24 @@ void FlutterMediaStream::GetSources(std::unique_ptr<MethodResultProxy> result) {
 void FlutterMediaStream::SelectAudioOutput(
     const std::string& device_id,
     std::unique_ptr<MethodResultProxy> result) {
-  char strPlayoutName[256];
-  char strPlayoutGuid[256];
-  int playout_devices = base_->audio_device_->PlayoutDevices();
-  bool found = false;
-  for (uint16_t i = 0; i < playout_devices; i++) {
-    base_->audio_device_->PlayoutDeviceName(i, strPlayoutName, strPlayoutGuid);
-    if (device_id != "" && device_id == strPlayoutGuid) {
-      base_->audio_device_->SetPlayoutDevice(i);
-      found = true;
-      break;
-    }
-  }
-  if (!found) {
+  DeviceRegistry::Device device;
+  if (!devices_->FindPlayout(device_id, &device)) {
     result->Error("Bad Arguments", "Not found device id: " + device_id);
     return;
   }
+  base_->audio_device_->SetPlayoutDevice(device.index);
   result->Success();
 }
 
 void FlutterMediaStream::SelectAudioInput(
     const std::string& device_id,
     std::unique_ptr<MethodResultProxy> result) {
-  char strPlayoutName[256];
-  char strPlayoutGuid[256];
-  int playout_devices = base_->audio_device_->RecordingDevices();
-  bool found = false;
-  for (uint16_t i = 0; i < playout_devices; i++) {
-    base_->audio_device_->RecordingDeviceName(i, strPlayoutName,
-                                              strPlayoutGuid);
-    if (device_id != "" && device_id == strPlayoutGuid) {
-      base_->audio_device_->SetRecordingDevice(i);
-      found = true;
-      break;
-    }
-  }
-  if (!found) {
+  DeviceRegistry::Device device;
+  if (!devices_->FindRecording(device_id, &device)) {
     result->Error("Bad Arguments", "Not found device id: " + device_id);
     return;
   }
+  base_->audio_device_->SetRecordingDevice(device.index);
   result->Success();
 }
 
@@ -433,7 +560,7 @@ void FlutterMediaStream::MediaStreamGetTracks(
 
     auto audio_tracks = stream->audio_tracks();
     for (auto track : audio_tracks.std_vector()) {
-      base_->local_tracks_[track->id().std_string()] = track;
+      base_->AddLocalTrack(track);
       EncodableMap info;
       info[EncodableValue("id")] = EncodableValue(track->id().std_string());
       info[EncodableValue("label")] = EncodableValue(track->id().std_string());
@@ -448,7 +575,7 @@ void FlutterMediaStream::MediaStreamGetTracks(
     EncodableList videoTracks;
     auto video_tracks = stream->video_tracks();
     for (auto track : video_tracks.std_vector()) {
-      base_->local_tracks_[track->id().std_string()] = track;
+      base_->AddLocalTrack(track);
       EncodableMap info;
       info[EncodableValue("id")] = EncodableValue(track->id().std_string());
       info[EncodableValue("label")] = EncodableValue(track->id().std_string());
@@ -483,13 +610,13 @@ void FlutterMediaStream::MediaStreamDispose(
 
   for (auto track : audio_tracks.std_vector()) {
     stream->RemoveTrack(track);
-    base_->local_tracks_.erase(track->id().std_string());
+    base_->RemoveMediaTrackForId(track->id().std_string());
   }
 
   vector<scoped_refptr<RTCVideoTrack>> video_tracks = stream->video_tracks();
   for (auto track : video_tracks.std_vector()) {
     stream->RemoveTrack(track);
-    base_->local_tracks_.erase(track->id().std_string());
+    base_->RemoveMediaTrackForId(track->id().std_string());
     if (base_->video_capturers_.find(track->id().std_string()) !=
         base_->video_capturers_.end()) {
       auto video_capture = base_->video_capturers_[track->id().std_string()];
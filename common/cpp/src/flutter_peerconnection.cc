@@ -321,18 +321,28 @@ void FlutterPeerConnection::CreateRTCPeerConnection(
     const EncodableMap& configurationMap,
     const EncodableMap& constraintsMap,
     std::unique_ptr<MethodResultProxy> result) {
-  // std::cout << " configuration = " << configurationMap.StringValue() <<
-  // std::endl;
-  base_->ParseRTCConfiguration(configurationMap, base_->configuration_);
-  // std::cout << " constraints = " << constraintsMap.StringValue() <<
-  // std::endl;
-  scoped_refptr<RTCMediaConstraints> constraints =
-      base_->ParseMediaConstraints(constraintsMap);
+  scoped_refptr<RTCPeerConnection> pc;
+  RTCConfiguration pc_configuration;
+  EncodableList dropped_ice_servers;
+  PeerConnectionPool::Warm warm;
+  if (pool_ && pool_->Take(configurationMap, constraintsMap, &warm)) {
+    pc = warm.pc;
+    pc_configuration = warm.configuration;
+    dropped_ice_servers = std::move(warm.dropped_ice_servers);
+  } else {
+    // std::cout << " configuration = " << configurationMap.StringValue() <<
+    // std::endl;
+    base_->ParseRTCConfiguration(configurationMap, base_->configuration_,
+                                 &dropped_ice_servers);
+    // std::cout << " constraints = " << constraintsMap.StringValue() <<
+    // std::endl;
+    scoped_refptr<RTCMediaConstraints> constraints =
+        base_->ParseMediaConstraints(constraintsMap);
+    pc = base_->factory_->Create(base_->configuration_, constraints);
+    pc_configuration = base_->configuration_;
+  }
 
   std::string uuid = base_->GenerateUUID();
-  scoped_refptr<RTCPeerConnection> pc =
-      base_->factory_->Create(base_->configuration_, constraints);
-  base_->peerconnections_[uuid] = pc;
 
   std::string event_channel = "FlutterWebRTC/peerConnectionEvent" + uuid;
 
@@ -340,27 +350,140 @@ void FlutterPeerConnection::CreateRTCPeerConnection(
       new FlutterPeerConnectionObserver(base_, pc, base_->messenger_,
                                         base_->task_runner_,
                                         event_channel, uuid));
+  observer->set_configuration(pc_configuration);
 
-  base_->peerconnection_observers_[uuid] = std::move(observer);
+  {
+    std::unique_lock<std::shared_mutex> lock(base_->peerconnections_mutex_);
+    base_->peerconnections_[uuid] = pc;
+    base_->peerconnection_observers_[uuid] = std::move(observer);
+    base_->rtp_indexes_[pc.get()] = std::make_shared<RtpObjectIndex>();
+  }
 
   EncodableMap params;
   params[EncodableValue("peerConnectionId")] = EncodableValue(uuid);
+  if (!dropped_ice_servers.empty()) {
+    params[EncodableValue("droppedIceServers")] =
+        EncodableValue(std::move(dropped_ice_servers));
+  }
   result->Success(EncodableValue(params));
 }
 
+FlutterPeerConnection::~FlutterPeerConnection() {
+  benchmark_cancelled_ = true;
+  if (benchmark_thread_.joinable())
+    benchmark_thread_.join();
+}
+
+PeerConnectionPool::Factory FlutterPeerConnection::PoolFactory() {
+  FlutterWebRTCBase* base = base_;
+  // Runs on the refill and benchmark threads, so it parses into its own
+  // RTCConfiguration rather than the shared base_->configuration_.
+  return [base](const EncodableMap& configuration,
+                const EncodableMap& constraints, int ice_candidate_pool_size) {
+    PeerConnectionPool::Warm warm;
+    base->ParseRTCConfiguration(configuration, warm.configuration,
+                                &warm.dropped_ice_servers);
+    if (ice_candidate_pool_size >= 0 &&
+        configuration.find(EncodableValue("iceCandidatePoolSize")) ==
+            configuration.end()) {
+      warm.configuration.ice_candidate_pool_size = ice_candidate_pool_size;
+    }
+    warm.pc = base->factory_->Create(warm.configuration,
+                                     base->ParseMediaConstraints(constraints));
+    return warm;
+  };
+}
+
+// Upper bound on warm connections per configuration; each one holds
+// sockets and, with iceCandidatePoolSize, live TURN allocations.
+static constexpr int kMaxPeerConnectionPoolSize = 8;
+
+void FlutterPeerConnection::ConfigurePeerConnectionPool(
+    const EncodableMap& params,
+    std::unique_ptr<MethodResultProxy> result) {
+  int size = findInt(params, "size");
+  if (size < 0 || size > kMaxPeerConnectionPoolSize) {
+    result->Error("configurePeerConnectionPoolFailed",
+                  "size must be between 0 and " +
+                      std::to_string(kMaxPeerConnectionPoolSize));
+    return;
+  }
+  if (!pool_) {
+    if (size == 0) {
+      result->Success();
+      return;
+    }
+    pool_.reset(new PeerConnectionPool(PoolFactory()));
+  }
+  pool_->Configure(findMap(params, "configuration"),
+                   findMap(params, "constraints"), size,
+                   findInt(params, "iceCandidatePoolSize"));
+  result->Success();
+}
+
+void FlutterPeerConnection::PeerConnectionPoolStats(
+    std::unique_ptr<MethodResultProxy> result) {
+  result->Success(EncodableValue(pool_ ? pool_->Stats() : EncodableMap()));
+}
+
+void FlutterPeerConnection::PeerConnectionPoolBenchmark(
+    const EncodableMap& params,
+    std::unique_ptr<MethodResultProxy> result) {
+  int iterations = findInt(params, "iterations");
+  if (iterations <= 0 || iterations > kMaxPeerConnectionPoolSize) {
+    result->Error("peerConnectionPoolBenchmarkFailed",
+                  "iterations must be between 1 and " +
+                      std::to_string(kMaxPeerConnectionPoolSize));
+    return;
+  }
+  if (benchmark_running_) {
+    result->Error("peerConnectionPoolBenchmarkFailed",
+                  "A benchmark is already running");
+    return;
+  }
+  // The previous run has finished, so this doesn't block.
+  if (benchmark_thread_.joinable())
+    benchmark_thread_.join();
+  benchmark_running_ = true;
+  std::shared_ptr<MethodResultProxy> result_ptr(result.release());
+  benchmark_thread_ = std::thread(
+      [this, factory = PoolFactory(),
+       configuration = findMap(params, "configuration"),
+       constraints = findMap(params, "constraints"), iterations,
+       pool_size = findInt(params, "iceCandidatePoolSize"), result_ptr]() {
+        PeerConnectionPool::Benchmark(factory, configuration, constraints,
+                                      iterations, pool_size,
+                                      benchmark_cancelled_, result_ptr.get());
+        benchmark_running_ = false;
+      });
+}
+
 void FlutterPeerConnection::RTCPeerConnectionClose(
     RTCPeerConnection* pc,
     const std::string& uuid,
     std::unique_ptr<MethodResultProxy> result) {
-  auto it2 = base_->peerconnections_.find(uuid);
-  if (it2 != base_->peerconnections_.end()) {
-    it2->second->Close();
-    base_->peerconnections_.erase(it2);
+  scoped_refptr<RTCPeerConnection> peerconnection;
+  std::shared_ptr<FlutterPeerConnectionObserver> observer;
+  {
+    std::unique_lock<std::shared_mutex> lock(base_->peerconnections_mutex_);
+    auto it2 = base_->peerconnections_.find(uuid);
+    if (it2 != base_->peerconnections_.end()) {
+      peerconnection = it2->second;
+      base_->peerconnections_.erase(it2);
+      base_->rtp_indexes_.erase(peerconnection.get());
+    }
+
+    auto it = base_->peerconnection_observers_.find(uuid);
+    if (it != base_->peerconnection_observers_.end()) {
+      observer = std::move(it->second);
+      base_->peerconnection_observers_.erase(it);
+    }
   }
 
-  auto it = base_->peerconnection_observers_.find(uuid);
-  if (it != base_->peerconnection_observers_.end())
-    base_->peerconnection_observers_.erase(it);
+  // Close() fires state callbacks synchronously, so it must run after the
+  // registry lock is released.
+  if (peerconnection.get())
+    peerconnection->Close();
 
   result->Success();
 }
@@ -417,8 +540,15 @@ void FlutterPeerConnection::SetLocalDescription(
     RTCPeerConnection* pc,
     std::unique_ptr<MethodResultProxy> result) {
   std::shared_ptr<MethodResultProxy> result_ptr(result.release());
+  std::shared_ptr<RtpObjectIndex> index = base_->RtpIndexFor(pc);
   pc->SetLocalDescription(
-      sdp->sdp(), sdp->type(), [result_ptr]() { result_ptr->Success(); },
+      sdp->sdp(), sdp->type(),
+      [result_ptr, index]() {
+        // The description may have added transceivers behind our back.
+        if (index)
+          index->Clear();
+        result_ptr->Success();
+      },
       [result_ptr](const char* error) {
         result_ptr->Error("setLocalDescriptionFailed", error);
       });
@@ -429,8 +559,14 @@ void FlutterPeerConnection::SetRemoteDescription(
     RTCPeerConnection* pc,
     std::unique_ptr<MethodResultProxy> result) {
   std::shared_ptr<MethodResultProxy> result_ptr(result.release());
+  std::shared_ptr<RtpObjectIndex> index = base_->RtpIndexFor(pc);
   pc->SetRemoteDescription(
-      sdp->sdp(), sdp->type(), [result_ptr]() { result_ptr->Success(); },
+      sdp->sdp(), sdp->type(),
+      [result_ptr, index]() {
+        if (index)
+          index->Clear();
+        result_ptr->Success();
+      },
       [result_ptr](const char* error) {
         result_ptr->Error("setRemoteDescriptionFailed", error);
       });
@@ -470,21 +606,21 @@ void FlutterPeerConnection::GetRemoteDescription(
 
 scoped_refptr<RTCRtpTransceiverInit>
 FlutterPeerConnection::mapToRtpTransceiverInit(const EncodableMap& params) {
-  EncodableList streamIds = findList(params, "streamIds");
+  const EncodableList& streamIds = findList(params, "streamIds");
 
   std::vector<string> stream_ids;
-  for (auto item : streamIds) {
-    std::string id = GetValue<std::string>(item);
-    stream_ids.push_back(id.c_str());
+  for (const EncodableValue& item : streamIds) {
+    stream_ids.push_back(GetValue<std::string>(item).c_str());
   }
   RTCRtpTransceiverDirection dir = RTCRtpTransceiverDirection::kInactive;
-  EncodableValue direction = findEncodableValue(params, "direction");
-  if (!direction.IsNull()) {
-    dir = stringToTransceiverDirection(GetValue<std::string>(direction));
+  const std::string* direction = findPtr<std::string>(params, "direction");
+  if (direction) {
+    dir = stringToTransceiverDirection(*direction);
   }
-  EncodableList sendEncodings = findList(params, "sendEncodings");
+  const EncodableList& sendEncodings = findList(params, "sendEncodings");
   std::vector<scoped_refptr<RTCRtpEncodingParameters>> encodings;
-  for (EncodableValue value : sendEncodings) {
+  encodings.reserve(sendEncodings.size());
+  for (const EncodableValue& value : sendEncodings) {
     encodings.push_back(mapToEncoding(GetValue<EncodableMap>(value)));
   }
   scoped_refptr<RTCRtpTransceiverInit> init =
@@ -584,7 +720,7 @@ void FlutterPeerConnection::AddTransceiver(
     std::unique_ptr<MethodResultProxy> result) {
   std::shared_ptr<MethodResultProxy> result_ptr(result.release());
 
-  RTCMediaTrack* track = base_->MediaTrackForId(trackId);
+  scoped_refptr<RTCMediaTrack> track = base_->MediaTracksForId(trackId);
   RTCMediaType type = stringToMediaType(mediaType);
 
   if (0 < transceiverInit.size()) {
@@ -594,6 +730,8 @@ void FlutterPeerConnection::AddTransceiver(
                          : pc->AddTransceiver(
                                type, mapToRtpTransceiverInit(transceiverInit));
     if (nullptr != transceiver.get()) {
+      if (auto index = base_->RtpIndexFor(pc))
+        index->AddTransceiver(transceiver);
       result_ptr->Success(EncodableValue(transceiverToMap(transceiver)));
       return;
     }
@@ -603,6 +741,8 @@ void FlutterPeerConnection::AddTransceiver(
     auto transceiver =
         track != nullptr ? pc->AddTransceiver(track) : pc->AddTransceiver(type);
     if (nullptr != transceiver.get()) {
+      if (auto index = base_->RtpIndexFor(pc))
+        index->AddTransceiver(transceiver);
       result_ptr->Success(EncodableValue(transceiverToMap(transceiver)));
       return;
     }
@@ -626,6 +766,22 @@ void FlutterPeerConnection::GetTransceivers(
   result_ptr->Success(EncodableValue(map));
 }
 
+void FlutterPeerConnection::GetTransceiverChanges(
+    RTCPeerConnection* pc,
+    FlutterPeerConnectionObserver* observer,
+    int64_t since_version,
+    std::unique_ptr<MethodResultProxy> result) {
+  std::vector<std::pair<std::string, EncodableMap>> current;
+  auto transceivers = pc->transceivers();
+  for (scoped_refptr<RTCRtpTransceiver> transceiver :
+       transceivers.std_vector()) {
+    current.emplace_back(transceiver->transceiver_id().std_string(),
+                         transceiverToMap(transceiver));
+  }
+  result->Success(EncodableValue(
+      observer->transceiver_states()->Update(current, since_version)));
+}
+
 void FlutterPeerConnection::GetReceivers(
     RTCPeerConnection* pc,
     std::unique_ptr<MethodResultProxy> result) {
@@ -652,6 +808,9 @@ void FlutterPeerConnection::RtpSenderSetTrack(
     return;
   }
   sender->set_track(track);
+  // Re-index under the new track id; the old one now misses.
+  if (auto index = base_->RtpIndexFor(pc))
+    index->AddSender(sender);
   result_ptr->Success();
 }
 
@@ -683,19 +842,21 @@ void FlutterPeerConnection::RtpSenderReplaceTrack(
   }
 
   sender->set_track(track);
+  if (auto index = base_->RtpIndexFor(pc))
+    index->AddSender(sender);
 
   result_ptr->Success();
 }
 
 scoped_refptr<RTCRtpParameters> FlutterPeerConnection::updateRtpParameters(
-    EncodableMap newParameters,
+    const EncodableMap& newParameters,
     scoped_refptr<RTCRtpParameters> parameters) {
-  EncodableList encodings = findList(newParameters, "encodings");
+  const EncodableList& encodings = findList(newParameters, "encodings");
   auto encoding = encodings.begin();
   auto params = parameters->encodings();
   for (auto param : params.std_vector()) {
     if (encoding != encodings.end()) {
-      EncodableMap map = GetValue<EncodableMap>(*encoding);
+      const EncodableMap& map = GetValue<EncodableMap>(*encoding);
       EncodableValue value = findEncodableValue(map, "active");
       if (!value.IsNull()) {
         param->set_active(GetValue<bool>(value));
@@ -815,15 +976,67 @@ void FlutterPeerConnection::RtpTransceiverGetCurrentDirection(
   result_ptr->Success(EncodableValue(map));
 }
 
+static bool SameIceServers(const RTCConfiguration& a,
+                           const RTCConfiguration& b) {
+  for (int i = 0; i < kMaxIceServerSize; i++) {
+    const IceServer& x = a.ice_servers[i];
+    const IceServer& y = b.ice_servers[i];
+    if (x.uri.std_string() != y.uri.std_string() ||
+        x.username.std_string() != y.username.std_string() ||
+        x.password.std_string() != y.password.std_string()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void FlutterPeerConnection::SetConfiguration(
     RTCPeerConnection* pc,
+    FlutterPeerConnectionObserver* observer,
     const EncodableMap& configuration,
+    bool ice_restart,
     std::unique_ptr<MethodResultProxy> result) {
-  std::shared_ptr<MethodResultProxy> result_ptr(result.release());
-
-  // TODO pc->SetConfiguration();
+  const RTCConfiguration& current = observer->configuration();
+  // Fields missing from |configuration| keep their current values;
+  // iceServers, when present, is replaced as a whole.
+  RTCConfiguration next = current;
+  EncodableList dropped_ice_servers;
+  base_->ParseRTCConfiguration(configuration, next, &dropped_ice_servers);
+
+  EncodableList changed;
+  if (!SameIceServers(current, next))
+    changed.push_back(EncodableValue("iceServers"));
+  if (current.type != next.type)
+    changed.push_back(EncodableValue("iceTransportPolicy"));
+  if (current.bundle_policy != next.bundle_policy)
+    changed.push_back(EncodableValue("bundlePolicy"));
+  if (current.rtcp_mux_policy != next.rtcp_mux_policy)
+    changed.push_back(EncodableValue("rtcpMuxPolicy"));
+  if (current.ice_candidate_pool_size != next.ice_candidate_pool_size)
+    changed.push_back(EncodableValue("iceCandidatePoolSize"));
+  if (current.sdp_semantics != next.sdp_semantics)
+    changed.push_back(EncodableValue("sdpSemantics"));
+  if (current.max_ipv6_networks != next.max_ipv6_networks)
+    changed.push_back(EncodableValue("maxIPv6Networks"));
+
+  EncodableList applied;
+  if (ice_restart) {
+    pc->RestartIce();
+    applied.push_back(EncodableValue("iceRestart"));
+  }
 
-  result_ptr->Success();
+  // |next| is deliberately not stored back with set_configuration(): none
+  // of the fields above can be changed on a live peer connection, so the
+  // observer keeps the creation-time configuration and later calls keep
+  // reporting the same fields as unsupported.
+  EncodableMap params;
+  params[EncodableValue("applied")] = EncodableValue(applied);
+  params[EncodableValue("unsupported")] = EncodableValue(changed);
+  if (!dropped_ice_servers.empty()) {
+    params[EncodableValue("droppedIceServers")] =
+        EncodableValue(std::move(dropped_ice_servers));
+  }
+  result->Success(EncodableValue(params));
 }
 
 void FlutterPeerConnection::CaptureFrame(
@@ -837,6 +1050,8 @@ void FlutterPeerConnection::CaptureFrame(
 scoped_refptr<RTCRtpTransceiver> FlutterPeerConnection::getRtpTransceiverById(
     RTCPeerConnection* pc,
     std::string id) {
+  if (auto index = base_->RtpIndexFor(pc))
+    return index->TransceiverForId(pc, id);
   scoped_refptr<RTCRtpTransceiver> result;
   auto transceivers = pc->transceivers();
   for (scoped_refptr<RTCRtpTransceiver> transceiver :
@@ -872,7 +1087,7 @@ void FlutterPeerConnection::RtpTransceiverSetDirection(
 void FlutterPeerConnection::RtpTransceiverSetCodecPreferences(
     RTCPeerConnection* pc,
     std::string transceiverId,
-    const EncodableList codecs,
+    const EncodableList& codecs,
     std::unique_ptr<MethodResultProxy> result) {
   std::shared_ptr<MethodResultProxy> result_ptr(result.release());
   auto transceiver = getRtpTransceiverById(pc, transceiverId);
@@ -882,8 +1097,8 @@ void FlutterPeerConnection::RtpTransceiverSetCodecPreferences(
     return;
   }
   std::vector<scoped_refptr<RTCRtpCodecCapability>> codecList;
-  for (auto codec : codecs) {
-    auto codecMap = GetValue<EncodableMap>(codec);
+  for (const EncodableValue& codec : codecs) {
+    const EncodableMap& codecMap = GetValue<EncodableMap>(codec);
     auto codecMimeType = findString(codecMap, "mimeType");
     auto codecClockRate = findInt(codecMap, "clockRate");
     auto codecNumChannels = findInt(codecMap, "channels");
@@ -926,124 +1141,278 @@ void FlutterPeerConnection::AddIceCandidate(
   result->Success();
 }
 
-EncodableMap statsToMap(const scoped_refptr<MediaRTCStats>& stats) {
-  EncodableMap report_map;
-  report_map[EncodableValue("id")] = EncodableValue(stats->id().std_string());
-  report_map[EncodableValue("type")] =
-      EncodableValue(stats->type().std_string());
-  report_map[EncodableValue("timestamp")] =
-      EncodableValue(static_cast<double>(stats->timestamp_us()));
-  EncodableMap values;
-  auto members = stats->Members();
-  for (int i = 0; i < members.size(); i++) {
-    auto member = members[i];
-    switch (member->GetType()) {
-      case RTCStatsMember::Type::kBool:
-        values[EncodableValue(member->GetName().std_string())] =
-            EncodableValue(member->ValueBool());
-        break;
-      case RTCStatsMember::Type::kInt32:
-        values[EncodableValue(member->GetName().std_string())] =
-            EncodableValue(member->ValueInt32());
-        break;
-      case RTCStatsMember::Type::kUint32:
-        values[EncodableValue(member->GetName().std_string())] =
-            EncodableValue((int64_t)member->ValueUint32());
-        break;
-      case RTCStatsMember::Type::kInt64:
-        values[EncodableValue(member->GetName().std_string())] =
-            EncodableValue(member->ValueInt64());
-        break;
-      case RTCStatsMember::Type::kUint64:
-        values[EncodableValue(member->GetName().std_string())] =
-            EncodableValue((int64_t)member->ValueUint64());
-        break;
-      case RTCStatsMember::Type::kDouble:
-        values[EncodableValue(member->GetName().std_string())] =
-            EncodableValue(member->ValueDouble());
-        break;
-      case RTCStatsMember::Type::kString:
-        values[EncodableValue(member->GetName().std_string())] =
-            EncodableValue(member->ValueString().std_string());
-        break;
-      default:
-        break;
+void FlutterPeerConnection::AddIceCandidates(
+    const EncodableList& candidates,
+    RTCPeerConnection* pc,
+    std::unique_ptr<MethodResultProxy> result) {
+  int added = 0;
+  EncodableList failed;
+  for (size_t i = 0; i < candidates.size(); i++) {
+    const EncodableMap* map = std::get_if<EncodableMap>(&candidates[i]);
+    if (!map) {
+      failed.push_back(EncodableValue(static_cast<int>(i)));
+      continue;
     }
+    std::string candidate = findString(*map, "candidate");
+    if (candidate.empty()) {
+      // end-of-candidates
+      continue;
+    }
+    std::string sdp_mid = findString(*map, "sdpMid");
+    int sdp_mline_index = findInt(*map, "sdpMLineIndex");
+    SdpParseError error;
+    scoped_refptr<RTCIceCandidate> rtc_candidate = RTCIceCandidate::Create(
+        candidate.c_str(), sdp_mid.c_str(),
+        sdp_mline_index == -1 ? 0 : sdp_mline_index, &error);
+    if (rtc_candidate.get() == nullptr) {
+      failed.push_back(EncodableValue(static_cast<int>(i)));
+      continue;
+    }
+    pc->AddCandidate(rtc_candidate->sdp_mid(),
+                     rtc_candidate->sdp_mline_index(),
+                     rtc_candidate->candidate());
+    added++;
   }
-  report_map[EncodableValue("values")] = EncodableValue(values);
-  return report_map;
+
+  EncodableMap params;
+  params[EncodableValue("added")] = EncodableValue(added);
+  params[EncodableValue("failed")] = EncodableValue(failed);
+  result->Success(EncodableValue(params));
+}
+
+// Upper bound for peerConnectionSetIceCandidateBatching; candidates held
+// longer than this start to delay connectivity checks on the remote side.
+static constexpr int kMaxIceCandidateBatchDelayMs = 500;
+
+void FlutterPeerConnection::SetIceCandidateBatching(
+    FlutterPeerConnectionObserver* observer,
+    const EncodableMap& params,
+    std::unique_ptr<MethodResultProxy> result) {
+  int max_delay_ms = findInt(params, "maxDelayMs");
+  if (max_delay_ms < 0 || max_delay_ms > kMaxIceCandidateBatchDelayMs) {
+    result->Error("peerConnectionSetIceCandidateBatchingFailed",
+                  "maxDelayMs must be between 0 and " +
+                      std::to_string(kMaxIceCandidateBatchDelayMs));
+    return;
+  }
+  observer->SetIceCandidateBatching(std::chrono::milliseconds(max_delay_ms));
+  result->Success();
 }
 
 void FlutterPeerConnection::GetStats(
     const std::string& track_id,
+    const StatsQuery& query,
     RTCPeerConnection* pc,
     std::unique_ptr<MethodResultProxy> result) {
   std::shared_ptr<MethodResultProxy> result_ptr(result.release());
+  auto query_ptr = std::make_shared<const StatsQuery>(query);
+  auto on_success =
+      [result_ptr,
+       query_ptr](const vector<scoped_refptr<MediaRTCStats>> reports) {
+        result_ptr->Success(
+            EncodableValue(EncodeStatsReports(reports, *query_ptr)));
+      };
+  auto on_failure = [result_ptr](const char* error) {
+    result_ptr->Error("GetStats", error);
+  };
   scoped_refptr<RTCMediaTrack> track = base_->MediaTracksForId(track_id);
   if (track != nullptr && track_id != "") {
-    bool found = false;
+    if (auto index = base_->RtpIndexFor(pc)) {
+      scoped_refptr<RTCRtpReceiver> receiver;
+      scoped_refptr<RTCRtpSender> sender;
+      if (!index->TrackForId(pc, track_id, &receiver, &sender)) {
+        result_ptr->Error("GetStats", "Track not found");
+      } else if (receiver.get() != nullptr) {
+        pc->GetStats(receiver, on_success, on_failure);
+      } else {
+        pc->GetStats(sender, on_success, on_failure);
+      }
+      return;
+    }
     auto receivers = pc->receivers();
     for (auto receiver : receivers.std_vector()) {
       if (receiver->track() && receiver->track()->id().c_string() == track_id) {
-        found = true;
-        pc->GetStats(
-            receiver,
-            [result_ptr](const vector<scoped_refptr<MediaRTCStats>> reports) {
-              EncodableList list;
-              for (int i = 0; i < reports.size(); i++) {
-                list.push_back(EncodableValue(statsToMap(reports[i])));
-              }
-              EncodableMap params;
-              params[EncodableValue("stats")] = EncodableValue(list);
-              result_ptr->Success(EncodableValue(params));
-            },
-            [result_ptr](const char* error) {
-              result_ptr->Error("GetStats", error);
-            });
+        pc->GetStats(receiver, on_success, on_failure);
         return;
       }
     }
     auto senders = pc->senders();
     for (auto sender : senders.std_vector()) {
       if (sender->track() && sender->track()->id().c_string() == track_id) {
-        found = true;
-        pc->GetStats(
-            sender,
-            [result_ptr](const vector<scoped_refptr<MediaRTCStats>> reports) {
-              EncodableList list;
-              for (int i = 0; i < reports.size(); i++) {
-                list.push_back(EncodableValue(statsToMap(reports[i])));
-              }
-              EncodableMap params;
-              params[EncodableValue("stats")] = EncodableValue(list);
-              result_ptr->Success(EncodableValue(params));
-            },
-            [result_ptr](const char* error) {
-              result_ptr->Error("GetStats", error);
-            });
+        pc->GetStats(sender, on_success, on_failure);
         return;
       }
     }
-    if (!found) {
-      result_ptr->Error("GetStats", "Track not found");
-    }
+    result_ptr->Error("GetStats", "Track not found");
   } else {
-    pc->GetStats(
-        [result_ptr](const vector<scoped_refptr<MediaRTCStats>> reports) {
-          EncodableList list;
-          for (int i = 0; i < reports.size(); i++) {
-            list.push_back(EncodableValue(statsToMap(reports[i])));
-          }
-          EncodableMap params;
-          params[EncodableValue("stats")] = EncodableValue(list);
-          result_ptr->Success(EncodableValue(params));
+    pc->GetStats(on_success, on_failure);
+  }
+}
+
+void FlutterPeerConnection::GetStatsForAll(
+    const StatsQuery& query,
+    std::unique_ptr<MethodResultProxy> result) {
+  std::vector<std::pair<std::string, scoped_refptr<RTCPeerConnection>>> pcs;
+  {
+    std::shared_lock<std::shared_mutex> lock(base_->peerconnections_mutex_);
+    pcs.assign(base_->peerconnections_.begin(),
+               base_->peerconnections_.end());
+  }
+
+  struct Join {
+    std::mutex mutex;
+    size_t pending;
+    StatsQuery query;
+    EncodableMap replies;
+    EncodableMap errors;
+    std::unique_ptr<MethodResultProxy> result;
+
+    // Records one connection's outcome and replies after the last one.
+    void Complete(const std::string& id, EncodableValue value, bool failed) {
+      std::unique_ptr<MethodResultProxy> done;
+      EncodableMap map;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        (failed ? errors : replies)[EncodableValue(id)] = std::move(value);
+        if (--pending > 0)
+          return;
+        map[EncodableValue("peerConnections")] =
+            EncodableValue(std::move(replies));
+        map[EncodableValue("errors")] = EncodableValue(std::move(errors));
+        done = std::move(result);
+      }
+      done->Success(EncodableValue(map));
+    }
+  };
+
+  if (pcs.empty()) {
+    EncodableMap map;
+    map[EncodableValue("peerConnections")] = EncodableValue(EncodableMap());
+    map[EncodableValue("errors")] = EncodableValue(EncodableMap());
+    result->Success(EncodableValue(map));
+    return;
+  }
+
+  auto join = std::make_shared<Join>();
+  join->pending = pcs.size();
+  join->query = query;
+  join->result = std::move(result);
+  // Issue every request before any reply is joined; GetStats completes on
+  // the signaling thread, so the connections are collected concurrently.
+  for (auto& entry : pcs) {
+    auto id = std::make_shared<const std::string>(entry.first);
+    entry.second->GetStats(
+        [join, id](const vector<scoped_refptr<MediaRTCStats>> reports) {
+          join->Complete(*id,
+                         EncodableValue(EncodeStatsReports(reports,
+                                                           join->query)),
+                         false);
         },
-        [result_ptr](const char* error) {
-          result_ptr->Error("GetStats", error);
+        [join, id](const char* error) {
+          join->Complete(*id, EncodableValue(std::string(error)), true);
         });
   }
 }
 
+// Shortest interval accepted by peerConnectionStartStatsStream.
+static constexpr int kMinStatsIntervalMs = 50;
+
+void FlutterPeerConnection::StartStatsStream(
+    FlutterPeerConnectionObserver* observer,
+    const EncodableMap& params,
+    std::unique_ptr<MethodResultProxy> result) {
+  int interval_ms = findInt(params, "intervalMs");
+  if (interval_ms < kMinStatsIntervalMs) {
+    result->Error("peerConnectionStartStatsStreamFailed",
+                  "intervalMs must be at least " +
+                      std::to_string(kMinStatsIntervalMs));
+    return;
+  }
+  observer->StartStatsStream(std::chrono::milliseconds(interval_ms),
+                             ParseStatsFields(findList(params, "fields")));
+  result->Success();
+}
+
+void FlutterPeerConnection::StopStatsStream(
+    FlutterPeerConnectionObserver* observer,
+    std::unique_ptr<MethodResultProxy> result) {
+  observer->StopStatsStream();
+  result->Success();
+}
+
+// Defaults for peerConnectionStartStatsRecording: 10 Hz, 36000 records.
+// Every sample writes one record per RTP stream plus the nominated
+// candidate pair, so with an ordinary audio+video call (about five records
+// per sample) that covers roughly 12 minutes, not an hour.
+static constexpr int kDefaultStatsRecordingIntervalMs = 100;
+static constexpr int64_t kDefaultStatsRecordingCapacity = 36000;
+// Keeps a recording file under roughly 1 GiB.
+static constexpr int64_t kMaxStatsRecordingCapacity = 10000000;
+
+void FlutterPeerConnection::StartStatsRecording(
+    FlutterPeerConnectionObserver* observer,
+    const EncodableMap& params,
+    std::unique_ptr<MethodResultProxy> result) {
+  const std::string path = findString(params, "path");
+  if (path.empty()) {
+    result->Error("peerConnectionStartStatsRecordingFailed",
+                  "path is required");
+    return;
+  }
+  int interval_ms = findInt(params, "intervalMs");
+  if (interval_ms == -1)
+    interval_ms = kDefaultStatsRecordingIntervalMs;
+  if (interval_ms < kMinStatsIntervalMs) {
+    result->Error("peerConnectionStartStatsRecordingFailed",
+                  "intervalMs must be at least " +
+                      std::to_string(kMinStatsIntervalMs));
+    return;
+  }
+  int64_t capacity = findLongInt(params, "capacity");
+  if (capacity == -1)
+    capacity = kDefaultStatsRecordingCapacity;
+  if (capacity <= 0 || capacity > kMaxStatsRecordingCapacity) {
+    result->Error("peerConnectionStartStatsRecordingFailed",
+                  "capacity must be between 1 and " +
+                      std::to_string(kMaxStatsRecordingCapacity));
+    return;
+  }
+
+  std::string error;
+  if (!observer->StartStatsRecording(path,
+                                     std::chrono::milliseconds(interval_ms),
+                                     static_cast<uint64_t>(capacity),
+                                     &error)) {
+    result->Error("peerConnectionStartStatsRecordingFailed", error);
+    return;
+  }
+  result->Success();
+}
+
+void FlutterPeerConnection::StopStatsRecording(
+    FlutterPeerConnectionObserver* observer,
+    std::unique_ptr<MethodResultProxy> result) {
+  result->Success(EncodableValue(observer->StopStatsRecording()));
+}
+
+void FlutterPeerConnection::ExportStatsRecording(
+    const EncodableMap& params,
+    std::unique_ptr<MethodResultProxy> result) {
+  const std::string path = findString(params, "path");
+  const std::string csv_path = findString(params, "csvPath");
+  if (path.empty() || csv_path.empty()) {
+    result->Error("exportStatsRecordingFailed",
+                  "path and csvPath are required");
+    return;
+  }
+  std::string error;
+  if (!StatsRecordingToCsv(path, csv_path, &error)) {
+    result->Error("exportStatsRecordingFailed", error);
+    return;
+  }
+  result->Success();
+}
+
 void FlutterPeerConnection::MediaStreamAddTrack(
     scoped_refptr<RTCMediaStream> stream,
     scoped_refptr<RTCMediaTrack> track,
@@ -1085,6 +1454,8 @@ void FlutterPeerConnection::AddTrack(
     auto sender =
         pc->AddTrack(reinterpret_cast<RTCAudioTrack*>(track.get()), streamIds);
     if (sender.get() != nullptr) {
+      if (auto index = base_->RtpIndexFor(pc))
+        index->AddSender(sender);
       result_ptr->Success(EncodableValue(rtpSenderToMap(sender)));
       return;
     }
@@ -1092,6 +1463,8 @@ void FlutterPeerConnection::AddTrack(
     auto sender =
         pc->AddTrack(reinterpret_cast<RTCVideoTrack*>(track.get()), streamIds);
     if (sender.get() != nullptr) {
+      if (auto index = base_->RtpIndexFor(pc))
+        index->AddSender(sender);
       result_ptr->Success(EncodableValue(rtpSenderToMap(sender)));
       return;
     }
@@ -1129,7 +1502,50 @@ FlutterPeerConnectionObserver::FlutterPeerConnectionObserver(
   peerconnection->RegisterRTCPeerConnectionObserver(this);
 }
 
+FlutterPeerConnectionObserver::~FlutterPeerConnectionObserver() {
+  candidate_timer_.Stop();
+  std::lock_guard<std::mutex> lock(remote_mutex_);
+  for (auto& kv : remote_tracks_) {
+    base_->RemoveRemoteTrack(id_, kv.first);
+  }
+}
+
+void FlutterPeerConnectionObserver::StartStatsStream(
+    std::chrono::milliseconds interval,
+    StatsFieldFilter fields) {
+  if (!stats_sampler_) {
+    stats_sampler_.reset(
+        new StatsSampler(peerconnection_, event_channel_.get()));
+  }
+  stats_sampler_->Start(interval, std::move(fields));
+}
+
+void FlutterPeerConnectionObserver::StopStatsStream() {
+  if (stats_sampler_)
+    stats_sampler_->Stop();
+}
+
+bool FlutterPeerConnectionObserver::StartStatsRecording(
+    const std::string& path,
+    std::chrono::milliseconds interval,
+    uint64_t capacity,
+    std::string* error) {
+  if (!stats_recorder_)
+    stats_recorder_.reset(new StatsRecorder(peerconnection_));
+  return stats_recorder_->Start(path, interval, capacity, error);
+}
+
+EncodableMap FlutterPeerConnectionObserver::StopStatsRecording() {
+  if (!stats_recorder_)
+    return EncodableMap();
+  return stats_recorder_->Stop();
+}
+
 void FlutterPeerConnectionObserver::OnSignalingState(RTCSignalingState state) {
+  // Every step of negotiation can create transceivers (a remote offer's
+  // recvonly m-lines fire no OnTrack) or retire stopped ones.
+  if (auto index = base_->RtpIndexFor(peerconnection_.get()))
+    index->Clear();
   EncodableMap params;
   params[EncodableValue("event")] = "signalingState";
   params[EncodableValue("state")] = signalingStateString(state);
@@ -1146,6 +1562,11 @@ void FlutterPeerConnectionObserver::OnPeerConnectionState(
 
 void FlutterPeerConnectionObserver::OnIceGatheringState(
     RTCIceGatheringState state) {
+  if (state == RTCIceGatheringStateComplete) {
+    // Deliver every candidate before the state change that ends them.
+    std::lock_guard<std::mutex> lock(candidate_mutex_);
+    FlushIceCandidates();
+  }
   EncodableMap params;
   params[EncodableValue("event")] = "iceGatheringState";
   params[EncodableValue("state")] = iceGatheringStateString(state);
@@ -1162,8 +1583,6 @@ void FlutterPeerConnectionObserver::OnIceConnectionState(
 
 void FlutterPeerConnectionObserver::OnIceCandidate(
     scoped_refptr<RTCIceCandidate> candidate) {
-  EncodableMap params;
-  params[EncodableValue("event")] = "onCandidate";
   EncodableMap cand;
   cand[EncodableValue("candidate")] =
       EncodableValue(candidate->candidate().std_string());
@@ -1171,10 +1590,47 @@ void FlutterPeerConnectionObserver::OnIceCandidate(
       EncodableValue(candidate->sdp_mline_index());
   cand[EncodableValue("sdpMid")] =
       EncodableValue(candidate->sdp_mid().std_string());
+
+  std::lock_guard<std::mutex> lock(candidate_mutex_);
+  if (candidate_batch_delay_.count() > 0) {
+    bool start_timer = pending_candidates_.empty();
+    pending_candidates_.push_back(EncodableValue(std::move(cand)));
+    if (start_timer) {
+      candidate_timer_.Start(candidate_batch_delay_, [this]() {
+        std::lock_guard<std::mutex> lock(candidate_mutex_);
+        FlushIceCandidates();
+        return false;
+      });
+    }
+    return;
+  }
+
+  EncodableMap params;
+  params[EncodableValue("event")] = "onCandidate";
   params[EncodableValue("candidate")] = EncodableValue(cand);
   event_channel_->Success(EncodableValue(params));
 }
 
+void FlutterPeerConnectionObserver::SetIceCandidateBatching(
+    std::chrono::milliseconds max_delay) {
+  std::lock_guard<std::mutex> lock(candidate_mutex_);
+  FlushIceCandidates();
+  candidate_batch_delay_ = max_delay;
+}
+
+void FlutterPeerConnectionObserver::FlushIceCandidates() {
+  if (pending_candidates_.empty())
+    return;
+  // Sent while holding candidate_mutex_ so a timer flush and a gathering
+  // complete flush can't reorder candidates.
+  EncodableMap params;
+  params[EncodableValue("event")] = "onIceCandidates";
+  params[EncodableValue("candidates")] =
+      EncodableValue(std::move(pending_candidates_));
+  pending_candidates_ = EncodableList();
+  event_channel_->Success(EncodableValue(std::move(params)));
+}
+
 void FlutterPeerConnectionObserver::OnAddStream(
     scoped_refptr<RTCMediaStream> stream) {
   std::string streamId = stream->id().std_string();
@@ -1196,6 +1652,7 @@ void FlutterPeerConnectionObserver::OnAddStream(
     audioTrack[EncodableValue("readyState")] = "live";
 
     audioTracks.push_back(EncodableValue(audioTrack));
+    AddRemoteTrack(track);
   }
   params[EncodableValue("audioTracks")] = EncodableValue(audioTracks);
 
@@ -1214,8 +1671,12 @@ void FlutterPeerConnectionObserver::OnAddStream(
     videoTrack[EncodableValue("readyState")] = "live";
 
     videoTracks.push_back(EncodableValue(videoTrack));
+    AddRemoteTrack(track);
+  }
+  {
+    std::lock_guard<std::mutex> lock(remote_mutex_);
+    remote_streams_[streamId] = scoped_refptr<RTCMediaStream>(stream);
   }
-  remote_streams_[streamId] = scoped_refptr<RTCMediaStream>(stream);
   params[EncodableValue("videoTracks")] = EncodableValue(videoTracks);
 
   event_channel_->Success(EncodableValue(params));
@@ -1223,6 +1684,15 @@ void FlutterPeerConnectionObserver::OnAddStream(
 
 void FlutterPeerConnectionObserver::OnRemoveStream(
     scoped_refptr<RTCMediaStream> stream) {
+  auto audio_tracks = stream->audio_tracks();
+  for (auto track : audio_tracks.std_vector()) {
+    RemoveRemoteTrack(track->id().std_string());
+  }
+  auto video_tracks = stream->video_tracks();
+  for (auto track : video_tracks.std_vector()) {
+    RemoveRemoteTrack(track->id().std_string());
+  }
+
   EncodableMap params;
   params[EncodableValue("event")] = "onRemoveStream";
   params[EncodableValue("streamId")] =
@@ -1234,6 +1704,9 @@ void FlutterPeerConnectionObserver::OnAddTrack(
     vector<scoped_refptr<RTCMediaStream>> streams,
     scoped_refptr<RTCRtpReceiver> receiver) {
   auto track = receiver->track();
+  AddRemoteTrack(track);
+  if (auto index = base_->RtpIndexFor(peerconnection_.get()))
+    index->AddReceiver(receiver);
 
   std::vector<scoped_refptr<RTCMediaStream>> mediaStreams;
   for (scoped_refptr<RTCMediaStream> stream : streams.std_vector()) {
@@ -1263,6 +1736,9 @@ void FlutterPeerConnectionObserver::OnAddTrack(
 void FlutterPeerConnectionObserver::OnTrack(
     scoped_refptr<RTCRtpTransceiver> transceiver) {
   auto receiver = transceiver->receiver();
+  AddRemoteTrack(receiver->track());
+  if (auto index = base_->RtpIndexFor(peerconnection_.get()))
+    index->AddTransceiver(transceiver);
   EncodableMap params;
   EncodableList streams_info;
   auto streams = receiver->streams();
@@ -1284,6 +1760,7 @@ void FlutterPeerConnectionObserver::OnTrack(
 void FlutterPeerConnectionObserver::OnRemoveTrack(
     scoped_refptr<RTCRtpReceiver> receiver) {
   auto track = receiver->track();
+  RemoveRemoteTrack(track->id().std_string());
 
   EncodableMap params;
   params[EncodableValue("event")] = "onRemoveTrack";
@@ -1329,9 +1806,10 @@ void FlutterPeerConnectionObserver::OnDataChannel(
                                         base_->task_runner_,
                                         event_channel));
 
-  base_->lock();
-  base_->data_channel_observers_[channel_uuid] = std::move(observer);
-  base_->unlock();
+  {
+    std::unique_lock<std::shared_mutex> lock(base_->data_channels_mutex_);
+    base_->data_channel_observers_[channel_uuid] = std::move(observer);
+  }
 
   EncodableMap params;
   params[EncodableValue("event")] = "didOpenDataChannel";
@@ -1350,6 +1828,7 @@ void FlutterPeerConnectionObserver::OnRenegotiationNeeded() {
 
 scoped_refptr<RTCMediaStream> FlutterPeerConnectionObserver::MediaStreamForId(
     const std::string& id) {
+  std::lock_guard<std::mutex> lock(remote_mutex_);
   auto it = remote_streams_.find(id);
   if (it != remote_streams_.end())
     return (*it).second;
@@ -1358,25 +1837,37 @@ scoped_refptr<RTCMediaStream> FlutterPeerConnectionObserver::MediaStreamForId(
 
 scoped_refptr<RTCMediaTrack> FlutterPeerConnectionObserver::MediaTrackForId(
     const std::string& id) {
-  for (auto it = remote_streams_.begin(); it != remote_streams_.end(); it++) {
-    auto remoteStream = (*it).second;
-    auto audio_tracks = remoteStream->audio_tracks();
-    for (auto track : audio_tracks.std_vector()) {
-      if (track->id().std_string() == id) {
-        return track;
-      }
-    }
-    auto video_tracks = remoteStream->video_tracks();
-    for (auto track : video_tracks.std_vector()) {
-      if (track->id().std_string() == id) {
-        return track;
-      }
-    }
-  }
+  std::lock_guard<std::mutex> lock(remote_mutex_);
+  auto it = remote_tracks_.find(id);
+  if (it != remote_tracks_.end())
+    return (*it).second;
   return nullptr;
 }
 
+void FlutterPeerConnectionObserver::AddRemoteTrack(
+    scoped_refptr<RTCMediaTrack> track) {
+  if (nullptr == track.get())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(remote_mutex_);
+    remote_tracks_[track->id().std_string()] = track;
+  }
+  base_->AddRemoteTrack(id_, track);
+}
+
+void FlutterPeerConnectionObserver::RemoveRemoteTrack(const std::string& id) {
+  {
+    std::lock_guard<std::mutex> lock(remote_mutex_);
+    auto it = remote_tracks_.find(id);
+    if (it == remote_tracks_.end())
+      return;
+    remote_tracks_.erase(it);
+  }
+  base_->RemoveRemoteTrack(id_, id);
+}
+
 void FlutterPeerConnectionObserver::RemoveStreamForId(const std::string& id) {
+  std::lock_guard<std::mutex> lock(remote_mutex_);
   auto it = remote_streams_.find(id);
   if (it != remote_streams_.end())
     remote_streams_.erase(it);
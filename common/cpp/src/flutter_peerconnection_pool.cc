@@ -0,0 +1,411 @@
+#include "flutter_peerconnection_pool.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <future>
+#include <thread>
+
+namespace flutter_webrtc_plus_plugin {
+
+// Delay before topping up after a take, so a burst of createPeerConnection
+// calls isn't slowed down by refills competing for the signaling thread.
+static constexpr std::chrono::milliseconds kRefillDelay(50);
+
+// How long Benchmark waits for its pool to fill, and for each step of an
+// iteration.
+static constexpr std::chrono::seconds kBenchmarkFillTimeout(10);
+static constexpr std::chrono::seconds kBenchmarkStepTimeout(5);
+
+static void AppendCanonical(const EncodableValue& value, std::string* out) {
+  out->append(std::to_string(value.index()));
+  out->push_back(':');
+  if (const bool* b = std::get_if<bool>(&value)) {
+    out->push_back(*b ? '1' : '0');
+  } else if (const int32_t* i = std::get_if<int32_t>(&value)) {
+    out->append(std::to_string(*i));
+  } else if (const int64_t* l = std::get_if<int64_t>(&value)) {
+    out->append(std::to_string(*l));
+  } else if (const double* d = std::get_if<double>(&value)) {
+    out->append(std::to_string(*d));
+  } else if (const std::string* s = std::get_if<std::string>(&value)) {
+    out->append(std::to_string(s->size()));
+    out->push_back(':');
+    out->append(*s);
+  } else if (const EncodableList* list = std::get_if<EncodableList>(&value)) {
+    out->push_back('[');
+    for (const EncodableValue& item : *list) {
+      AppendCanonical(item, out);
+      out->push_back(',');
+    }
+    out->push_back(']');
+  } else if (const EncodableMap* map = std::get_if<EncodableMap>(&value)) {
+    // EncodableMap is ordered, so equal maps encode identically.
+    out->push_back('{');
+    for (const auto& kv : *map) {
+      AppendCanonical(kv.first, out);
+      out->push_back('=');
+      AppendCanonical(kv.second, out);
+      out->push_back(',');
+    }
+    out->push_back('}');
+  }
+}
+
+static EncodableMap LatencySummary(std::vector<double> samples_us) {
+  EncodableMap summary;
+  if (samples_us.empty())
+    return summary;
+  std::sort(samples_us.begin(), samples_us.end());
+  double total = 0;
+  for (double sample : samples_us)
+    total += sample;
+  summary[EncodableValue("meanUs")] = EncodableValue(total / samples_us.size());
+  summary[EncodableValue("p50Us")] =
+      EncodableValue(samples_us[samples_us.size() / 2]);
+  summary[EncodableValue("maxUs")] = EncodableValue(samples_us.back());
+  return summary;
+}
+
+namespace {
+
+// Registered for the timed part of a benchmark iteration, which only waits
+// on ICE gathering.
+class GatheringObserver : public RTCPeerConnectionObserver {
+ public:
+  bool WaitForGatheringComplete(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cv_.wait_for(lock, timeout, [this] { return gathered_; });
+  }
+
+  void OnIceGatheringState(RTCIceGatheringState state) override {
+    if (state != RTCIceGatheringStateComplete)
+      return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    gathered_ = true;
+    cv_.notify_all();
+  }
+
+  void OnSignalingState(RTCSignalingState state) override {}
+  void OnPeerConnectionState(RTCPeerConnectionState state) override {}
+  void OnIceConnectionState(RTCIceConnectionState state) override {}
+  void OnIceCandidate(scoped_refptr<RTCIceCandidate> candidate) override {}
+  void OnAddStream(scoped_refptr<RTCMediaStream> stream) override {}
+  void OnRemoveStream(scoped_refptr<RTCMediaStream> stream) override {}
+  void OnDataChannel(scoped_refptr<RTCDataChannel> data_channel) override {}
+  void OnRenegotiationNeeded() override {}
+  void OnTrack(scoped_refptr<RTCRtpTransceiver> transceiver) override {}
+  void OnAddTrack(vector<scoped_refptr<RTCMediaStream>> streams,
+                  scoped_refptr<RTCRtpReceiver> receiver) override {}
+  void OnRemoveTrack(scoped_refptr<RTCRtpReceiver> receiver) override {}
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool gathered_ = false;
+};
+
+// Shared with libwebrtc callbacks, which may outlive a timed-out wait.
+struct SdpCompletion {
+  std::promise<std::string> error;
+  std::string sdp;
+  std::string type;
+};
+
+bool AwaitSdp(const std::shared_ptr<SdpCompletion>& completion,
+              const char* step,
+              std::string* error) {
+  std::future<std::string> future = completion->error.get_future();
+  if (future.wait_for(kBenchmarkStepTimeout) != std::future_status::ready) {
+    *error = std::string(step) + " timed out";
+    return false;
+  }
+  std::string message = future.get();
+  if (!message.empty()) {
+    *error = std::string(step) + " failed: " + message;
+    return false;
+  }
+  return true;
+}
+
+using Acquire =
+    std::function<scoped_refptr<RTCPeerConnection>(std::string* error)>;
+
+// One benchmark iteration: |acquire| a connection, then create and apply
+// an offer with a data channel and wait for ICE gathering to complete.
+// Returns the elapsed microseconds, or -1 with |error| set.
+double TimeToGathered(const Acquire& acquire, std::string* error) {
+  auto start = std::chrono::steady_clock::now();
+  scoped_refptr<RTCPeerConnection> pc = acquire(error);
+  if (pc.get() == nullptr)
+    return -1;
+  GatheringObserver observer;
+  pc->RegisterRTCPeerConnectionObserver(&observer);
+  RTCDataChannelInit init;
+  scoped_refptr<RTCDataChannel> channel =
+      pc->CreateDataChannel("benchmark", &init);
+
+  auto offer = std::make_shared<SdpCompletion>();
+  pc->CreateOffer(
+      [offer](const libwebrtc::string sdp, const libwebrtc::string type) {
+        offer->sdp = sdp.std_string();
+        offer->type = type.std_string();
+        offer->error.set_value(std::string());
+      },
+      [offer](const char* error) {
+        offer->error.set_value(error ? error : "unknown error");
+      },
+      RTCMediaConstraints::Create());
+  bool gathered = false;
+  if (AwaitSdp(offer, "createOffer", error)) {
+    auto applied = std::make_shared<SdpCompletion>();
+    pc->SetLocalDescription(
+        offer->sdp, offer->type,
+        [applied]() { applied->error.set_value(std::string()); },
+        [applied](const char* error) {
+          applied->error.set_value(error ? error : "unknown error");
+        });
+    if (AwaitSdp(applied, "setLocalDescription", error)) {
+      gathered = observer.WaitForGatheringComplete(kBenchmarkStepTimeout);
+      if (!gathered)
+        *error = "ICE gathering timed out";
+    }
+  }
+  double elapsed_us = std::chrono::duration<double, std::micro>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+
+  pc->DeRegisterRTCPeerConnectionObserver();
+  pc->Close();
+  return gathered ? elapsed_us : -1;
+}
+
+}  // namespace
+
+PeerConnectionPool::PeerConnectionPool(Factory factory)
+    : factory_(std::move(factory)) {}
+
+PeerConnectionPool::~PeerConnectionPool() {
+  refill_timer_.Stop();
+  Clear();
+}
+
+std::string PeerConnectionPool::KeyFor(const EncodableMap& configuration,
+                                       const EncodableMap& constraints) {
+  std::string key;
+  AppendCanonical(EncodableValue(configuration), &key);
+  key.push_back('|');
+  AppendCanonical(EncodableValue(constraints), &key);
+  return key;
+}
+
+void PeerConnectionPool::Configure(const EncodableMap& configuration,
+                                   const EncodableMap& constraints,
+                                   int size,
+                                   int ice_candidate_pool_size) {
+  std::deque<Warm> dropped;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string key = KeyFor(configuration, constraints);
+    if (size <= 0) {
+      auto it = entries_.find(key);
+      if (it == entries_.end())
+        return;
+      dropped = std::move(it->second.idle);
+      entries_.erase(it);
+    } else {
+      Entry& entry = entries_[key];
+      entry.configuration = configuration;
+      entry.constraints = constraints;
+      entry.ice_candidate_pool_size = ice_candidate_pool_size;
+      entry.size = size;
+      while (static_cast<int>(entry.idle.size()) > size) {
+        dropped.push_back(std::move(entry.idle.back()));
+        entry.idle.pop_back();
+      }
+    }
+  }
+  // Close() fires callbacks, so never call it with the lock held.
+  for (Warm& warm : dropped)
+    warm.pc->Close();
+  ScheduleRefill();
+}
+
+bool PeerConnectionPool::Take(const EncodableMap& configuration,
+                              const EncodableMap& constraints,
+                              Warm* warm) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(KeyFor(configuration, constraints));
+    if (it == entries_.end())
+      return false;
+    Entry& entry = it->second;
+    if (entry.idle.empty()) {
+      entry.misses++;
+    } else {
+      *warm = std::move(entry.idle.front());
+      entry.idle.pop_front();
+      entry.hits++;
+    }
+  }
+  ScheduleRefill();
+  return warm->pc.get() != nullptr;
+}
+
+EncodableMap PeerConnectionPool::Stats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  EncodableList entries;
+  for (const auto& kv : entries_) {
+    EncodableMap entry;
+    entry[EncodableValue("configuration")] =
+        EncodableValue(kv.second.configuration);
+    entry[EncodableValue("size")] = EncodableValue(kv.second.size);
+    entry[EncodableValue("idle")] =
+        EncodableValue(static_cast<int>(kv.second.idle.size()));
+    entry[EncodableValue("hits")] = EncodableValue(kv.second.hits);
+    entry[EncodableValue("misses")] = EncodableValue(kv.second.misses);
+    entries.push_back(EncodableValue(std::move(entry)));
+  }
+  EncodableMap params;
+  params[EncodableValue("entries")] = EncodableValue(std::move(entries));
+  params[EncodableValue("created")] = EncodableValue(created_);
+  params[EncodableValue("averageCreateUs")] = EncodableValue(
+      created_ > 0 ? static_cast<double>(total_create_us_) / created_ : 0.0);
+  return params;
+}
+
+void PeerConnectionPool::Clear() {
+  std::map<std::string, Entry> entries;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::swap(entries, entries_);
+  }
+  for (auto& kv : entries) {
+    for (Warm& warm : kv.second.idle)
+      warm.pc->Close();
+  }
+}
+
+void PeerConnectionPool::ScheduleRefill() {
+  refill_timer_.Start(kRefillDelay, [this]() { return Refill(); });
+}
+
+bool PeerConnectionPool::Refill() {
+  std::string key;
+  EncodableMap configuration;
+  EncodableMap constraints;
+  int ice_candidate_pool_size = -1;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& kv : entries_) {
+      if (static_cast<int>(kv.second.idle.size()) < kv.second.size) {
+        key = kv.first;
+        configuration = kv.second.configuration;
+        constraints = kv.second.constraints;
+        ice_candidate_pool_size = kv.second.ice_candidate_pool_size;
+        break;
+      }
+    }
+  }
+  if (key.empty())
+    return false;
+
+  auto start = std::chrono::steady_clock::now();
+  Warm warm = factory_(configuration, constraints, ice_candidate_pool_size);
+  int64_t elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+  if (warm.pc.get() == nullptr)
+    return false;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    created_++;
+    total_create_us_ += elapsed_us;
+    auto it = entries_.find(key);
+    if (it != entries_.end() &&
+        static_cast<int>(it->second.idle.size()) < it->second.size) {
+      it->second.idle.push_back(std::move(warm));
+      return true;
+    }
+  }
+  // The entry was resized or removed while this connection was created.
+  warm.pc->Close();
+  return true;
+}
+
+void PeerConnectionPool::Benchmark(const Factory& factory,
+                                   const EncodableMap& configuration,
+                                   const EncodableMap& constraints,
+                                   int iterations,
+                                   int ice_candidate_pool_size,
+                                   const std::atomic<bool>& cancelled,
+                                   MethodResultProxy* result) {
+  std::string error;
+  std::vector<double> cold_us;
+  for (int i = 0; i < iterations; i++) {
+    if (cancelled)
+      return;
+    double us = TimeToGathered(
+        [&](std::string* failure) {
+          Warm warm =
+              factory(configuration, constraints, ice_candidate_pool_size);
+          if (warm.pc.get() == nullptr)
+            *failure = "Unable to create a peer connection";
+          return warm.pc;
+        },
+        &error);
+    if (us < 0) {
+      result->Error("peerConnectionPoolBenchmarkFailed", error);
+      return;
+    }
+    cold_us.push_back(us);
+  }
+
+  PeerConnectionPool pool(factory);
+  pool.Configure(configuration, constraints, iterations,
+                 ice_candidate_pool_size);
+  std::string key = KeyFor(configuration, constraints);
+  auto deadline = std::chrono::steady_clock::now() + kBenchmarkFillTimeout;
+  for (;;) {
+    if (cancelled)
+      return;
+    {
+      std::lock_guard<std::mutex> lock(pool.mutex_);
+      if (static_cast<int>(pool.entries_[key].idle.size()) >= iterations)
+        break;
+    }
+    if (std::chrono::steady_clock::now() > deadline) {
+      result->Error("peerConnectionPoolBenchmarkFailed",
+                    "Timed out filling the pool");
+      return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  std::vector<double> warm_us;
+  for (int i = 0; i < iterations; i++) {
+    if (cancelled)
+      return;
+    double us = TimeToGathered(
+        [&](std::string* failure) {
+          Warm warm;
+          if (!pool.Take(configuration, constraints, &warm))
+            *failure = "The pool ran dry";
+          return warm.pc;
+        },
+        &error);
+    if (us < 0) {
+      result->Error("peerConnectionPoolBenchmarkFailed", error);
+      return;
+    }
+    warm_us.push_back(us);
+  }
+
+  EncodableMap params;
+  params[EncodableValue("iterations")] = EncodableValue(iterations);
+  params[EncodableValue("cold")] = EncodableValue(LatencySummary(cold_us));
+  params[EncodableValue("warm")] = EncodableValue(LatencySummary(warm_us));
+  result->Success(EncodableValue(params));
+}
+
+}  // namespace flutter_webrtc_plus_plugin
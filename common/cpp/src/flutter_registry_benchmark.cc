@@ -0,0 +1,177 @@
+#include "flutter_registry_benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace flutter_webrtc_plus_plugin {
+
+namespace {
+
+// Few enough that writers keep replacing the entries readers look up.
+constexpr int kStressTracks = 32;
+
+std::string StressPeerConnectionId(int writer) {
+  return "registry-stress-pc-" + std::to_string(writer);
+}
+
+EncodableMap NanosecondSummary(std::vector<double> samples_ns) {
+  EncodableMap summary;
+  if (samples_ns.empty())
+    return summary;
+  std::sort(samples_ns.begin(), samples_ns.end());
+  double total = 0;
+  for (double sample : samples_ns)
+    total += sample;
+  summary[EncodableValue("meanNs")] = EncodableValue(total / samples_ns.size());
+  summary[EncodableValue("p50Ns")] =
+      EncodableValue(samples_ns[samples_ns.size() / 2]);
+  summary[EncodableValue("maxNs")] = EncodableValue(samples_ns.back());
+  return summary;
+}
+
+// Nanoseconds per MediaTracksForId call over one pass through |ids|.
+double TimeLookups(FlutterWebRTCBase* base,
+                   const std::vector<std::string>& ids,
+                   int* found) {
+  auto start = std::chrono::steady_clock::now();
+  for (const std::string& id : ids) {
+    if (base->MediaTracksForId(id).get() != nullptr)
+      (*found)++;
+  }
+  return std::chrono::duration<double, std::nano>(
+             std::chrono::steady_clock::now() - start)
+             .count() /
+         ids.size();
+}
+
+}  // namespace
+
+EncodableMap FlutterRegistryBenchmark::Stress(
+    FlutterWebRTCBase* base,
+    scoped_refptr<RTCPeerConnectionFactory> factory,
+    int writers,
+    int readers,
+    std::chrono::milliseconds duration) {
+  scoped_refptr<RTCAudioSource> source =
+      factory->CreateAudioSource("registry_stress");
+  std::vector<scoped_refptr<RTCMediaTrack>> tracks;
+  std::vector<std::string> ids;
+  for (int i = 0; i < kStressTracks; i++) {
+    std::string id = "registry-stress-" + std::to_string(i);
+    tracks.push_back(factory->CreateAudioTrack(source, id.c_str()));
+    ids.push_back(id);
+  }
+
+  std::atomic<bool> stop{false};
+  std::atomic<int64_t> writes{0};
+  std::atomic<int64_t> lookups{0};
+  std::atomic<int64_t> hits{0};
+  std::vector<std::thread> threads;
+
+  // Even tracks go in as local tracks, odd ones as remote tracks of this
+  // writer's own peer connection id.
+  for (int w = 0; w < writers; w++) {
+    threads.emplace_back([&, w]() {
+      std::string pc_id = StressPeerConnectionId(w);
+      int64_t count = 0;
+      for (int i = w; !stop; i++) {
+        int n = i % kStressTracks;
+        if (n % 2 == 0) {
+          base->AddLocalTrack(tracks[n]);
+          base->RemoveMediaTrackForId(ids[n]);
+        } else {
+          base->AddRemoteTrack(pc_id, tracks[n]);
+          base->RemoveRemoteTrack(pc_id, ids[n]);
+        }
+        count++;
+      }
+      writes += count;
+    });
+  }
+
+  for (int r = 0; r < readers; r++) {
+    threads.emplace_back([&, r]() {
+      int64_t count = 0;
+      int64_t found = 0;
+      for (int i = r; !stop; i++) {
+        const std::string& id = ids[i % kStressTracks];
+        scoped_refptr<RTCMediaTrack> track = base->MediaTracksForId(id);
+        // Use the result, as a handler would.
+        if (track.get() != nullptr && track->id().std_string() == id)
+          found++;
+        count++;
+      }
+      lookups += count;
+      hits += found;
+    });
+  }
+
+  std::this_thread::sleep_for(duration);
+  stop = true;
+  for (std::thread& thread : threads)
+    thread.join();
+
+  for (int i = 0; i < kStressTracks; i++) {
+    base->RemoveMediaTrackForId(ids[i]);
+    for (int w = 0; w < writers; w++)
+      base->RemoveRemoteTrack(StressPeerConnectionId(w), ids[i]);
+  }
+
+  EncodableMap params;
+  params[EncodableValue("writers")] = EncodableValue(writers);
+  params[EncodableValue("readers")] = EncodableValue(readers);
+  params[EncodableValue("durationMs")] =
+      EncodableValue(static_cast<int64_t>(duration.count()));
+  params[EncodableValue("writes")] = EncodableValue(writes.load());
+  params[EncodableValue("lookups")] = EncodableValue(lookups.load());
+  params[EncodableValue("hits")] = EncodableValue(hits.load());
+  return params;
+}
+
+EncodableMap FlutterRegistryBenchmark::RemoteTrackLookup(
+    FlutterWebRTCBase* base,
+    scoped_refptr<RTCPeerConnectionFactory> factory,
+    int tracks,
+    int tracks_per_peer,
+    int rounds) {
+  scoped_refptr<RTCAudioSource> source =
+      factory->CreateAudioSource("registry_benchmark");
+  std::vector<std::pair<std::string, std::string>> entries;
+  std::vector<std::string> ids;
+  std::vector<std::string> unknown_ids;
+  for (int i = 0; i < tracks; i++) {
+    std::string pc_id =
+        "registry-benchmark-pc-" + std::to_string(i / tracks_per_peer);
+    std::string id = "registry-benchmark-" + std::to_string(i);
+    base->AddRemoteTrack(pc_id, factory->CreateAudioTrack(source, id.c_str()));
+    entries.emplace_back(pc_id, id);
+    ids.push_back(id);
+    unknown_ids.push_back("registry-benchmark-missing-" + std::to_string(i));
+  }
+
+  std::vector<double> hit_ns;
+  std::vector<double> miss_ns;
+  int found = 0;
+  for (int round = 0; round < rounds; round++) {
+    hit_ns.push_back(TimeLookups(base, ids, &found));
+    miss_ns.push_back(TimeLookups(base, unknown_ids, &found));
+  }
+
+  for (const auto& entry : entries)
+    base->RemoveRemoteTrack(entry.first, entry.second);
+
+  EncodableMap params;
+  params[EncodableValue("tracks")] = EncodableValue(tracks);
+  params[EncodableValue("peerConnections")] =
+      EncodableValue((tracks + tracks_per_peer - 1) / tracks_per_peer);
+  params[EncodableValue("rounds")] = EncodableValue(rounds);
+  // Every known id should hit and no unknown one should.
+  params[EncodableValue("found")] = EncodableValue(found);
+  params[EncodableValue("hit")] = EncodableValue(NanosecondSummary(hit_ns));
+  params[EncodableValue("miss")] = EncodableValue(NanosecondSummary(miss_ns));
+  return params;
+}
+
+}  // namespace flutter_webrtc_plus_plugin
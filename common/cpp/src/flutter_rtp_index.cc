@@ -0,0 +1,213 @@
+#include "flutter_rtp_index.h"
+
+namespace flutter_webrtc_plus_plugin {
+
+static bool HasTrack(const scoped_refptr<RTCMediaTrack>& track,
+                     const std::string& track_id) {
+  return track.get() != nullptr && track->id().std_string() == track_id;
+}
+
+scoped_refptr<RTCRtpSender> RtpObjectIndex::SenderForId(
+    RTCPeerConnection* pc,
+    const std::string& id) {
+  return Lookup(pc, &Entries::senders, id,
+                [&id](const scoped_refptr<RTCRtpSender>& sender) {
+                  return sender->id().std_string() == id;
+                });
+}
+
+scoped_refptr<RTCRtpReceiver> RtpObjectIndex::ReceiverForId(
+    RTCPeerConnection* pc,
+    const std::string& id) {
+  return Lookup(pc, &Entries::receivers, id,
+                [&id](const scoped_refptr<RTCRtpReceiver>& receiver) {
+                  return receiver->id().std_string() == id;
+                });
+}
+
+scoped_refptr<RTCRtpTransceiver> RtpObjectIndex::TransceiverForId(
+    RTCPeerConnection* pc,
+    const std::string& id) {
+  return Lookup(pc, &Entries::transceivers, id,
+                [&id](const scoped_refptr<RTCRtpTransceiver>& transceiver) {
+                  return transceiver->transceiver_id().std_string() == id;
+                });
+}
+
+scoped_refptr<RTCRtpSender> RtpObjectIndex::SenderForTrackId(
+    RTCPeerConnection* pc,
+    const std::string& track_id) {
+  return Lookup(pc, &Entries::senders_by_track, track_id,
+                [&track_id](const scoped_refptr<RTCRtpSender>& sender) {
+                  return HasTrack(sender->track(), track_id);
+                });
+}
+
+scoped_refptr<RTCRtpReceiver> RtpObjectIndex::ReceiverForTrackId(
+    RTCPeerConnection* pc,
+    const std::string& track_id) {
+  return Lookup(pc, &Entries::receivers_by_track, track_id,
+                [&track_id](const scoped_refptr<RTCRtpReceiver>& receiver) {
+                  return HasTrack(receiver->track(), track_id);
+                });
+}
+
+bool RtpObjectIndex::TrackForId(RTCPeerConnection* pc,
+                                const std::string& track_id,
+                                scoped_refptr<RTCRtpReceiver>* receiver,
+                                scoped_refptr<RTCRtpSender>* sender) {
+  for (int pass = 0; pass < 2; pass++) {
+    bool complete = false;
+    scoped_refptr<RTCRtpReceiver> found_receiver =
+        Find(&Entries::receivers_by_track, track_id, &complete);
+    scoped_refptr<RTCRtpSender> found_sender =
+        Find(&Entries::senders_by_track, track_id, &complete);
+    bool stale = false;
+    if (found_receiver.get() != nullptr) {
+      if (HasTrack(found_receiver->track(), track_id)) {
+        *receiver = found_receiver;
+        return true;
+      }
+      stale = true;
+    }
+    if (found_sender.get() != nullptr) {
+      if (HasTrack(found_sender->track(), track_id)) {
+        *sender = found_sender;
+        return true;
+      }
+      stale = true;
+    }
+    if (pass > 0 || (complete && !stale))
+      break;
+    Rebuild(pc);
+  }
+  return false;
+}
+
+void RtpObjectIndex::AddSender(scoped_refptr<RTCRtpSender> sender) {
+  if (sender.get() == nullptr)
+    return;
+  Entries added;
+  IndexSender(&added, sender);
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& kv : added.senders)
+    entries_.senders[kv.first] = kv.second;
+  for (auto& kv : added.senders_by_track)
+    entries_.senders_by_track[kv.first] = kv.second;
+  complete_ = false;
+  generation_++;
+}
+
+void RtpObjectIndex::AddReceiver(scoped_refptr<RTCRtpReceiver> receiver) {
+  if (receiver.get() == nullptr)
+    return;
+  Entries added;
+  IndexReceiver(&added, receiver);
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& kv : added.receivers)
+    entries_.receivers[kv.first] = kv.second;
+  for (auto& kv : added.receivers_by_track)
+    entries_.receivers_by_track[kv.first] = kv.second;
+  complete_ = false;
+  generation_++;
+}
+
+void RtpObjectIndex::AddTransceiver(
+    scoped_refptr<RTCRtpTransceiver> transceiver) {
+  if (transceiver.get() == nullptr)
+    return;
+  std::string id = transceiver->transceiver_id().std_string();
+  AddSender(transceiver->sender());
+  AddReceiver(transceiver->receiver());
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.transceivers[id] = transceiver;
+  complete_ = false;
+  generation_++;
+}
+
+void RtpObjectIndex::Clear() {
+  Entries cleared;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::swap(entries_, cleared);
+    complete_ = false;
+    generation_++;
+  }
+  // The wrappers are released here, outside the lock.
+}
+
+template <typename T>
+scoped_refptr<T> RtpObjectIndex::Find(Map<T> Entries::*map,
+                                      const std::string& key,
+                                      bool* complete) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  *complete = complete_;
+  auto it = (entries_.*map).find(key);
+  if (it == (entries_.*map).end())
+    return scoped_refptr<T>();
+  return it->second;
+}
+
+template <typename T, typename Matches>
+scoped_refptr<T> RtpObjectIndex::Lookup(RTCPeerConnection* pc,
+                                        Map<T> Entries::*map,
+                                        const std::string& key,
+                                        Matches matches) {
+  bool complete = false;
+  scoped_refptr<T> found = Find(map, key, &complete);
+  if (found.get() != nullptr && matches(found))
+    return found;
+  if (found.get() == nullptr && complete)
+    return scoped_refptr<T>();
+  Rebuild(pc);
+  found = Find(map, key, &complete);
+  if (found.get() != nullptr && matches(found))
+    return found;
+  return scoped_refptr<T>();
+}
+
+void RtpObjectIndex::Rebuild(RTCPeerConnection* pc) {
+  uint64_t generation;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    generation = generation_;
+  }
+  Entries rebuilt;
+  auto senders = pc->senders();
+  for (scoped_refptr<RTCRtpSender> sender : senders.std_vector()) {
+    IndexSender(&rebuilt, sender);
+  }
+  auto receivers = pc->receivers();
+  for (scoped_refptr<RTCRtpReceiver> receiver : receivers.std_vector()) {
+    IndexReceiver(&rebuilt, receiver);
+  }
+  auto transceivers = pc->transceivers();
+  for (scoped_refptr<RTCRtpTransceiver> transceiver :
+       transceivers.std_vector()) {
+    rebuilt.transceivers[transceiver->transceiver_id().std_string()] =
+        transceiver;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::swap(entries_, rebuilt);
+  // Anything added meanwhile was just dropped, so a miss must rebuild.
+  complete_ = generation == generation_;
+}
+
+void RtpObjectIndex::IndexSender(Entries* entries,
+                                 scoped_refptr<RTCRtpSender> sender) {
+  // Keep the first match for duplicate keys, like the scans this replaces.
+  entries->senders.emplace(sender->id().std_string(), sender);
+  auto track = sender->track();
+  if (track.get() != nullptr)
+    entries->senders_by_track.emplace(track->id().std_string(), sender);
+}
+
+void RtpObjectIndex::IndexReceiver(Entries* entries,
+                                   scoped_refptr<RTCRtpReceiver> receiver) {
+  entries->receivers.emplace(receiver->id().std_string(), receiver);
+  auto track = receiver->track();
+  if (track.get() != nullptr)
+    entries->receivers_by_track.emplace(track->id().std_string(), receiver);
+}
+
+}  // namespace flutter_webrtc_plus_plugin
@@ -0,0 +1,491 @@
+#include "flutter_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace flutter_webrtc_plus_plugin {
+
+StatsFieldFilter ParseStatsFields(const EncodableList& fields) {
+  StatsFieldFilter filter;
+  for (const EncodableValue& field : fields) {
+    if (!TypeIs<std::string>(field))
+      continue;
+    const std::string& name = GetValue<std::string>(field);
+    size_t dot = name.find('.');
+    if (dot == std::string::npos) {
+      filter[name].clear();
+      continue;
+    }
+    auto& members = filter[name.substr(0, dot)];
+    members.insert(name.substr(dot + 1));
+  }
+  return filter;
+}
+
+StatsQuery ParseStatsQuery(const EncodableMap& params) {
+  StatsQuery query;
+  query.fields = ParseStatsFields(findList(params, "fields"));
+  query.columnar = findString(params, "format") == "columnar";
+  return query;
+}
+
+EncodableMap statsToMap(const scoped_refptr<MediaRTCStats>& stats,
+                        const std::unordered_set<std::string>* filter) {
+  EncodableMap report_map;
+  report_map[EncodableValue("id")] = EncodableValue(stats->id().std_string());
+  report_map[EncodableValue("type")] =
+      EncodableValue(stats->type().std_string());
+  report_map[EncodableValue("timestamp")] =
+      EncodableValue(static_cast<double>(stats->timestamp_us()));
+  EncodableMap values;
+  auto members = stats->Members();
+  for (int i = 0; i < members.size(); i++) {
+    auto member = members[i];
+    if (filter && !filter->empty() &&
+        filter->count(member->GetName().std_string()) == 0) {
+      continue;
+    }
+    switch (member->GetType()) {
+      case RTCStatsMember::Type::kBool:
+        values[EncodableValue(member->GetName().std_string())] =
+            EncodableValue(member->ValueBool());
+        break;
+      case RTCStatsMember::Type::kInt32:
+        values[EncodableValue(member->GetName().std_string())] =
+            EncodableValue(member->ValueInt32());
+        break;
+      case RTCStatsMember::Type::kUint32:
+        values[EncodableValue(member->GetName().std_string())] =
+            EncodableValue((int64_t)member->ValueUint32());
+        break;
+      case RTCStatsMember::Type::kInt64:
+        values[EncodableValue(member->GetName().std_string())] =
+            EncodableValue(member->ValueInt64());
+        break;
+      case RTCStatsMember::Type::kUint64:
+        values[EncodableValue(member->GetName().std_string())] =
+            EncodableValue((int64_t)member->ValueUint64());
+        break;
+      case RTCStatsMember::Type::kDouble:
+        values[EncodableValue(member->GetName().std_string())] =
+            EncodableValue(member->ValueDouble());
+        break;
+      case RTCStatsMember::Type::kString:
+        values[EncodableValue(member->GetName().std_string())] =
+            EncodableValue(member->ValueString().std_string());
+        break;
+      default:
+        break;
+    }
+  }
+  report_map[EncodableValue("values")] = EncodableValue(values);
+  return report_map;
+}
+
+// One column of a columnar stats table. Numbers and booleans are packed into
+// a Float64List with NaN for reports that lack the member; strings use a
+// list with nulls.
+struct StatsColumn {
+  std::string name;
+  bool is_string = false;
+  std::vector<double> numbers;
+  EncodableList strings;
+};
+
+// Collects the reports of one type into columns.
+struct StatsTable {
+  std::string type;
+  EncodableList ids;
+  std::vector<double> timestamps;
+  std::vector<StatsColumn> columns;
+  std::unordered_map<std::string, size_t> column_index;
+};
+
+static void AddToTable(StatsTable& table,
+                       const scoped_refptr<MediaRTCStats>& report,
+                       const std::unordered_set<std::string>* filter,
+                       size_t row,
+                       size_t rows) {
+  table.ids.push_back(EncodableValue(report->id().std_string()));
+  table.timestamps.push_back(static_cast<double>(report->timestamp_us()));
+  auto members = report->Members();
+  for (size_t i = 0; i < members.size(); i++) {
+    const scoped_refptr<RTCStatsMember>& member = members[i];
+    if (!member->IsDefined())
+      continue;
+    std::string name = member->GetName().std_string();
+    if (filter && !filter->empty() && filter->count(name) == 0)
+      continue;
+
+    bool is_string = false;
+    double number = std::numeric_limits<double>::quiet_NaN();
+    switch (member->GetType()) {
+      case RTCStatsMember::Type::kBool:
+        number = member->ValueBool() ? 1 : 0;
+        break;
+      case RTCStatsMember::Type::kInt32:
+        number = member->ValueInt32();
+        break;
+      case RTCStatsMember::Type::kUint32:
+        number = member->ValueUint32();
+        break;
+      case RTCStatsMember::Type::kInt64:
+        number = static_cast<double>(member->ValueInt64());
+        break;
+      case RTCStatsMember::Type::kUint64:
+        number = static_cast<double>(member->ValueUint64());
+        break;
+      case RTCStatsMember::Type::kDouble:
+        number = member->ValueDouble();
+        break;
+      case RTCStatsMember::Type::kString:
+        is_string = true;
+        break;
+      default:
+        continue;
+    }
+
+    auto it = table.column_index.find(name);
+    if (it == table.column_index.end()) {
+      StatsColumn column;
+      column.name = name;
+      column.is_string = is_string;
+      if (is_string) {
+        column.strings.resize(rows);
+      } else {
+        column.numbers.resize(rows, std::numeric_limits<double>::quiet_NaN());
+      }
+      it = table.column_index.emplace(name, table.columns.size()).first;
+      table.columns.push_back(std::move(column));
+    }
+    StatsColumn& column = table.columns[it->second];
+    if (column.is_string != is_string)
+      continue;
+    if (is_string) {
+      column.strings[row] = EncodableValue(member->ValueString().std_string());
+    } else {
+      column.numbers[row] = number;
+    }
+  }
+}
+
+static EncodableMap StatsToColumns(
+    const vector<scoped_refptr<MediaRTCStats>>& reports,
+    const StatsFieldFilter& fields) {
+  // Row counts per type first, so every column is allocated once.
+  std::vector<std::string> types;
+  std::unordered_map<std::string, size_t> rows;
+  for (size_t i = 0; i < reports.size(); i++) {
+    std::string type = reports[i]->type().std_string();
+    if (!fields.empty() && fields.count(type) == 0)
+      continue;
+    if (rows[type]++ == 0)
+      types.push_back(type);
+  }
+
+  std::unordered_map<std::string, StatsTable> tables;
+  std::unordered_map<std::string, size_t> next_row;
+  for (size_t i = 0; i < reports.size(); i++) {
+    std::string type = reports[i]->type().std_string();
+    auto row_count = rows.find(type);
+    if (row_count == rows.end())
+      continue;
+    auto filter = fields.find(type);
+    StatsTable& table = tables[type];
+    if (table.type.empty()) {
+      table.type = type;
+      table.ids.reserve(row_count->second);
+      table.timestamps.reserve(row_count->second);
+    }
+    AddToTable(table, reports[i],
+               filter != fields.end() ? &filter->second : nullptr,
+               next_row[type]++, row_count->second);
+  }
+
+  EncodableList list;
+  for (const std::string& type : types) {
+    StatsTable& table = tables[type];
+    EncodableList names;
+    EncodableList columns;
+    for (StatsColumn& column : table.columns) {
+      names.push_back(EncodableValue(column.name));
+      columns.push_back(column.is_string
+                            ? EncodableValue(std::move(column.strings))
+                            : EncodableValue(std::move(column.numbers)));
+    }
+    EncodableMap entry;
+    entry[EncodableValue("type")] = EncodableValue(type);
+    entry[EncodableValue("ids")] = EncodableValue(std::move(table.ids));
+    entry[EncodableValue("timestamps")] =
+        EncodableValue(std::move(table.timestamps));
+    entry[EncodableValue("fields")] = EncodableValue(std::move(names));
+    entry[EncodableValue("columns")] = EncodableValue(std::move(columns));
+    list.push_back(EncodableValue(std::move(entry)));
+  }
+
+  EncodableMap params;
+  params[EncodableValue("tables")] = EncodableValue(std::move(list));
+  return params;
+}
+
+EncodableMap EncodeStatsReports(
+    const vector<scoped_refptr<MediaRTCStats>>& reports,
+    const StatsQuery& query) {
+  if (query.columnar)
+    return StatsToColumns(reports, query.fields);
+
+  EncodableList list;
+  for (size_t i = 0; i < reports.size(); i++) {
+    const std::unordered_set<std::string>* filter = nullptr;
+    if (!query.fields.empty()) {
+      auto it = query.fields.find(reports[i]->type().std_string());
+      if (it == query.fields.end())
+        continue;
+      filter = &it->second;
+    }
+    list.push_back(EncodableValue(statsToMap(reports[i], filter)));
+  }
+  EncodableMap params;
+  params[EncodableValue("stats")] = EncodableValue(std::move(list));
+  return params;
+}
+
+static StatsFieldFilter DefaultStatsFields() {
+  return {
+      {"inbound-rtp",
+       {"kind", "bytesReceived", "packetsReceived", "packetsLost", "jitter",
+        "jitterBufferDelay", "jitterBufferEmittedCount", "framesPerSecond",
+        "framesDecoded"}},
+      {"outbound-rtp",
+       {"kind", "bytesSent", "packetsSent", "retransmittedPacketsSent",
+        "framesPerSecond", "framesEncoded"}},
+      {"remote-inbound-rtp",
+       {"kind", "packetsLost", "jitter", "roundTripTime", "fractionLost"}},
+      {"candidate-pair",
+       {"state", "nominated", "currentRoundTripTime",
+        "availableOutgoingBitrate"}},
+  };
+}
+
+struct StatsSampler::State {
+  // Numeric member values of one report from the previous sample.
+  struct Previous {
+    int64_t timestamp_us = 0;
+    std::unordered_map<std::string, double> values;
+  };
+
+  void OnReports(const vector<scoped_refptr<MediaRTCStats>>& reports);
+
+  std::mutex mutex;
+  // Cleared by Stop(); late GetStats callbacks must not touch the event
+  // channel after that.
+  bool active = false;
+  bool in_flight = false;
+  EventChannelProxy* event_channel = nullptr;
+  StatsFieldFilter fields;
+  std::unordered_map<std::string, Previous> previous;
+};
+
+// Returns the change of |name| between two samples, or false if either
+// sample lacks it.
+static bool Delta(const std::unordered_map<std::string, double>& current,
+                  const std::unordered_map<std::string, double>& previous,
+                  const char* name,
+                  double* delta) {
+  auto cur = current.find(name);
+  auto prev = previous.find(name);
+  if (cur == current.end() || prev == previous.end())
+    return false;
+  *delta = cur->second - prev->second;
+  return true;
+}
+
+static void AddDerivedMetrics(
+    const std::unordered_map<std::string, double>& current,
+    const std::unordered_map<std::string, double>& previous,
+    double seconds,
+    EncodableMap& metrics) {
+  double delta;
+  if (seconds > 0) {
+    if (Delta(current, previous, "bytesSent", &delta) ||
+        Delta(current, previous, "bytesReceived", &delta)) {
+      metrics[EncodableValue("bitrate")] = EncodableValue(delta * 8 / seconds);
+    }
+  }
+
+  double lost, received;
+  if (Delta(current, previous, "packetsLost", &lost) &&
+      Delta(current, previous, "packetsReceived", &received) &&
+      lost + received > 0) {
+    metrics[EncodableValue("packetLossFraction")] =
+        EncodableValue(std::max(0.0, lost / (lost + received)));
+  }
+
+  auto jitter = current.find("jitter");
+  if (jitter != current.end()) {
+    metrics[EncodableValue("jitterMs")] =
+        EncodableValue(jitter->second * 1000);
+  }
+
+  double delay, emitted;
+  if (Delta(current, previous, "jitterBufferDelay", &delay) &&
+      Delta(current, previous, "jitterBufferEmittedCount", &emitted) &&
+      emitted > 0) {
+    metrics[EncodableValue("jitterBufferDelayMs")] =
+        EncodableValue(delay / emitted * 1000);
+  }
+}
+
+void StatsSampler::State::OnReports(
+    const vector<scoped_refptr<MediaRTCStats>>& reports) {
+  std::lock_guard<std::mutex> lock(mutex);
+  in_flight = false;
+  if (!active)
+    return;
+
+  EncodableList list;
+  std::unordered_map<std::string, Previous> current_samples;
+  for (size_t i = 0; i < reports.size(); i++) {
+    const scoped_refptr<MediaRTCStats>& report = reports[i];
+    std::string type = report->type().std_string();
+    auto filter = fields.find(type);
+    if (filter == fields.end())
+      continue;
+    const std::unordered_set<std::string>& members = filter->second;
+
+    std::string id = report->id().std_string();
+    Previous& sample = current_samples[id];
+    sample.timestamp_us = report->timestamp_us();
+    auto prev_it = previous.find(id);
+    const Previous* prev = prev_it != previous.end() ? &prev_it->second
+                                                     : nullptr;
+    double seconds =
+        prev ? (sample.timestamp_us - prev->timestamp_us) / 1e6 : 0;
+
+    EncodableMap metrics;
+    auto stats_members = report->Members();
+    for (size_t j = 0; j < stats_members.size(); j++) {
+      const scoped_refptr<RTCStatsMember>& member = stats_members[j];
+      if (!member->IsDefined())
+        continue;
+      std::string name = member->GetName().std_string();
+      if (!members.empty() && members.count(name) == 0)
+        continue;
+
+      bool counter = true;
+      double value = 0;
+      switch (member->GetType()) {
+        case RTCStatsMember::Type::kInt32:
+          value = member->ValueInt32();
+          break;
+        case RTCStatsMember::Type::kUint32:
+          value = member->ValueUint32();
+          break;
+        case RTCStatsMember::Type::kInt64:
+          value = static_cast<double>(member->ValueInt64());
+          break;
+        case RTCStatsMember::Type::kUint64:
+          value = static_cast<double>(member->ValueUint64());
+          break;
+        case RTCStatsMember::Type::kDouble:
+          counter = false;
+          value = member->ValueDouble();
+          break;
+        case RTCStatsMember::Type::kBool:
+          metrics[EncodableValue(name)] = EncodableValue(member->ValueBool());
+          continue;
+        case RTCStatsMember::Type::kString:
+          metrics[EncodableValue(name)] =
+              EncodableValue(member->ValueString().std_string());
+          continue;
+        default:
+          continue;
+      }
+
+      sample.values[name] = value;
+      metrics[EncodableValue(name)] =
+          counter ? EncodableValue(static_cast<int64_t>(value))
+                  : EncodableValue(value);
+      if (counter && seconds > 0) {
+        auto prev_value = prev->values.find(name);
+        if (prev_value != prev->values.end()) {
+          metrics[EncodableValue(name + "PerSecond")] =
+              EncodableValue((value - prev_value->second) / seconds);
+        }
+      }
+    }
+    if (prev) {
+      AddDerivedMetrics(sample.values, prev->values, seconds, metrics);
+    }
+
+    EncodableMap entry;
+    entry[EncodableValue("id")] = EncodableValue(id);
+    entry[EncodableValue("type")] = EncodableValue(type);
+    entry[EncodableValue("metrics")] = EncodableValue(std::move(metrics));
+    list.push_back(EncodableValue(std::move(entry)));
+  }
+  // Reports that disappeared (e.g. removed transceivers) are dropped here.
+  previous = std::move(current_samples);
+
+  EncodableMap params;
+  params[EncodableValue("event")] = EncodableValue("peerConnectionStats");
+  params[EncodableValue("reports")] = EncodableValue(std::move(list));
+  event_channel->Success(EncodableValue(std::move(params)), false);
+}
+
+StatsSampler::StatsSampler(scoped_refptr<RTCPeerConnection> peerconnection,
+                           EventChannelProxy* event_channel)
+    : peerconnection_(peerconnection), state_(std::make_shared<State>()) {
+  state_->event_channel = event_channel;
+}
+
+StatsSampler::~StatsSampler() {
+  Stop();
+}
+
+void StatsSampler::Start(std::chrono::milliseconds interval,
+                         StatsFieldFilter fields) {
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->active = true;
+    state_->fields = fields.empty() ? DefaultStatsFields() : std::move(fields);
+    state_->previous.clear();
+  }
+  timer_.Start(interval, [this]() { return Sample(); });
+}
+
+void StatsSampler::Stop() {
+  timer_.Stop();
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  state_->active = false;
+  state_->previous.clear();
+}
+
+bool StatsSampler::Sample() {
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    if (!state_->active)
+      return false;
+    // Skip a tick rather than queueing up requests if libwebrtc is slower
+    // than the interval.
+    if (state_->in_flight)
+      return true;
+    state_->in_flight = true;
+  }
+  std::weak_ptr<State> weak_state = state_;
+  peerconnection_->GetStats(
+      [weak_state](const vector<scoped_refptr<MediaRTCStats>> reports) {
+        if (auto state = weak_state.lock())
+          state->OnReports(reports);
+      },
+      [weak_state](const char* error) {
+        if (auto state = weak_state.lock()) {
+          std::lock_guard<std::mutex> lock(state->mutex);
+          state->in_flight = false;
+        }
+      });
+  return true;
+}
+
+}  // namespace flutter_webrtc_plus_plugin
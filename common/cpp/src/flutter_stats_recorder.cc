@@ -0,0 +1,460 @@
+#include "flutter_stats_recorder.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(_WIN32)
+#include <windows.h>
+
+#include "ghc/filesystem.hpp"
+using FileInputStream = ghc::filesystem::ifstream;
+using FileOutputStream = ghc::filesystem::ofstream;
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <fstream>
+using FileInputStream = std::ifstream;
+using FileOutputStream = std::ofstream;
+#endif
+
+namespace flutter_webrtc_plus_plugin {
+
+static const char* kStatsFieldNames[kStatsFieldCount] = {
+    "bytes",
+    "packets",
+    "packetsLost",
+    "jitter",
+    "roundTripTime",
+    "framesPerSecond",
+    "frames",
+    "frameWidth",
+    "frameHeight",
+    "nackCount",
+    "availableOutgoingBitrate",
+    "jitterBufferDelay",
+};
+
+static const char* StatsRecordKindName(uint8_t kind) {
+  switch (kind) {
+    case kStatsRecordInboundAudio:
+      return "inbound-audio";
+    case kStatsRecordInboundVideo:
+      return "inbound-video";
+    case kStatsRecordOutboundAudio:
+      return "outbound-audio";
+    case kStatsRecordOutboundVideo:
+      return "outbound-video";
+    case kStatsRecordRemoteInboundAudio:
+      return "remote-inbound-audio";
+    case kStatsRecordRemoteInboundVideo:
+      return "remote-inbound-video";
+    case kStatsRecordCandidatePair:
+      return "candidate-pair";
+  }
+  return "unknown";
+}
+
+// A file mapped read-write into memory.
+class MappedFile {
+ public:
+  ~MappedFile() { Close(); }
+
+  bool Open(const std::string& path, uint64_t size, std::string* error) {
+#if defined(_WIN32)
+    int length = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    std::wstring wide_path(length, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &wide_path[0], length);
+    file_ = CreateFileW(wide_path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                        FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+                        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+      *error = "Unable to create " + path;
+      return false;
+    }
+    mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READWRITE,
+                                  static_cast<DWORD>(size >> 32),
+                                  static_cast<DWORD>(size), nullptr);
+    if (mapping_ == nullptr) {
+      *error = "Unable to map " + path;
+      Close();
+      return false;
+    }
+    data_ = static_cast<uint8_t*>(
+        MapViewOfFile(mapping_, FILE_MAP_WRITE, 0, 0, size));
+#else
+    fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+      *error = "Unable to create " + path;
+      return false;
+    }
+    if (ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+      *error = "Unable to resize " + path;
+      Close();
+      return false;
+    }
+    void* data =
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    data_ = data == MAP_FAILED ? nullptr : static_cast<uint8_t*>(data);
+#endif
+    if (data_ == nullptr) {
+      *error = "Unable to map " + path;
+      Close();
+      return false;
+    }
+    size_ = size;
+    return true;
+  }
+
+  void Flush() {
+    if (!data_)
+      return;
+#if defined(_WIN32)
+    FlushViewOfFile(data_, 0);
+#else
+    msync(data_, size_, MS_ASYNC);
+#endif
+  }
+
+  void Close() {
+#if defined(_WIN32)
+    if (data_)
+      UnmapViewOfFile(data_);
+    if (mapping_)
+      CloseHandle(mapping_);
+    if (file_ != INVALID_HANDLE_VALUE)
+      CloseHandle(file_);
+    mapping_ = nullptr;
+    file_ = INVALID_HANDLE_VALUE;
+#else
+    if (data_)
+      munmap(data_, size_);
+    if (fd_ >= 0)
+      close(fd_);
+    fd_ = -1;
+#endif
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  uint8_t* data() { return data_; }
+
+ private:
+#if defined(_WIN32)
+  HANDLE file_ = INVALID_HANDLE_VALUE;
+  HANDLE mapping_ = nullptr;
+#else
+  int fd_ = -1;
+#endif
+  uint8_t* data_ = nullptr;
+  uint64_t size_ = 0;
+};
+
+// Maps a report to a record kind and the member feeding each field, or
+// returns false if the report is not recorded.
+static bool RecordLayoutFor(const std::string& type,
+                            const std::string& kind,
+                            uint8_t* record_kind,
+                            const char* const** members) {
+  static const char* const kInbound[kStatsFieldCount] = {
+      "bytesReceived", "packetsReceived", "packetsLost",  "jitter",
+      nullptr,         "framesPerSecond", "framesDecoded", "frameWidth",
+      "frameHeight",   "nackCount",       nullptr,         "jitterBufferDelay",
+  };
+  static const char* const kOutbound[kStatsFieldCount] = {
+      "bytesSent",   "packetsSent",     nullptr,         nullptr,
+      nullptr,       "framesPerSecond", "framesEncoded", "frameWidth",
+      "frameHeight", "nackCount",       nullptr,         nullptr,
+  };
+  static const char* const kRemoteInbound[kStatsFieldCount] = {
+      nullptr, nullptr, "packetsLost", "jitter", "roundTripTime", nullptr,
+      nullptr, nullptr, nullptr,       nullptr,  nullptr,         nullptr,
+  };
+  static const char* const kCandidatePair[kStatsFieldCount] = {
+      "bytesSent", "packetsSent", nullptr, nullptr,
+      "currentRoundTripTime", nullptr, nullptr, nullptr,
+      nullptr, nullptr, "availableOutgoingBitrate", nullptr,
+  };
+
+  bool video = kind == "video";
+  if (type == "inbound-rtp") {
+    *record_kind = video ? kStatsRecordInboundVideo : kStatsRecordInboundAudio;
+    *members = kInbound;
+  } else if (type == "outbound-rtp") {
+    *record_kind =
+        video ? kStatsRecordOutboundVideo : kStatsRecordOutboundAudio;
+    *members = kOutbound;
+  } else if (type == "remote-inbound-rtp") {
+    *record_kind = video ? kStatsRecordRemoteInboundVideo
+                         : kStatsRecordRemoteInboundAudio;
+    *members = kRemoteInbound;
+  } else if (type == "candidate-pair") {
+    *record_kind = kStatsRecordCandidatePair;
+    *members = kCandidatePair;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+static double MemberAsDouble(const scoped_refptr<RTCStatsMember>& member) {
+  switch (member->GetType()) {
+    case RTCStatsMember::Type::kBool:
+      return member->ValueBool() ? 1 : 0;
+    case RTCStatsMember::Type::kInt32:
+      return member->ValueInt32();
+    case RTCStatsMember::Type::kUint32:
+      return member->ValueUint32();
+    case RTCStatsMember::Type::kInt64:
+      return static_cast<double>(member->ValueInt64());
+    case RTCStatsMember::Type::kUint64:
+      return static_cast<double>(member->ValueUint64());
+    case RTCStatsMember::Type::kDouble:
+      return member->ValueDouble();
+    default:
+      return std::numeric_limits<double>::quiet_NaN();
+  }
+}
+
+struct StatsRecorder::State {
+  void OnReports(const vector<scoped_refptr<MediaRTCStats>>& reports);
+
+  std::mutex mutex;
+  bool recording = false;
+  bool in_flight = false;
+  MappedFile file;
+  StatsRecordingHeader* header = nullptr;
+  StatsRecord* records = nullptr;
+  uint64_t samples = 0;
+  uint64_t skipped_samples = 0;
+  int64_t total_write_ns = 0;
+  int64_t max_write_ns = 0;
+};
+
+void StatsRecorder::State::OnReports(
+    const vector<scoped_refptr<MediaRTCStats>>& reports) {
+  std::lock_guard<std::mutex> lock(mutex);
+  in_flight = false;
+  if (!recording)
+    return;
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < reports.size(); i++) {
+    const scoped_refptr<MediaRTCStats>& report = reports[i];
+    std::string type = report->type().std_string();
+    auto members = report->Members();
+
+    std::string kind;
+    bool nominated = true;
+    std::unordered_map<std::string, scoped_refptr<RTCStatsMember>> by_name;
+    for (size_t j = 0; j < members.size(); j++) {
+      if (!members[j]->IsDefined())
+        continue;
+      std::string name = members[j]->GetName().std_string();
+      if (name == "kind") {
+        kind = members[j]->ValueString().std_string();
+      } else if (name == "nominated") {
+        nominated = members[j]->ValueBool();
+      }
+      by_name.emplace(std::move(name), members[j]);
+    }
+
+    uint8_t record_kind;
+    const char* const* fields;
+    if (!RecordLayoutFor(type, kind, &record_kind, &fields))
+      continue;
+    // Only the pair actually carrying media is interesting over time.
+    if (record_kind == kStatsRecordCandidatePair && !nominated)
+      continue;
+
+    StatsRecord& record = records[header->records_written % header->capacity];
+    record.timestamp_us = report->timestamp_us();
+    record.kind = record_kind;
+    auto ssrc = by_name.find("ssrc");
+    record.ssrc = ssrc != by_name.end()
+                      ? static_cast<uint32_t>(MemberAsDouble(ssrc->second))
+                      : 0;
+    memset(record.reserved, 0, sizeof(record.reserved));
+    for (int field = 0; field < kStatsFieldCount; field++) {
+      auto member = fields[field] ? by_name.find(fields[field]) : by_name.end();
+      record.values[field] = member != by_name.end()
+                                 ? MemberAsDouble(member->second)
+                                 : std::numeric_limits<double>::quiet_NaN();
+    }
+    header->records_written++;
+  }
+
+  int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+  samples++;
+  total_write_ns += elapsed;
+  if (elapsed > max_write_ns)
+    max_write_ns = elapsed;
+}
+
+StatsRecorder::StatsRecorder(scoped_refptr<RTCPeerConnection> peerconnection)
+    : peerconnection_(peerconnection), state_(std::make_shared<State>()) {}
+
+StatsRecorder::~StatsRecorder() {
+  Stop();
+}
+
+bool StatsRecorder::Start(const std::string& path,
+                          std::chrono::milliseconds interval,
+                          uint64_t capacity,
+                          std::string* error) {
+  Stop();
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    uint64_t size = kStatsRecordingHeaderSize + capacity * sizeof(StatsRecord);
+    if (!state_->file.Open(path, size, error))
+      return false;
+
+    uint8_t* data = state_->file.data();
+    memset(data, 0, kStatsRecordingHeaderSize);
+    state_->header = reinterpret_cast<StatsRecordingHeader*>(data);
+    memcpy(state_->header->magic, kStatsRecordingMagic,
+           sizeof(kStatsRecordingMagic));
+    state_->header->version = kStatsRecordingVersion;
+    state_->header->header_size = kStatsRecordingHeaderSize;
+    state_->header->record_size = sizeof(StatsRecord);
+    state_->header->interval_ms = static_cast<uint32_t>(interval.count());
+    state_->header->capacity = capacity;
+    state_->header->records_written = 0;
+    state_->records =
+        reinterpret_cast<StatsRecord*>(data + kStatsRecordingHeaderSize);
+    state_->recording = true;
+    state_->samples = 0;
+    state_->skipped_samples = 0;
+    state_->total_write_ns = 0;
+    state_->max_write_ns = 0;
+  }
+  timer_.Start(interval, [this]() { return Sample(); });
+  return true;
+}
+
+EncodableMap StatsRecorder::Stop() {
+  timer_.Stop();
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  EncodableMap params;
+  if (state_->header) {
+    params[EncodableValue("records")] =
+        EncodableValue(static_cast<int64_t>(state_->header->records_written));
+  }
+  params[EncodableValue("samples")] =
+      EncodableValue(static_cast<int64_t>(state_->samples));
+  params[EncodableValue("skippedSamples")] =
+      EncodableValue(static_cast<int64_t>(state_->skipped_samples));
+  params[EncodableValue("averageWriteUs")] = EncodableValue(
+      state_->samples > 0
+          ? state_->total_write_ns / 1000.0 / state_->samples
+          : 0.0);
+  params[EncodableValue("maxWriteUs")] =
+      EncodableValue(state_->max_write_ns / 1000.0);
+
+  state_->recording = false;
+  state_->file.Flush();
+  state_->file.Close();
+  state_->header = nullptr;
+  state_->records = nullptr;
+  return params;
+}
+
+bool StatsRecorder::IsRecording() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->recording;
+}
+
+bool StatsRecorder::Sample() {
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    if (!state_->recording)
+      return false;
+    // Bounds the overhead to one GetStats at a time, whatever the interval.
+    if (state_->in_flight) {
+      state_->skipped_samples++;
+      return true;
+    }
+    state_->in_flight = true;
+  }
+  std::weak_ptr<State> weak_state = state_;
+  peerconnection_->GetStats(
+      [weak_state](const vector<scoped_refptr<MediaRTCStats>> reports) {
+        if (auto state = weak_state.lock())
+          state->OnReports(reports);
+      },
+      [weak_state](const char* error) {
+        if (auto state = weak_state.lock()) {
+          std::lock_guard<std::mutex> lock(state->mutex);
+          state->in_flight = false;
+        }
+      });
+  return true;
+}
+
+bool StatsRecordingToCsv(const std::string& recording_path,
+                         const std::string& csv_path,
+                         std::string* error) {
+  FileInputStream in(recording_path, std::ios::binary);
+  if (!in.is_open()) {
+    *error = "Unable to open " + recording_path;
+    return false;
+  }
+  StatsRecordingHeader header;
+  in.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!in || memcmp(header.magic, kStatsRecordingMagic,
+                    sizeof(kStatsRecordingMagic)) != 0) {
+    *error = recording_path + " is not a stats recording";
+    return false;
+  }
+  if (header.version != kStatsRecordingVersion ||
+      header.record_size != sizeof(StatsRecord) || header.capacity == 0) {
+    *error = "Unsupported stats recording version " +
+             std::to_string(header.version);
+    return false;
+  }
+
+  FileOutputStream out(csv_path, std::ios::trunc);
+  if (!out.is_open()) {
+    *error = "Unable to create " + csv_path;
+    return false;
+  }
+  out << "timestamp_us,kind,ssrc";
+  for (int field = 0; field < kStatsFieldCount; field++) {
+    out << ',' << kStatsFieldNames[field];
+  }
+  out << '\n';
+
+  uint64_t count = header.records_written < header.capacity
+                       ? header.records_written
+                       : header.capacity;
+  uint64_t first = header.records_written - count;
+  out.precision(17);
+  for (uint64_t i = first; i < header.records_written; i++) {
+    StatsRecord record;
+    in.seekg(header.header_size + (i % header.capacity) * sizeof(record));
+    in.read(reinterpret_cast<char*>(&record), sizeof(record));
+    if (!in) {
+      *error = recording_path + " is truncated";
+      return false;
+    }
+    out << record.timestamp_us << ',' << StatsRecordKindName(record.kind)
+        << ',' << record.ssrc;
+    for (int field = 0; field < kStatsFieldCount; field++) {
+      out << ',';
+      if (!std::isnan(record.values[field]))
+        out << record.values[field];
+    }
+    out << '\n';
+  }
+  if (!out) {
+    *error = "Unable to write " + csv_path;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace flutter_webrtc_plus_plugin
@@ -0,0 +1,122 @@
+#include "flutter_transceiver_state.h"
+
+#include <set>
+
+namespace flutter_webrtc_plus_plugin {
+
+// Nested maps diffed field by field, with the field that identifies them.
+static const std::pair<const char*, const char*> kTransceiverSections[] = {
+    {"sender", "senderId"},
+    {"receiver", "receiverId"},
+};
+
+static const char* SectionIdField(const std::string& section) {
+  for (const auto& entry : kTransceiverSections) {
+    if (section == entry.first)
+      return entry.second;
+  }
+  return nullptr;
+}
+
+EncodableMap TransceiverStateCache::Update(
+    const std::vector<std::pair<std::string, EncodableMap>>& current,
+    int64_t since_version) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const int64_t next = version_ + 1;
+  bool changed = false;
+
+  auto record = [&](Entry& entry, FieldKey key, const EncodableValue& value) {
+    auto it = entry.fields.find(key);
+    if (it == entry.fields.end()) {
+      entry.fields.emplace(std::move(key), Field{value, next});
+      changed = true;
+    } else if (!(it->second.value == value)) {
+      it->second.value = value;
+      it->second.version = next;
+      changed = true;
+    }
+  };
+
+  std::set<std::string> live;
+  for (const auto& transceiver : current) {
+    const std::string& id = transceiver.first;
+    live.insert(id);
+    removed_.erase(id);
+    Entry& entry = entries_[id];
+    for (const auto& kv : transceiver.second) {
+      const std::string* name = std::get_if<std::string>(&kv.first);
+      if (!name)
+        continue;
+      const EncodableMap* nested = std::get_if<EncodableMap>(&kv.second);
+      if (nested && SectionIdField(*name)) {
+        for (const auto& field : *nested) {
+          const std::string* field_name =
+              std::get_if<std::string>(&field.first);
+          if (field_name)
+            record(entry, FieldKey(*name, *field_name), field.second);
+        }
+      } else {
+        record(entry, FieldKey(std::string(), *name), kv.second);
+      }
+    }
+  }
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (live.count(it->first)) {
+      ++it;
+      continue;
+    }
+    removed_[it->first] = next;
+    it = entries_.erase(it);
+    changed = true;
+  }
+  if (changed)
+    version_ = next;
+
+  const bool full = since_version < 0 || since_version > version_;
+  EncodableList transceivers;
+  for (const auto& kv : entries_) {
+    EncodableMap info;
+    std::map<std::string, EncodableMap> sections;
+    for (const auto& field : kv.second.fields) {
+      if (!full && field.second.version <= since_version)
+        continue;
+      const std::string& section = field.first.first;
+      if (section.empty()) {
+        info[EncodableValue(field.first.second)] = field.second.value;
+      } else {
+        sections[section][EncodableValue(field.first.second)] =
+            field.second.value;
+      }
+    }
+    if (info.empty() && sections.empty())
+      continue;
+    for (auto& section : sections) {
+      // Always say which sender/receiver a partial section belongs to.
+      const char* id_field = SectionIdField(section.first);
+      auto id = kv.second.fields.find(FieldKey(section.first, id_field));
+      if (id != kv.second.fields.end())
+        section.second[EncodableValue(id_field)] = id->second.value;
+      info[EncodableValue(section.first)] =
+          EncodableValue(std::move(section.second));
+    }
+    info[EncodableValue("transceiverId")] = EncodableValue(kv.first);
+    transceivers.push_back(EncodableValue(std::move(info)));
+  }
+
+  EncodableList removed;
+  if (!full) {
+    for (const auto& kv : removed_) {
+      if (kv.second > since_version)
+        removed.push_back(EncodableValue(kv.first));
+    }
+  }
+
+  EncodableMap params;
+  params[EncodableValue("version")] = EncodableValue(version_);
+  params[EncodableValue("full")] = EncodableValue(full);
+  params[EncodableValue("transceivers")] = EncodableValue(transceivers);
+  params[EncodableValue("removed")] = EncodableValue(removed);
+  return params;
+}
+
+}  // namespace flutter_webrtc_plus_plugin
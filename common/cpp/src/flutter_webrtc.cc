@@ -2,6 +2,8 @@
 
 #include "flutter_webrtc_plus/flutter_web_r_t_c_plugin.h"
 
+#include <algorithm>
+
 namespace flutter_webrtc_plus_plugin {
 
 FlutterWebRTC::FlutterWebRTC(FlutterWebRTCPlugin* plugin)
@@ -17,1321 +19,2103 @@ FlutterWebRTC::FlutterWebRTC(FlutterWebRTCPlugin* plugin)
 
 FlutterWebRTC::~FlutterWebRTC() {}
 
+const std::unordered_map<std::string, FlutterWebRTC::MethodHandler>&
+FlutterWebRTC::MethodHandlers() {
+  // Built once; a hash lookup replaces the linear chain of string compares
+  // this dispatcher used to walk on every call.
+  static const std::unordered_map<std::string, MethodHandler> handlers = {
+      {"initialize", &FlutterWebRTC::HandleInitialize},
+      {"createPeerConnection", &FlutterWebRTC::HandleCreatePeerConnection},
+      {"configurePeerConnectionPool",
+       &FlutterWebRTC::HandleConfigurePeerConnectionPool},
+      {"peerConnectionPoolStats",
+       &FlutterWebRTC::HandlePeerConnectionPoolStats},
+      {"peerConnectionPoolBenchmark",
+       &FlutterWebRTC::HandlePeerConnectionPoolBenchmark},
+      {"registryStressTest", &FlutterWebRTC::HandleRegistryStressTest},
+      {"remoteTrackLookupBenchmark",
+       &FlutterWebRTC::HandleRemoteTrackLookupBenchmark},
+      {"methodDispatchBenchmark",
+       &FlutterWebRTC::HandleMethodDispatchBenchmark},
+      {"codecBenchmark", &FlutterWebRTC::HandleCodecBenchmark},
+      {"getUserMedia", &FlutterWebRTC::HandleGetUserMedia},
+      {"getDisplayMedia", &FlutterWebRTC::HandleGetDisplayMedia},
+      {"getDesktopSources", &FlutterWebRTC::HandleGetDesktopSources},
+      {"updateDesktopSources", &FlutterWebRTC::HandleUpdateDesktopSources},
+      {"getDesktopSourceThumbnail",
+       &FlutterWebRTC::HandleGetDesktopSourceThumbnail},
+      {"getSources", &FlutterWebRTC::HandleGetSources},
+      {"selectAudioInput", &FlutterWebRTC::HandleSelectAudioInput},
+      {"selectAudioOutput", &FlutterWebRTC::HandleSelectAudioOutput},
+      {"mediaStreamGetTracks", &FlutterWebRTC::HandleMediaStreamGetTracks},
+      {"createOffer", &FlutterWebRTC::HandleCreateOffer},
+      {"createAnswer", &FlutterWebRTC::HandleCreateAnswer},
+      {"addStream", &FlutterWebRTC::HandleAddStream},
+      {"removeStream", &FlutterWebRTC::HandleRemoveStream},
+      {"setLocalDescription", &FlutterWebRTC::HandleSetLocalDescription},
+      {"setRemoteDescription", &FlutterWebRTC::HandleSetRemoteDescription},
+      {"addCandidate", &FlutterWebRTC::HandleAddCandidate},
+      {"addCandidates", &FlutterWebRTC::HandleAddCandidates},
+      {"peerConnectionSetIceCandidateBatching",
+       &FlutterWebRTC::HandlePeerConnectionSetIceCandidateBatching},
+      {"getStats", &FlutterWebRTC::HandleGetStats},
+      {"getStatsForAll", &FlutterWebRTC::HandleGetStatsForAll},
+      {"peerConnectionStartStatsStream",
+       &FlutterWebRTC::HandlePeerConnectionStartStatsStream},
+      {"peerConnectionStopStatsStream",
+       &FlutterWebRTC::HandlePeerConnectionStopStatsStream},
+      {"peerConnectionStartStatsRecording",
+       &FlutterWebRTC::HandlePeerConnectionStartStatsRecording},
+      {"peerConnectionStopStatsRecording",
+       &FlutterWebRTC::HandlePeerConnectionStopStatsRecording},
+      {"exportStatsRecording", &FlutterWebRTC::HandleExportStatsRecording},
+      {"createDataChannel", &FlutterWebRTC::HandleCreateDataChannel},
+      {"dataChannelSend", &FlutterWebRTC::HandleDataChannelSend},
+      {"dataChannelSendBatch", &FlutterWebRTC::HandleDataChannelSendBatch},
+      {"dataChannelGetBufferedAmount",
+       &FlutterWebRTC::HandleDataChannelGetBufferedAmount},
+      {"dataChannelSetSendQueueWatermarks",
+       &FlutterWebRTC::HandleDataChannelSetSendQueueWatermarks},
+      {"dataChannelSendFile", &FlutterWebRTC::HandleDataChannelSendFile},
+      {"dataChannelWriteToFile", &FlutterWebRTC::HandleDataChannelWriteToFile},
+      {"dataChannelSetReceiveBatching",
+       &FlutterWebRTC::HandleDataChannelSetReceiveBatching},
+      {"dataChannelBenchmark", &FlutterWebRTC::HandleDataChannelBenchmark},
+      {"dataChannelClose", &FlutterWebRTC::HandleDataChannelClose},
+      {"streamDispose", &FlutterWebRTC::HandleStreamDispose},
+      {"mediaStreamTrackSetEnable",
+       &FlutterWebRTC::HandleMediaStreamTrackSetEnable},
+      {"trackDispose", &FlutterWebRTC::HandleTrackDispose},
+      {"restartIce", &FlutterWebRTC::HandleRestartIce},
+      {"peerConnectionClose", &FlutterWebRTC::HandlePeerConnectionClose},
+      {"peerConnectionDispose", &FlutterWebRTC::HandlePeerConnectionDispose},
+      {"createVideoRenderer", &FlutterWebRTC::HandleCreateVideoRenderer},
+      {"videoRendererDispose", &FlutterWebRTC::HandleVideoRendererDispose},
+      {"videoRendererSetSrcObject",
+       &FlutterWebRTC::HandleVideoRendererSetSrcObject},
+      {"mediaStreamTrackSwitchCamera",
+       &FlutterWebRTC::HandleMediaStreamTrackSwitchCamera},
+      {"setVolume", &FlutterWebRTC::HandleSetVolume},
+      {"getLocalDescription", &FlutterWebRTC::HandleGetLocalDescription},
+      {"getRemoteDescription", &FlutterWebRTC::HandleGetRemoteDescription},
+      {"mediaStreamAddTrack", &FlutterWebRTC::HandleMediaStreamAddTrack},
+      {"mediaStreamRemoveTrack", &FlutterWebRTC::HandleMediaStreamRemoveTrack},
+      {"addTrack", &FlutterWebRTC::HandleAddTrack},
+      {"removeTrack", &FlutterWebRTC::HandleRemoveTrack},
+      {"addTransceiver", &FlutterWebRTC::HandleAddTransceiver},
+      {"getTransceivers", &FlutterWebRTC::HandleGetTransceivers},
+      {"getReceivers", &FlutterWebRTC::HandleGetReceivers},
+      {"getSenders", &FlutterWebRTC::HandleGetSenders},
+      {"rtpSenderSetTrack", &FlutterWebRTC::HandleRtpSenderSetTrack},
+      {"rtpSenderSetStreams", &FlutterWebRTC::HandleRtpSenderSetStreams},
+      {"rtpSenderReplaceTrack", &FlutterWebRTC::HandleRtpSenderReplaceTrack},
+      {"rtpSenderSetParameters", &FlutterWebRTC::HandleRtpSenderSetParameters},
+      {"rtpTransceiverStop", &FlutterWebRTC::HandleRtpTransceiverStop},
+      {"rtpTransceiverGetCurrentDirection",
+       &FlutterWebRTC::HandleRtpTransceiverGetCurrentDirection},
+      {"rtpTransceiverSetDirection",
+       &FlutterWebRTC::HandleRtpTransceiverSetDirection},
+      {"setConfiguration", &FlutterWebRTC::HandleSetConfiguration},
+      {"captureFrame", &FlutterWebRTC::HandleCaptureFrame},
+      {"createLocalMediaStream", &FlutterWebRTC::HandleCreateLocalMediaStream},
+      {"canInsertDtmf", &FlutterWebRTC::HandleCanInsertDtmf},
+      {"sendDtmf", &FlutterWebRTC::HandleSendDtmf},
+      {"getRtpSenderCapabilities",
+       &FlutterWebRTC::HandleGetRtpSenderCapabilities},
+      {"getRtpReceiverCapabilities",
+       &FlutterWebRTC::HandleGetRtpReceiverCapabilities},
+      {"setCodecPreferences", &FlutterWebRTC::HandleSetCodecPreferences},
+      {"getSignalingState", &FlutterWebRTC::HandleGetSignalingState},
+      {"getIceGatheringState", &FlutterWebRTC::HandleGetIceGatheringState},
+      {"getIceConnectionState", &FlutterWebRTC::HandleGetIceConnectionState},
+      {"getConnectionState", &FlutterWebRTC::HandleGetConnectionState},
+      {"setThinValue", &FlutterWebRTC::HandleSetThinValue},
+      {"setBigEyeValue", &FlutterWebRTC::HandleSetBigEyeValue},
+      {"setSmoothValue", &FlutterWebRTC::HandleSetSmoothValue},
+      {"setLipstickValue", &FlutterWebRTC::HandleSetLipstickValue},
+      {"setBlusherValue", &FlutterWebRTC::HandleSetBlusherValue},
+      {"setWhiteValue", &FlutterWebRTC::HandleSetWhiteValue},
+  };
+  return handlers;
+}
+
 void FlutterWebRTC::HandleMethodCall(
     const MethodCallProxy& method_call,
     std::unique_ptr<MethodResultProxy> result) {
-  if (method_call.method_name().compare("initialize") == 0) {
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const EncodableMap options = findMap(params, "options");
-    result->Success();
-  } else if (method_call.method_name().compare("createPeerConnection") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const EncodableMap configuration = findMap(params, "configuration");
-    const EncodableMap constraints = findMap(params, "constraints");
-    CreateRTCPeerConnection(configuration, constraints, std::move(result));
-  } else if (method_call.method_name().compare("getUserMedia") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const EncodableMap constraints = findMap(params, "constraints");
-    GetUserMedia(constraints, std::move(result));
-  } else if (method_call.method_name().compare("getDisplayMedia") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const EncodableMap constraints = findMap(params, "constraints");
-
-    GetDisplayMedia(constraints, std::move(result));
-  } else if (method_call.method_name().compare("getDesktopSources") == 0) {
-    // types: ["screen", "window"]
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Bad arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+  const auto& handlers = MethodHandlers();
+  auto it = handlers.find(method_call.method_name());
+  if (it != handlers.end()) {
+    (this->*(it->second))(method_call, std::move(result));
+    return;
+  }
 
-    const EncodableList types = findList(params, "types");
-    if (types.empty()) {
-      result->Error("Bad Arguments", "Types is required");
-      return;
-    }
-    GetDesktopSources(types, std::move(result));
-  } else if (method_call.method_name().compare("updateDesktopSources") == 0) {
-    // types: ["screen", "window"]
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Bad arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+  if (HandleFrameCryptorMethodCall(method_call, std::move(result), &result)) {
+    return;
+  } else {
+    result->NotImplemented();
+  }
+}
 
-    const EncodableList types = findList(params, "types");
-    if (types.empty()) {
-      result->Error("Bad Arguments", "Types is required");
-      return;
-    }
-    UpdateDesktopSources(types, std::move(result));
-  } else if (method_call.method_name().compare("getDesktopSourceThumbnail") ==
-             0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Bad arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+void FlutterWebRTC::HandleInitialize(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  result->Success();
+}
 
-    std::string sourceId = findString(params, "sourceId");
-    if (sourceId.empty()) {
-      result->Error("Bad Arguments", "Incorrect sourceId");
-      return;
-    }
-    const EncodableMap thumbnailSize = findMap(params, "thumbnailSize");
-    if (!thumbnailSize.empty()) {
-      int width = 0;
-      int height = 0;
-      GetDesktopSourceThumbnail(sourceId, width, height, std::move(result));
-    } else {
-      result->Error("Bad Arguments", "Bad arguments received");
-    }
-  } else if (method_call.method_name().compare("getSources") == 0) {
-    GetSources(std::move(result));
-  } else if (method_call.method_name().compare("selectAudioInput") == 0) {
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string deviceId = findString(params, "deviceId");
-    SelectAudioInput(deviceId, std::move(result));
-  } else if (method_call.method_name().compare("selectAudioOutput") == 0) {
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string deviceId = findString(params, "deviceId");
-    SelectAudioOutput(deviceId, std::move(result));
-  } else if (method_call.method_name().compare("mediaStreamGetTracks") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string streamId = findString(params, "streamId");
-    MediaStreamGetTracks(streamId, std::move(result));
-  } else if (method_call.method_name().compare("createOffer") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap constraints = findMap(params, "constraints");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("createOfferFailed",
-                    "createOffer() peerConnection is null");
-      return;
-    }
-    CreateOffer(constraints, pc, std::move(result));
-  } else if (method_call.method_name().compare("createAnswer") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap constraints = findMap(params, "constraints");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("createAnswerFailed",
-                    "createAnswer() peerConnection is null");
-      return;
-    }
-    CreateAnswer(constraints, pc, std::move(result));
-  } else if (method_call.method_name().compare("addStream") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string streamId = findString(params, "streamId");
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    scoped_refptr<RTCMediaStream> stream = MediaStreamForId(streamId);
-    if (!stream) {
-      result->Error("addStreamFailed", "addStream() stream not found!");
-      return;
-    }
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("addStreamFailed", "addStream() peerConnection is null");
-      return;
-    }
-    pc->AddStream(stream);
-    result->Success();
-  } else if (method_call.method_name().compare("removeStream") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string streamId = findString(params, "streamId");
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    scoped_refptr<RTCMediaStream> stream = MediaStreamForId(streamId);
-    if (!stream) {
-      result->Error("removeStreamFailed", "removeStream() stream not found!");
-      return;
-    }
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("removeStreamFailed",
-                    "removeStream() peerConnection is null");
-      return;
-    }
-    pc->RemoveStream(stream);
-    result->Success();
-  } else if (method_call.method_name().compare("setLocalDescription") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap constraints = findMap(params, "description");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("setLocalDescriptionFailed",
-                    "setLocalDescription() peerConnection is null");
-      return;
-    }
+void FlutterWebRTC::HandleCreatePeerConnection(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const EncodableMap& configuration = findMap(params, "configuration");
+  const EncodableMap& constraints = findMap(params, "constraints");
+  CreateRTCPeerConnection(configuration, constraints, std::move(result));
+}
 
-    SdpParseError error;
-    scoped_refptr<RTCSessionDescription> description =
-        RTCSessionDescription::Create(findString(constraints, "type").c_str(),
-                                      findString(constraints, "sdp").c_str(),
-                                      &error);
+void FlutterWebRTC::HandleConfigurePeerConnectionPool(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  ConfigurePeerConnectionPool(params, std::move(result));
+}
 
-    if (description.get() != nullptr) {
-      SetLocalDescription(description.get(), pc, std::move(result));
-    } else {
-      result->Error("setLocalDescriptionFailed", "Invalid type or sdp");
-    }
-  } else if (method_call.method_name().compare("setRemoteDescription") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap constraints = findMap(params, "description");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("setRemoteDescriptionFailed",
-                    "setRemoteDescription() peerConnection is null");
-      return;
-    }
+void FlutterWebRTC::HandlePeerConnectionPoolStats(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  PeerConnectionPoolStats(std::move(result));
+}
 
-    SdpParseError error;
-    scoped_refptr<RTCSessionDescription> description =
-        RTCSessionDescription::Create(findString(constraints, "type").c_str(),
-                                      findString(constraints, "sdp").c_str(),
-                                      &error);
+void FlutterWebRTC::HandlePeerConnectionPoolBenchmark(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  PeerConnectionPoolBenchmark(params, std::move(result));
+}
 
-    if (description.get() != nullptr) {
-      SetRemoteDescription(description.get(), pc, std::move(result));
-    } else {
-      result->Error("setRemoteDescriptionFailed", "Invalid type or sdp");
-    }
-  } else if (method_call.method_name().compare("addCandidate") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap constraints = findMap(params, "candidate");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("addCandidateFailed",
-                    "addCandidate() peerConnection is null");
-      return;
-    }
+// Upper bounds for registryStressTest, which blocks the platform thread.
+static constexpr int kMaxRegistryStressThreads = 16;
+static constexpr int kMaxRegistryStressMs = 10000;
 
-    SdpParseError error;
-    std::string candidate = findString(constraints, "candidate");
-    if (candidate.empty()) {
-      // received the end-of-candidates
-      result->Success();
-      return;
-    }
-    int sdpMLineIndex = findInt(constraints, "sdpMLineIndex");
-    scoped_refptr<RTCIceCandidate> rtc_candidate = RTCIceCandidate::Create(
-        candidate.c_str(), findString(constraints, "sdpMid").c_str(),
-        sdpMLineIndex == -1 ? 0 : sdpMLineIndex, &error);
-
-    if (rtc_candidate.get() != nullptr) {
-      AddIceCandidate(rtc_candidate.get(), pc, std::move(result));
-    } else {
-      result->Error("addCandidateFailed", "Invalid candidate");
-    }
-  } else if (method_call.method_name().compare("getStats") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const std::string track_id = findString(params, "trackId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getStatsFailed", "getStats() peerConnection is null");
-      return;
-    }
-    GetStats(track_id, pc, std::move(result));
-  } else if (method_call.method_name().compare("createDataChannel") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("createDataChannelFailed",
-                    "createDataChannel() peerConnection is null");
-      return;
-    }
+void FlutterWebRTC::HandleRegistryStressTest(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  int writers = findInt(params, "writers");
+  int readers = findInt(params, "readers");
+  int duration_ms = findInt(params, "durationMs");
+  if (writers < 1 || writers > kMaxRegistryStressThreads || readers < 1 ||
+      readers > kMaxRegistryStressThreads) {
+    result->Error("registryStressTestFailed",
+                  "writers and readers must be between 1 and " +
+                      std::to_string(kMaxRegistryStressThreads));
+    return;
+  }
+  if (duration_ms <= 0 || duration_ms > kMaxRegistryStressMs) {
+    result->Error("registryStressTestFailed",
+                  "durationMs must be between 1 and " +
+                      std::to_string(kMaxRegistryStressMs));
+    return;
+  }
+  result->Success(EncodableValue(FlutterRegistryBenchmark::Stress(
+      this, factory_, writers, readers,
+      std::chrono::milliseconds(duration_ms))));
+}
 
-    const std::string label = findString(params, "label");
-    const EncodableMap dataChannelDict = findMap(params, "dataChannelDict");
+// Upper bounds for remoteTrackLookupBenchmark, which also runs on the
+// platform thread.
+static constexpr int kMaxLookupBenchmarkTracks = 5000;
+static constexpr int kMaxLookupBenchmarkRounds = 1000;
 
-    CreateDataChannel(peerConnectionId, label, dataChannelDict, pc,
-                      std::move(result));
-  } else if (method_call.method_name().compare("dataChannelSend") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("dataChannelSendFailed",
-                    "dataChannelSend() peerConnection is null");
-      return;
-    }
+void FlutterWebRTC::HandleRemoteTrackLookupBenchmark(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  int tracks = findInt(params, "tracks");
+  int tracks_per_peer = findInt(params, "tracksPerPeer");
+  int rounds = findInt(params, "rounds");
+  if (tracks < 1 || tracks > kMaxLookupBenchmarkTracks ||
+      tracks_per_peer < 1 || rounds < 1 ||
+      rounds > kMaxLookupBenchmarkRounds) {
+    result->Error("remoteTrackLookupBenchmarkFailed",
+                  "tracks must be between 1 and " +
+                      std::to_string(kMaxLookupBenchmarkTracks) +
+                      ", tracksPerPeer at least 1 and rounds between 1 and " +
+                      std::to_string(kMaxLookupBenchmarkRounds));
+    return;
+  }
+  result->Success(EncodableValue(FlutterRegistryBenchmark::RemoteTrackLookup(
+      this, factory_, tracks, tracks_per_peer, rounds)));
+}
 
-    const std::string dataChannelId = findString(params, "dataChannelId");
-    const std::string type = findString(params, "type");
-    const EncodableValue data = findEncodableValue(params, "data");
-    RTCDataChannel* data_channel = DataChannelForId(dataChannelId);
-    if (data_channel == nullptr) {
-      result->Error("dataChannelSendFailed",
-                    "dataChannelSend() data_channel is null");
-      return;
-    }
-    DataChannelSend(data_channel, type, data, std::move(result));
-  } else if (method_call.method_name().compare("dataChannelGetBufferedAmount") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("dataChannelGetBufferedAmountFailed",
-                    "dataChannelGetBufferedAmount() peerConnection is null");
-      return;
-    }
+static constexpr int kMaxDispatchBenchmarkRounds = 100000;
 
-    const std::string dataChannelId = findString(params, "dataChannelId");
-    RTCDataChannel* data_channel = DataChannelForId(dataChannelId);
-    if (data_channel == nullptr) {
-      result->Error("dataChannelGetBufferedAmountFailed",
-                    "dataChannelGetBufferedAmount() data_channel is null");
-      return;
-    }
-    DataChannelGetBufferedAmount(data_channel, std::move(result));
-  } else if (method_call.method_name().compare("dataChannelClose") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("dataChannelCloseFailed",
-                    "dataChannelClose() peerConnection is null");
-      return;
-    }
+void FlutterWebRTC::HandleMethodDispatchBenchmark(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  int rounds = findInt(params, "rounds");
+  if (rounds < 1 || rounds > kMaxDispatchBenchmarkRounds) {
+    result->Error("methodDispatchBenchmarkFailed",
+                  "rounds must be between 1 and " +
+                      std::to_string(kMaxDispatchBenchmarkRounds));
+    return;
+  }
 
-    const std::string dataChannelId = findString(params, "dataChannelId");
-    RTCDataChannel* data_channel = DataChannelForId(dataChannelId);
-    if (data_channel == nullptr) {
-      result->Error("dataChannelCloseFailed",
-                    "dataChannelClose() data_channel is null");
-      return;
-    }
-    DataChannelClose(data_channel, dataChannelId, std::move(result));
-  } else if (method_call.method_name().compare("streamDispose") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string stream_id = findString(params, "streamId");
-    MediaStreamDispose(stream_id, std::move(result));
-  } else if (method_call.method_name().compare("mediaStreamTrackSetEnable") ==
-             0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string track_id = findString(params, "trackId");
-    const EncodableValue enable = findEncodableValue(params, "enabled");
-    RTCMediaTrack* track = MediaTrackForId(track_id);
-    if (track != nullptr) {
-      track->set_enabled(GetValue<bool>(enable));
-    }
-    result->Success();
-  } else if (method_call.method_name().compare("trackDispose") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string track_id = findString(params, "trackId");
-    MediaStreamTrackDispose(track_id, std::move(result));
-  } else if (method_call.method_name().compare("restartIce") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("restartIceFailed", "restartIce() peerConnection is null");
-      return;
-    }
-    pc->RestartIce();
-    result->Success();
-  } else if (method_call.method_name().compare("peerConnectionClose") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("peerConnectionCloseFailed",
-                    "peerConnectionClose() peerConnection is null");
-      return;
-    }
-    RTCPeerConnectionClose(pc, peerConnectionId, std::move(result));
-  } else if (method_call.method_name().compare("peerConnectionDispose") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Success();
-      return;
-    }
-    RTCPeerConnectionDispose(pc, peerConnectionId, std::move(result));
-  } else if (method_call.method_name().compare("createVideoRenderer") == 0) {
-    CreateVideoRendererTexture(std::move(result));
-  } else if (method_call.method_name().compare("videoRendererDispose") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    int64_t texture_id = findLongInt(params, "textureId");
-    VideoRendererDispose(texture_id, std::move(result));
-  } else if (method_call.method_name().compare("videoRendererSetSrcObject") ==
-             0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string stream_id = findString(params, "streamId");
-    int64_t texture_id = findLongInt(params, "textureId");
-    const std::string owner_tag = findString(params, "ownerTag");
-    const std::string track_id = findString(params, "trackId");
-
-    VideoRendererSetSrcObject(texture_id, stream_id, owner_tag, track_id);
-    result->Success();
-  } else if (method_call.method_name().compare(
-                 "mediaStreamTrackSwitchCamera") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string track_id = findString(params, "trackId");
-    MediaStreamTrackSwitchCamera(track_id, std::move(result));
-  } else if (method_call.method_name().compare("setVolume") == 0) {
-    auto args = method_call.arguments();
-    if (!args) {
-      result->Error("Bad Arguments", "setVolume() Null arguments received");
-      return;
+  const auto& handlers = MethodHandlers();
+  const auto& cryptor_handlers = FrameCryptorMethodHandlers();
+  std::vector<std::string> names;
+  for (const auto& entry : handlers)
+    names.push_back(entry.first);
+  for (const auto& entry : cryptor_handlers)
+    names.push_back(entry.first);
+  names.push_back("unknownMethod");
+
+  // Each name takes the path HandleMethodCall does: this class's table
+  // first, then the frame cryptor one.
+  EncodableMap methods;
+  std::vector<double> samples_ns;
+  size_t found = 0;
+  for (const std::string& name : names) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+      if (handlers.find(name) != handlers.end() ||
+          cryptor_handlers.find(name) != cryptor_handlers.end()) {
+        found++;
+      }
     }
+    double ns = std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - start)
+                    .count() /
+                rounds;
+    methods[EncodableValue(name)] = EncodableValue(ns);
+    samples_ns.push_back(ns);
+  }
 
-    const EncodableMap params = GetValue<EncodableMap>(*args);
-    const std::string trackId = findString(params, "trackId");
-    const std::optional<double> volume = maybeFindDouble(params, "volume");
-
-    if (trackId.empty()) {
-      result->Error("Bad Arguments", "setVolume() Empty track provided");
-      return;
-    }
+  std::sort(samples_ns.begin(), samples_ns.end());
+  double total = 0;
+  for (double ns : samples_ns)
+    total += ns;
+  EncodableMap summary;
+  summary[EncodableValue("rounds")] = EncodableValue(rounds);
+  summary[EncodableValue("methods")] = EncodableValue(methods);
+  summary[EncodableValue("found")] =
+      EncodableValue(static_cast<int64_t>(found));
+  summary[EncodableValue("meanNs")] =
+      EncodableValue(total / samples_ns.size());
+  summary[EncodableValue("p50Ns")] =
+      EncodableValue(samples_ns[samples_ns.size() / 2]);
+  summary[EncodableValue("maxNs")] = EncodableValue(samples_ns.back());
+  result->Success(EncodableValue(summary));
+}
 
-    if (!volume.has_value()) {
-      result->Error("Bad Arguments", "setVolume() No volume provided");
-      return;
-    }
+static constexpr int kMaxCodecBenchmarkRounds = 10000;
 
-    if (volume.value() < 0) {
-      result->Error("Bad Arguments", "setVolume() Volume must be positive");
+void FlutterWebRTC::HandleCodecBenchmark(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  int rounds = findInt(params, "rounds");
+  if (rounds < 1 || rounds > kMaxCodecBenchmarkRounds) {
+    result->Error("codecBenchmarkFailed",
+                  "rounds must be between 1 and " +
+                      std::to_string(kMaxCodecBenchmarkRounds));
+    return;
+  }
+  EncodableMap payloads = FlutterCodecBenchmark::Run(rounds);
+  for (const auto& payload : payloads) {
+    const EncodableMap& stats = GetValue<EncodableMap>(payload.second);
+    if (!GetValue<bool>(stats.at(EncodableValue("roundTrip")))) {
+      result->Error("codecBenchmarkFailed",
+                    GetValue<std::string>(payload.first) +
+                        " did not decode to the value it was encoded from");
       return;
     }
+  }
+  result->Success(EncodableValue(payloads));
+}
 
-    RTCMediaTrack* track = MediaTrackForId(trackId);
-    if (nullptr == track) {
-      result->Error("setVolume", "setVolume() Unable to find provided track");
-      return;
-    }
+void FlutterWebRTC::HandleGetUserMedia(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const EncodableMap& constraints = findMap(params, "constraints");
+  GetUserMedia(constraints, std::move(result));
+}
 
-    std::string kind = track->kind().std_string();
-    if (0 != kind.compare("audio")) {
-      result->Error("setVolume",
-                    "setVolume() Only audio tracks can have volume set");
-      return;
-    }
+void FlutterWebRTC::HandleGetDisplayMedia(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const EncodableMap& constraints = findMap(params, "constraints");
 
-    auto audioTrack = static_cast<RTCAudioTrack*>(track);
-    audioTrack->SetVolume(volume.value());
+  GetDisplayMedia(constraints, std::move(result));
+}
 
-    result->Success();
-  } else if (method_call.method_name().compare("getLocalDescription") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap constraints = findMap(params, "description");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("GetLocalDescription",
-                    "GetLocalDescription() peerConnection is null");
-      return;
-    }
+void FlutterWebRTC::HandleGetDesktopSources(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  // types: ["screen", "window"]
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Bad arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
 
-    GetLocalDescription(pc, std::move(result));
-  } else if (method_call.method_name().compare("getRemoteDescription") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap constraints = findMap(params, "description");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("GetRemoteDescription",
-                    "GetRemoteDescription() peerConnection is null");
-      return;
-    }
+  const EncodableList& types = findList(params, "types");
+  if (types.empty()) {
+    result->Error("Bad Arguments", "Types is required");
+    return;
+  }
+  GetDesktopSources(types, std::move(result));
+}
 
-    GetRemoteDescription(pc, std::move(result));
-  } else if (method_call.method_name().compare("mediaStreamAddTrack") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+void FlutterWebRTC::HandleUpdateDesktopSources(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  // types: ["screen", "window"]
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Bad arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
 
-    const std::string streamId = findString(params, "streamId");
-    const std::string trackId = findString(params, "trackId");
+  const EncodableList& types = findList(params, "types");
+  if (types.empty()) {
+    result->Error("Bad Arguments", "Types is required");
+    return;
+  }
+  UpdateDesktopSources(types, std::move(result));
+}
 
-    scoped_refptr<RTCMediaStream> stream = MediaStreamForId(streamId);
-    if (stream == nullptr) {
-      result->Error("MediaStreamAddTrack",
-                    "MediaStreamAddTrack() stream is null");
-      return;
-    }
+void FlutterWebRTC::HandleGetDesktopSourceThumbnail(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Bad arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
 
-    scoped_refptr<RTCMediaTrack> track = MediaTracksForId(trackId);
-    if (track == nullptr) {
-      result->Error("MediaStreamAddTrack",
-                    "MediaStreamAddTrack() track is null");
-      return;
-    }
+  std::string sourceId = findString(params, "sourceId");
+  if (sourceId.empty()) {
+    result->Error("Bad Arguments", "Incorrect sourceId");
+    return;
+  }
+  const EncodableMap& thumbnailSize = findMap(params, "thumbnailSize");
+  if (!thumbnailSize.empty()) {
+    int width = 0;
+    int height = 0;
+    GetDesktopSourceThumbnail(sourceId, width, height, std::move(result));
+  } else {
+    result->Error("Bad Arguments", "Bad arguments received");
+  }
+}
 
-    MediaStreamAddTrack(stream, track, std::move(result));
-    std::string kind = track->kind().std_string();
-    for (int i = 0; i < renders_.size(); i++) {
-      FlutterVideoRenderer* renderer = renders_.at(i).get();
-      if (renderer->CheckMediaStream(streamId) && 0 == kind.compare("video")) {
-        renderer->SetVideoTrack(static_cast<RTCVideoTrack*>(track.get()));
-      }
-    }
-  } else if (method_call.method_name().compare("mediaStreamRemoveTrack") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+void FlutterWebRTC::HandleGetSources(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  GetSources(std::move(result));
+}
 
-    const std::string streamId = findString(params, "streamId");
-    const std::string trackId = findString(params, "trackId");
+void FlutterWebRTC::HandleSelectAudioInput(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string deviceId = findString(params, "deviceId");
+  SelectAudioInput(deviceId, std::move(result));
+}
 
-    scoped_refptr<RTCMediaStream> stream = MediaStreamForId(streamId);
-    if (stream == nullptr) {
-      result->Error("MediaStreamRemoveTrack",
-                    "MediaStreamRemoveTrack() stream is null");
-      return;
-    }
+void FlutterWebRTC::HandleSelectAudioOutput(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string deviceId = findString(params, "deviceId");
+  SelectAudioOutput(deviceId, std::move(result));
+}
 
-    scoped_refptr<RTCMediaTrack> track = MediaTracksForId(trackId);
-    if (track == nullptr) {
-      result->Error("MediaStreamRemoveTrack",
-                    "MediaStreamRemoveTrack() track is null");
-      return;
-    }
+void FlutterWebRTC::HandleMediaStreamGetTracks(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string streamId = findString(params, "streamId");
+  MediaStreamGetTracks(streamId, std::move(result));
+}
 
-    MediaStreamRemoveTrack(stream, track, std::move(result));
+void FlutterWebRTC::HandleCreateOffer(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  const EncodableMap& constraints = findMap(params, "constraints");
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("createOfferFailed",
+                  "createOffer() peerConnection is null");
+    return;
+  }
+  CreateOffer(constraints, pc, std::move(result));
+}
 
-    for (int i = 0; i < renders_.size(); i++) {
-      FlutterVideoRenderer* renderer = renders_.at(i).get();
-      if (renderer->CheckVideoTrack(streamId)) {
-        renderer->SetVideoTrack(nullptr);
-      }
-    }
-  } else if (method_call.method_name().compare("addTrack") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+void FlutterWebRTC::HandleCreateAnswer(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  const EncodableMap& constraints = findMap(params, "constraints");
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("createAnswerFailed",
+                  "createAnswer() peerConnection is null");
+    return;
+  }
+  CreateAnswer(constraints, pc, std::move(result));
+}
 
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const std::string trackId = findString(params, "trackId");
-    const EncodableList streamIds = findList(params, "streamIds");
+void FlutterWebRTC::HandleAddStream(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string streamId = findString(params, "streamId");
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+
+  scoped_refptr<RTCMediaStream> stream = MediaStreamForId(streamId);
+  if (!stream) {
+    result->Error("addStreamFailed", "addStream() stream not found!");
+    return;
+  }
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("addStreamFailed", "addStream() peerConnection is null");
+    return;
+  }
+  pc->AddStream(stream);
+  result->Success();
+}
 
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("AddTrack", "AddTrack() peerConnection is null");
-      return;
+void FlutterWebRTC::HandleRemoveStream(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string streamId = findString(params, "streamId");
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+
+  scoped_refptr<RTCMediaStream> stream = MediaStreamForId(streamId);
+  if (!stream) {
+    result->Error("removeStreamFailed", "removeStream() stream not found!");
+    return;
+  }
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("removeStreamFailed",
+                  "removeStream() peerConnection is null");
+    return;
+  }
+  pc->RemoveStream(stream);
+  result->Success();
+}
+
+void FlutterWebRTC::HandleSetLocalDescription(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  const EncodableMap& constraints = findMap(params, "description");
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("setLocalDescriptionFailed",
+                  "setLocalDescription() peerConnection is null");
+    return;
+  }
+
+  SdpParseError error;
+  scoped_refptr<RTCSessionDescription> description =
+      RTCSessionDescription::Create(findString(constraints, "type").c_str(),
+                                    findString(constraints, "sdp").c_str(),
+                                    &error);
+
+  if (description.get() != nullptr) {
+    SetLocalDescription(description.get(), pc, std::move(result));
+  } else {
+    result->Error("setLocalDescriptionFailed", "Invalid type or sdp");
+  }
+}
+
+void FlutterWebRTC::HandleSetRemoteDescription(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  const EncodableMap& constraints = findMap(params, "description");
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("setRemoteDescriptionFailed",
+                  "setRemoteDescription() peerConnection is null");
+    return;
+  }
+
+  SdpParseError error;
+  scoped_refptr<RTCSessionDescription> description =
+      RTCSessionDescription::Create(findString(constraints, "type").c_str(),
+                                    findString(constraints, "sdp").c_str(),
+                                    &error);
+
+  if (description.get() != nullptr) {
+    SetRemoteDescription(description.get(), pc, std::move(result));
+  } else {
+    result->Error("setRemoteDescriptionFailed", "Invalid type or sdp");
+  }
+}
+
+void FlutterWebRTC::HandleAddCandidate(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  const EncodableMap& constraints = findMap(params, "candidate");
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("addCandidateFailed",
+                  "addCandidate() peerConnection is null");
+    return;
+  }
+
+  SdpParseError error;
+  std::string candidate = findString(constraints, "candidate");
+  if (candidate.empty()) {
+    // received the end-of-candidates
+    result->Success();
+    return;
+  }
+  int sdpMLineIndex = findInt(constraints, "sdpMLineIndex");
+  scoped_refptr<RTCIceCandidate> rtc_candidate = RTCIceCandidate::Create(
+      candidate.c_str(), findString(constraints, "sdpMid").c_str(),
+      sdpMLineIndex == -1 ? 0 : sdpMLineIndex, &error);
+
+  if (rtc_candidate.get() != nullptr) {
+    AddIceCandidate(rtc_candidate.get(), pc, std::move(result));
+  } else {
+    result->Error("addCandidateFailed", "Invalid candidate");
+  }
+}
+
+void FlutterWebRTC::HandleAddCandidates(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("addCandidatesFailed",
+                  "addCandidates() peerConnection is null");
+    return;
+  }
+  AddIceCandidates(findList(params, "candidates"), pc, std::move(result));
+}
+
+void FlutterWebRTC::HandlePeerConnectionSetIceCandidateBatching(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  std::shared_ptr<FlutterPeerConnectionObserver> observer =
+      PeerConnectionObserversForId(peerConnectionId);
+  if (observer == nullptr) {
+    result->Error(
+        "peerConnectionSetIceCandidateBatchingFailed",
+        "peerConnectionSetIceCandidateBatching() peerConnection is null");
+    return;
+  }
+  SetIceCandidateBatching(observer.get(), params, std::move(result));
+}
+
+void FlutterWebRTC::HandleGetStats(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  const std::string track_id = findString(params, "trackId");
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("getStatsFailed", "getStats() peerConnection is null");
+    return;
+  }
+  GetStats(track_id, ParseStatsQuery(params), pc, std::move(result));
+}
+
+void FlutterWebRTC::HandleGetStatsForAll(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    GetStatsForAll(StatsQuery(), std::move(result));
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  GetStatsForAll(ParseStatsQuery(params), std::move(result));
+}
+
+void FlutterWebRTC::HandlePeerConnectionStartStatsStream(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  std::shared_ptr<FlutterPeerConnectionObserver> observer =
+      PeerConnectionObserversForId(peerConnectionId);
+  if (observer == nullptr) {
+    result->Error("peerConnectionStartStatsStreamFailed",
+                  "peerConnectionStartStatsStream() peerConnection is null");
+    return;
+  }
+  StartStatsStream(observer.get(), params, std::move(result));
+}
+
+void FlutterWebRTC::HandlePeerConnectionStopStatsStream(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  std::shared_ptr<FlutterPeerConnectionObserver> observer =
+      PeerConnectionObserversForId(peerConnectionId);
+  if (observer == nullptr) {
+    result->Error("peerConnectionStopStatsStreamFailed",
+                  "peerConnectionStopStatsStream() peerConnection is null");
+    return;
+  }
+  StopStatsStream(observer.get(), std::move(result));
+}
+
+void FlutterWebRTC::HandlePeerConnectionStartStatsRecording(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  std::shared_ptr<FlutterPeerConnectionObserver> observer =
+      PeerConnectionObserversForId(peerConnectionId);
+  if (observer == nullptr) {
+    result->Error("peerConnectionStartStatsRecordingFailed",
+                  "peerConnectionStartStatsRecording() peerConnection is null");
+    return;
+  }
+  StartStatsRecording(observer.get(), params, std::move(result));
+}
+
+void FlutterWebRTC::HandlePeerConnectionStopStatsRecording(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  std::shared_ptr<FlutterPeerConnectionObserver> observer =
+      PeerConnectionObserversForId(peerConnectionId);
+  if (observer == nullptr) {
+    result->Error("peerConnectionStopStatsRecordingFailed",
+                  "peerConnectionStopStatsRecording() peerConnection is null");
+    return;
+  }
+  StopStatsRecording(observer.get(), std::move(result));
+}
+
+void FlutterWebRTC::HandleExportStatsRecording(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  ExportStatsRecording(params, std::move(result));
+}
+
+void FlutterWebRTC::HandleCreateDataChannel(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("createDataChannelFailed",
+                  "createDataChannel() peerConnection is null");
+    return;
+  }
+
+  const std::string label = findString(params, "label");
+  const EncodableMap& dataChannelDict = findMap(params, "dataChannelDict");
+
+  CreateDataChannel(peerConnectionId, label, dataChannelDict, pc,
+                    std::move(result));
+}
+
+void FlutterWebRTC::HandleDataChannelSend(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("dataChannelSendFailed",
+                  "dataChannelSend() peerConnection is null");
+    return;
+  }
+
+  const std::string dataChannelId = findString(params, "dataChannelId");
+  const std::string type = findString(params, "type");
+  const EncodableValue& data = findEncodableValue(params, "data");
+  std::shared_ptr<FlutterRTCDataChannelObserver> observer =
+      DataChannelObserverForId(dataChannelId);
+  if (observer == nullptr) {
+    result->Error("dataChannelSendFailed",
+                  "dataChannelSend() data_channel is null");
+    return;
+  }
+  DataChannelSend(observer.get(), type, data, std::move(result));
+}
+
+void FlutterWebRTC::HandleDataChannelSendBatch(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("dataChannelSendBatchFailed",
+                  "dataChannelSendBatch() peerConnection is null");
+    return;
+  }
+
+  const std::string dataChannelId = findString(params, "dataChannelId");
+  std::shared_ptr<FlutterRTCDataChannelObserver> observer =
+      DataChannelObserverForId(dataChannelId);
+  if (observer == nullptr) {
+    result->Error("dataChannelSendBatchFailed",
+                  "dataChannelSendBatch() data_channel is null");
+    return;
+  }
+  DataChannelSendBatch(observer.get(), findList(params, "messages"),
+                       std::move(result));
+}
+
+void FlutterWebRTC::HandleDataChannelGetBufferedAmount(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("dataChannelGetBufferedAmountFailed",
+                  "dataChannelGetBufferedAmount() peerConnection is null");
+    return;
+  }
+
+  const std::string dataChannelId = findString(params, "dataChannelId");
+  std::shared_ptr<FlutterRTCDataChannelObserver> observer =
+      DataChannelObserverForId(dataChannelId);
+  if (observer == nullptr) {
+    result->Error("dataChannelGetBufferedAmountFailed",
+                  "dataChannelGetBufferedAmount() data_channel is null");
+    return;
+  }
+  DataChannelGetBufferedAmount(observer.get(), std::move(result));
+}
+
+void FlutterWebRTC::HandleDataChannelSetSendQueueWatermarks(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string dataChannelId = findString(params, "dataChannelId");
+  std::shared_ptr<FlutterRTCDataChannelObserver> observer =
+      DataChannelObserverForId(dataChannelId);
+  if (observer == nullptr) {
+    result->Error("dataChannelSetSendQueueWatermarksFailed",
+                  "dataChannelSetSendQueueWatermarks() data_channel is null");
+    return;
+  }
+  DataChannelSetSendQueueWatermarks(observer.get(), params, std::move(result));
+}
+
+void FlutterWebRTC::HandleDataChannelSendFile(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string dataChannelId = findString(params, "dataChannelId");
+  std::shared_ptr<FlutterRTCDataChannelObserver> observer =
+      DataChannelObserverForId(dataChannelId);
+  if (observer == nullptr) {
+    result->Error("dataChannelSendFileFailed",
+                  "dataChannelSendFile() data_channel is null");
+    return;
+  }
+  DataChannelSendFile(observer.get(), params, std::move(result));
+}
+
+void FlutterWebRTC::HandleDataChannelWriteToFile(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string dataChannelId = findString(params, "dataChannelId");
+  std::shared_ptr<FlutterRTCDataChannelObserver> observer =
+      DataChannelObserverForId(dataChannelId);
+  if (observer == nullptr) {
+    result->Error("dataChannelWriteToFileFailed",
+                  "dataChannelWriteToFile() data_channel is null");
+    return;
+  }
+  DataChannelWriteToFile(observer.get(), params, std::move(result));
+}
+
+void FlutterWebRTC::HandleDataChannelSetReceiveBatching(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string dataChannelId = findString(params, "dataChannelId");
+  std::shared_ptr<FlutterRTCDataChannelObserver> observer =
+      DataChannelObserverForId(dataChannelId);
+  if (observer == nullptr) {
+    result->Error("dataChannelSetReceiveBatchingFailed",
+                  "dataChannelSetReceiveBatching() data_channel is null");
+    return;
+  }
+  DataChannelSetReceiveBatching(observer.get(), params, std::move(result));
+}
+
+void FlutterWebRTC::HandleDataChannelBenchmark(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  DataChannelBenchmark(params, std::move(result));
+}
+
+void FlutterWebRTC::HandleDataChannelClose(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("dataChannelCloseFailed",
+                  "dataChannelClose() peerConnection is null");
+    return;
+  }
+
+  const std::string dataChannelId = findString(params, "dataChannelId");
+  scoped_refptr<RTCDataChannel> data_channel =
+      DataChannelForId(dataChannelId);
+  if (data_channel == nullptr) {
+    result->Error("dataChannelCloseFailed",
+                  "dataChannelClose() data_channel is null");
+    return;
+  }
+  DataChannelClose(data_channel, dataChannelId, std::move(result));
+}
+
+void FlutterWebRTC::HandleStreamDispose(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string stream_id = findString(params, "streamId");
+  MediaStreamDispose(stream_id, std::move(result));
+}
+
+void FlutterWebRTC::HandleMediaStreamTrackSetEnable(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string track_id = findString(params, "trackId");
+  const EncodableValue& enable = findEncodableValue(params, "enabled");
+  scoped_refptr<RTCMediaTrack> track = MediaTracksForId(track_id);
+  if (track != nullptr) {
+    track->set_enabled(GetValue<bool>(enable));
+  }
+  result->Success();
+}
+
+void FlutterWebRTC::HandleTrackDispose(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string track_id = findString(params, "trackId");
+  MediaStreamTrackDispose(track_id, std::move(result));
+}
+
+void FlutterWebRTC::HandleRestartIce(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("restartIceFailed", "restartIce() peerConnection is null");
+    return;
+  }
+  pc->RestartIce();
+  result->Success();
+}
+
+void FlutterWebRTC::HandlePeerConnectionClose(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("peerConnectionCloseFailed",
+                  "peerConnectionClose() peerConnection is null");
+    return;
+  }
+  RTCPeerConnectionClose(pc, peerConnectionId, std::move(result));
+}
+
+void FlutterWebRTC::HandlePeerConnectionDispose(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Success();
+    return;
+  }
+  RTCPeerConnectionDispose(pc, peerConnectionId, std::move(result));
+}
+
+void FlutterWebRTC::HandleCreateVideoRenderer(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  CreateVideoRendererTexture(std::move(result));
+}
+
+void FlutterWebRTC::HandleVideoRendererDispose(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  int64_t texture_id = findLongInt(params, "textureId");
+  VideoRendererDispose(texture_id, std::move(result));
+}
+
+void FlutterWebRTC::HandleVideoRendererSetSrcObject(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string stream_id = findString(params, "streamId");
+  int64_t texture_id = findLongInt(params, "textureId");
+  const std::string owner_tag = findString(params, "ownerTag");
+  const std::string track_id = findString(params, "trackId");
+
+  VideoRendererSetSrcObject(texture_id, stream_id, owner_tag, track_id);
+  result->Success();
+}
+
+void FlutterWebRTC::HandleMediaStreamTrackSwitchCamera(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string track_id = findString(params, "trackId");
+  MediaStreamTrackSwitchCamera(track_id, std::move(result));
+}
+
+void FlutterWebRTC::HandleSetVolume(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  auto args = method_call.arguments();
+  if (!args) {
+    result->Error("Bad Arguments", "setVolume() Null arguments received");
+    return;
+  }
+
+  const EncodableMap& params = GetValue<EncodableMap>(*args);
+  const std::string trackId = findString(params, "trackId");
+  const std::optional<double> volume = maybeFindDouble(params, "volume");
+
+  if (trackId.empty()) {
+    result->Error("Bad Arguments", "setVolume() Empty track provided");
+    return;
+  }
+
+  if (!volume.has_value()) {
+    result->Error("Bad Arguments", "setVolume() No volume provided");
+    return;
+  }
+
+  if (volume.value() < 0) {
+    result->Error("Bad Arguments", "setVolume() Volume must be positive");
+    return;
+  }
+
+  scoped_refptr<RTCMediaTrack> track = MediaTracksForId(trackId);
+  if (nullptr == track) {
+    result->Error("setVolume", "setVolume() Unable to find provided track");
+    return;
+  }
+
+  std::string kind = track->kind().std_string();
+  if (0 != kind.compare("audio")) {
+    result->Error("setVolume",
+                  "setVolume() Only audio tracks can have volume set");
+    return;
+  }
+
+  auto audioTrack = static_cast<RTCAudioTrack*>(track.get());
+  audioTrack->SetVolume(volume.value());
+
+  result->Success();
+}
+
+void FlutterWebRTC::HandleGetLocalDescription(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("GetLocalDescription",
+                  "GetLocalDescription() peerConnection is null");
+    return;
+  }
+
+  GetLocalDescription(pc, std::move(result));
+}
+
+void FlutterWebRTC::HandleGetRemoteDescription(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("GetRemoteDescription",
+                  "GetRemoteDescription() peerConnection is null");
+    return;
+  }
+
+  GetRemoteDescription(pc, std::move(result));
+}
+
+void FlutterWebRTC::HandleMediaStreamAddTrack(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+
+  const std::string streamId = findString(params, "streamId");
+  const std::string trackId = findString(params, "trackId");
+
+  scoped_refptr<RTCMediaStream> stream = MediaStreamForId(streamId);
+  if (stream == nullptr) {
+    result->Error("MediaStreamAddTrack",
+                  "MediaStreamAddTrack() stream is null");
+    return;
+  }
+
+  scoped_refptr<RTCMediaTrack> track = MediaTracksForId(trackId);
+  if (track == nullptr) {
+    result->Error("MediaStreamAddTrack",
+                  "MediaStreamAddTrack() track is null");
+    return;
+  }
+
+  MediaStreamAddTrack(stream, track, std::move(result));
+  std::string kind = track->kind().std_string();
+  for (int i = 0; i < renders_.size(); i++) {
+    FlutterVideoRenderer* renderer = renders_.at(i).get();
+    if (renderer->CheckMediaStream(streamId) && 0 == kind.compare("video")) {
+      renderer->SetVideoTrack(static_cast<RTCVideoTrack*>(track.get()));
     }
+  }
+}
 
-    scoped_refptr<RTCMediaTrack> track = MediaTracksForId(trackId);
-    if (track == nullptr) {
-      result->Error("AddTrack", "AddTrack() track is null");
-      return;
+void FlutterWebRTC::HandleMediaStreamRemoveTrack(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+
+  const std::string streamId = findString(params, "streamId");
+  const std::string trackId = findString(params, "trackId");
+
+  scoped_refptr<RTCMediaStream> stream = MediaStreamForId(streamId);
+  if (stream == nullptr) {
+    result->Error("MediaStreamRemoveTrack",
+                  "MediaStreamRemoveTrack() stream is null");
+    return;
+  }
+
+  scoped_refptr<RTCMediaTrack> track = MediaTracksForId(trackId);
+  if (track == nullptr) {
+    result->Error("MediaStreamRemoveTrack",
+                  "MediaStreamRemoveTrack() track is null");
+    return;
+  }
+
+  MediaStreamRemoveTrack(stream, track, std::move(result));
+
+  for (int i = 0; i < renders_.size(); i++) {
+    FlutterVideoRenderer* renderer = renders_.at(i).get();
+    if (renderer->CheckVideoTrack(streamId)) {
+      renderer->SetVideoTrack(nullptr);
     }
-    std::vector<std::string> ids;
-    for (EncodableValue value : streamIds) {
-      ids.push_back(GetValue<std::string>(value));
+  }
+}
+
+void FlutterWebRTC::HandleAddTrack(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  const std::string trackId = findString(params, "trackId");
+  const EncodableList& streamIds = findList(params, "streamIds");
+
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("AddTrack", "AddTrack() peerConnection is null");
+    return;
+  }
+
+  scoped_refptr<RTCMediaTrack> track = MediaTracksForId(trackId);
+  if (track == nullptr) {
+    result->Error("AddTrack", "AddTrack() track is null");
+    return;
+  }
+  std::vector<std::string> ids;
+  for (const EncodableValue& value : streamIds) {
+    ids.push_back(GetValue<std::string>(value));
+  }
+
+  AddTrack(pc, track, ids, std::move(result));
+}
+
+void FlutterWebRTC::HandleRemoveTrack(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  const std::string senderId = findString(params, "senderId");
+
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("removeTrack", "removeTrack() peerConnection is null");
+    return;
+  }
+
+  RemoveTrack(pc, senderId, std::move(result));
+}
+
+void FlutterWebRTC::HandleAddTransceiver(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  const EncodableMap& transceiverInit = findMap(params, "transceiverInit");
+  const std::string mediaType = findString(params, "mediaType");
+  const std::string trackId = findString(params, "trackId");
+
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("addTransceiver",
+                  "addTransceiver() peerConnection is null");
+    return;
+  }
+  AddTransceiver(pc, trackId, mediaType, transceiverInit, std::move(result));
+}
+
+void FlutterWebRTC::HandleGetTransceivers(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("getTransceivers",
+                  "getTransceivers() peerConnection is null");
+    return;
+  }
+
+  if (findEncodableValuePtr(params, "sinceVersion")) {
+    std::shared_ptr<FlutterPeerConnectionObserver> observer =
+        PeerConnectionObserversForId(peerConnectionId);
+    if (observer == nullptr) {
+      result->Error("getTransceivers",
+                    "getTransceivers() peerConnection is null");
+      return;
     }
+    GetTransceiverChanges(pc, observer.get(),
+                          findLongInt(params, "sinceVersion"),
+                          std::move(result));
+    return;
+  }
+
+  GetTransceivers(pc, std::move(result));
+}
+
+void FlutterWebRTC::HandleGetReceivers(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("getReceivers", "getReceivers() peerConnection is null");
+    return;
+  }
+
+  GetReceivers(pc, std::move(result));
+}
+
+void FlutterWebRTC::HandleGetSenders(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("getSenders", "getSenders() peerConnection is null");
+    return;
+  }
+
+  GetSenders(pc, std::move(result));
+}
 
-    AddTrack(pc, track, ids, std::move(result));
+void FlutterWebRTC::HandleRtpSenderSetTrack(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("rtpSenderSetTrack",
+                  "rtpSenderSetTrack() peerConnection is null");
+    return;
+  }
+
+  const std::string trackId = findString(params, "trackId");
+  scoped_refptr<RTCMediaTrack> track = MediaTracksForId(trackId);
+
+  const std::string rtpSenderId = findString(params, "rtpSenderId");
+  if (rtpSenderId.empty()) {
+    result->Error("rtpSenderSetTrack",
+                  "rtpSenderSetTrack() rtpSenderId is null or empty");
+    return;
+  }
+  RtpSenderSetTrack(pc, track, rtpSenderId, std::move(result));
+}
+
+void FlutterWebRTC::HandleRtpSenderSetStreams(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("rtpSenderSetStream",
+                  "rtpSenderSetStream() peerConnection is null");
+    return;
+  }
+
+  const EncodableList& encodableStreamIds = findList(params, "streamIds");
+  if (encodableStreamIds.empty()) {
+    result->Error("rtpSenderSetStream",
+                  "rtpSenderSetStream() streamId is null or empty");
+    return;
+  }
+  std::vector<std::string> streamIds{};
+  for (const EncodableValue& value : encodableStreamIds) {
+    streamIds.push_back(GetValue<std::string>(value));
+  }
+
+  const std::string rtpSenderId = findString(params, "rtpSenderId");
+  if (rtpSenderId.empty()) {
+    result->Error("rtpSenderSetStream",
+                  "rtpSenderSetStream() rtpSenderId is null or empty");
+    return;
+  }
+  RtpSenderSetStream(pc, streamIds, rtpSenderId, std::move(result));
+}
+
+void FlutterWebRTC::HandleRtpSenderReplaceTrack(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("rtpSenderReplaceTrack",
+                  "rtpSenderReplaceTrack() peerConnection is null");
+    return;
+  }
+
+  const std::string trackId = findString(params, "trackId");
+  scoped_refptr<RTCMediaTrack> track = MediaTracksForId(trackId);
+
+  const std::string rtpSenderId = findString(params, "rtpSenderId");
+  if (rtpSenderId.empty()) {
+    result->Error("rtpSenderReplaceTrack",
+                  "rtpSenderReplaceTrack() rtpSenderId is null or empty");
+    return;
+  }
+  RtpSenderReplaceTrack(pc, track, rtpSenderId, std::move(result));
+}
+
+void FlutterWebRTC::HandleRtpSenderSetParameters(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("rtpSenderSetParameters",
+                  "rtpSenderSetParameters() peerConnection is null");
+    return;
+  }
+
+  const std::string rtpSenderId = findString(params, "rtpSenderId");
+  if (rtpSenderId.empty()) {
+    result->Error("rtpSenderSetParameters",
+                  "rtpSenderSetParameters() rtpSenderId is null or empty");
+    return;
+  }
+
+  const EncodableMap& parameters = findMap(params, "parameters");
+  if (0 == parameters.size()) {
+    result->Error("rtpSenderSetParameters",
+                  "rtpSenderSetParameters() parameters is null or empty");
+    return;
+  }
+
+  RtpSenderSetParameters(pc, rtpSenderId, parameters, std::move(result));
+}
+
+void FlutterWebRTC::HandleRtpTransceiverStop(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("rtpTransceiverStop",
+                  "rtpTransceiverStop() peerConnection is null");
+    return;
+  }
+
+  const std::string transceiverId = findString(params, "transceiverId");
+  if (transceiverId.empty()) {
+    result->Error("rtpTransceiverStop",
+                  "rtpTransceiverStop() transceiverId is null or empty");
+    return;
+  }
 
-  } else if (method_call.method_name().compare("removeTrack") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+  RtpTransceiverStop(pc, transceiverId, std::move(result));
+}
 
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const std::string senderId = findString(params, "senderId");
+void FlutterWebRTC::HandleRtpTransceiverGetCurrentDirection(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error(
+        "rtpTransceiverGetCurrentDirection",
+        "rtpTransceiverGetCurrentDirection() peerConnection is null");
+    return;
+  }
 
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("removeTrack", "removeTrack() peerConnection is null");
-      return;
-    }
+  const std::string transceiverId = findString(params, "transceiverId");
+  if (transceiverId.empty()) {
+    result->Error("rtpTransceiverGetCurrentDirection",
+                  "rtpTransceiverGetCurrentDirection() transceiverId is "
+                  "null or empty");
+    return;
+  }
 
-    RemoveTrack(pc, senderId, std::move(result));
+  RtpTransceiverGetCurrentDirection(pc, transceiverId, std::move(result));
+}
 
-  } else if (method_call.method_name().compare("addTransceiver") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const EncodableMap transceiverInit = findMap(params, "transceiverInit");
-    const std::string mediaType = findString(params, "mediaType");
-    const std::string trackId = findString(params, "trackId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("addTransceiver",
-                    "addTransceiver() peerConnection is null");
-      return;
-    }
-    AddTransceiver(pc, trackId, mediaType, transceiverInit, std::move(result));
-  } else if (method_call.method_name().compare("getTransceivers") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
+void FlutterWebRTC::HandleRtpTransceiverSetDirection(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("rtpTransceiverSetDirection",
+                  "rtpTransceiverSetDirection() peerConnection is null");
+    return;
+  }
 
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getTransceivers",
-                    "getTransceivers() peerConnection is null");
-      return;
-    }
+  const std::string transceiverId = findString(params, "transceiverId");
+  if (transceiverId.empty()) {
+    result->Error("rtpTransceiverSetDirection",
+                  "rtpTransceiverSetDirection() transceiverId is "
+                  "null or empty");
+    return;
+  }
 
-    GetTransceivers(pc, std::move(result));
-  } else if (method_call.method_name().compare("getReceivers") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
+  const std::string direction = findString(params, "direction");
+  if (transceiverId.empty()) {
+    result->Error("rtpTransceiverSetDirection",
+                  "rtpTransceiverSetDirection() direction is null or empty");
+    return;
+  }
 
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getReceivers", "getReceivers() peerConnection is null");
-      return;
-    }
+  RtpTransceiverSetDirection(pc, transceiverId, direction, std::move(result));
+}
 
-    GetReceivers(pc, std::move(result));
+void FlutterWebRTC::HandleSetConfiguration(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("setConfiguration",
+                  "setConfiguration() peerConnection is null");
+    return;
+  }
 
-  } else if (method_call.method_name().compare("getSenders") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
+  const EncodableMap& configuration = findMap(params, "configuration");
+  if (configuration.empty()) {
+    result->Error("setConfiguration",
+                  "setConfiguration() configuration is null or empty");
+    return;
+  }
+  std::shared_ptr<FlutterPeerConnectionObserver> observer =
+      PeerConnectionObserversForId(peerConnectionId);
+  if (observer == nullptr) {
+    result->Error("setConfiguration",
+                  "setConfiguration() peerConnection is null");
+    return;
+  }
+  SetConfiguration(pc, observer.get(), configuration,
+                   findBoolean(params, "iceRestart"), std::move(result));
+}
 
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getSenders", "getSenders() peerConnection is null");
-      return;
-    }
+void FlutterWebRTC::HandleCaptureFrame(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
 
-    GetSenders(pc, std::move(result));
-  } else if (method_call.method_name().compare("rtpSenderSetTrack") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("rtpSenderSetTrack",
-                    "rtpSenderSetTrack() peerConnection is null");
-      return;
-    }
+  const std::string path = findString(params, "path");
+  if (path.empty()) {
+    result->Error("captureFrame", "captureFrame() path is null or empty");
+    return;
+  }
 
-    const std::string trackId = findString(params, "trackId");
-    RTCMediaTrack* track = MediaTrackForId(trackId);
+  const std::string trackId = findString(params, "trackId");
+  scoped_refptr<RTCMediaTrack> track = MediaTracksForId(trackId);
+  if (nullptr == track) {
+    result->Error("captureFrame", "captureFrame() track is null");
+    return;
+  }
+  std::string kind = track->kind().std_string();
+  if (0 != kind.compare("video")) {
+    result->Error("captureFrame", "captureFrame() track not is video track");
+    return;
+  }
+  CaptureFrame(reinterpret_cast<RTCVideoTrack*>(track.get()), path,
+               std::move(result));
+}
 
-    const std::string rtpSenderId = findString(params, "rtpSenderId");
-    if (rtpSenderId.empty()) {
-      result->Error("rtpSenderSetTrack",
-                    "rtpSenderSetTrack() rtpSenderId is null or empty");
-      return;
-    }
-    RtpSenderSetTrack(pc, track, rtpSenderId, std::move(result));
-  } else if (method_call.method_name().compare("rtpSenderSetStreams") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("rtpSenderSetStream",
-                    "rtpSenderSetStream() peerConnection is null");
-      return;
-    }
+void FlutterWebRTC::HandleCreateLocalMediaStream(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  CreateLocalMediaStream(std::move(result));
+}
 
-    const EncodableList encodableStreamIds = findList(params, "streamIds");
-    if (encodableStreamIds.empty()) {
-      result->Error("rtpSenderSetStream",
-                    "rtpSenderSetStream() streamId is null or empty");
-      return;
-    }
-    std::vector<std::string> streamIds{};
-    for (EncodableValue value : encodableStreamIds) {
-      streamIds.push_back(GetValue<std::string>(value));
-    }
+void FlutterWebRTC::HandleCanInsertDtmf(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  const std::string rtpSenderId = findString(params, "rtpSenderId");
+
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("canInsertDtmf", "canInsertDtmf() peerConnection is null");
+    return;
+  }
 
-    const std::string rtpSenderId = findString(params, "rtpSenderId");
-    if (rtpSenderId.empty()) {
-      result->Error("rtpSenderSetStream",
-                    "rtpSenderSetStream() rtpSenderId is null or empty");
-      return;
-    }
-    RtpSenderSetStream(pc, streamIds, rtpSenderId, std::move(result));
-  } else if (method_call.method_name().compare("rtpSenderReplaceTrack") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("rtpSenderReplaceTrack",
-                    "rtpSenderReplaceTrack() peerConnection is null");
-      return;
-    }
+  auto rtpSender = GetRtpSenderById(pc, rtpSenderId);
 
-    const std::string trackId = findString(params, "trackId");
-    RTCMediaTrack* track = MediaTrackForId(trackId);
+  if (rtpSender == nullptr) {
+    result->Error("sendDtmf", "sendDtmf() rtpSender is null");
+    return;
+  }
+  auto dtmfSender = rtpSender->dtmf_sender();
+  bool canInsertDtmf = dtmfSender->CanInsertDtmf();
 
-    const std::string rtpSenderId = findString(params, "rtpSenderId");
-    if (rtpSenderId.empty()) {
-      result->Error("rtpSenderReplaceTrack",
-                    "rtpSenderReplaceTrack() rtpSenderId is null or empty");
-      return;
-    }
-    RtpSenderReplaceTrack(pc, track, rtpSenderId, std::move(result));
-  } else if (method_call.method_name().compare("rtpSenderSetParameters") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("rtpSenderSetParameters",
-                    "rtpSenderSetParameters() peerConnection is null");
-      return;
-    }
+  result->Success(EncodableValue(canInsertDtmf));
+}
 
-    const std::string rtpSenderId = findString(params, "rtpSenderId");
-    if (rtpSenderId.empty()) {
-      result->Error("rtpSenderSetParameters",
-                    "rtpSenderSetParameters() rtpSenderId is null or empty");
-      return;
-    }
+void FlutterWebRTC::HandleSendDtmf(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  const std::string rtpSenderId = findString(params, "rtpSenderId");
+  const std::string tone = findString(params, "tone");
+  int duration = findInt(params, "duration");
+  int gap = findInt(params, "gap");
+
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("sendDtmf", "sendDtmf() peerConnection is null");
+    return;
+  }
 
-    const EncodableMap parameters = findMap(params, "parameters");
-    if (0 == parameters.size()) {
-      result->Error("rtpSenderSetParameters",
-                    "rtpSenderSetParameters() parameters is null or empty");
-      return;
-    }
+  auto rtpSender = GetRtpSenderById(pc, rtpSenderId);
 
-    RtpSenderSetParameters(pc, rtpSenderId, parameters, std::move(result));
-  } else if (method_call.method_name().compare("rtpTransceiverStop") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("rtpTransceiverStop",
-                    "rtpTransceiverStop() peerConnection is null");
-      return;
-    }
+  if (rtpSender == nullptr) {
+    result->Error("sendDtmf", "sendDtmf() rtpSender is null");
+    return;
+  }
 
-    const std::string transceiverId = findString(params, "transceiverId");
-    if (transceiverId.empty()) {
-      result->Error("rtpTransceiverStop",
-                    "rtpTransceiverStop() transceiverId is null or empty");
-      return;
-    }
+  auto dtmfSender = rtpSender->dtmf_sender();
+  dtmfSender->InsertDtmf(tone, duration, gap);
 
-    RtpTransceiverStop(pc, transceiverId, std::move(result));
-  } else if (method_call.method_name().compare(
-                 "rtpTransceiverGetCurrentDirection") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error(
-          "rtpTransceiverGetCurrentDirection",
-          "rtpTransceiverGetCurrentDirection() peerConnection is null");
-      return;
-    }
+  result->Success();
+}
 
-    const std::string transceiverId = findString(params, "transceiverId");
-    if (transceiverId.empty()) {
-      result->Error("rtpTransceiverGetCurrentDirection",
-                    "rtpTransceiverGetCurrentDirection() transceiverId is "
-                    "null or empty");
-      return;
-    }
+void FlutterWebRTC::HandleGetRtpSenderCapabilities(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+
+  RTCMediaType mediaType = RTCMediaType::AUDIO;
+  const std::string kind = findString(params, "kind");
+  if (0 == kind.compare("video")) {
+    mediaType = RTCMediaType::VIDEO;
+  } else if (0 == kind.compare("audio")) {
+    mediaType = RTCMediaType::AUDIO;
+  } else {
+    result->Error("getRtpSenderCapabilities",
+                  "getRtpSenderCapabilities() kind is null or empty");
+    return;
+  }
+  auto capabilities = factory_->GetRtpSenderCapabilities(mediaType);
+  EncodableMap map;
+  EncodableList codecsList;
+  for (auto codec : capabilities->codecs().std_vector()) {
+    EncodableMap codecMap;
+    codecMap[EncodableValue("mimeType")] =
+        EncodableValue(codec->mime_type().std_string());
+    codecMap[EncodableValue("clockRate")] =
+        EncodableValue(codec->clock_rate());
+    codecMap[EncodableValue("channels")] = EncodableValue(codec->channels());
+    codecMap[EncodableValue("sdpFmtpLine")] =
+        EncodableValue(codec->sdp_fmtp_line().std_string());
+    codecsList.push_back(EncodableValue(codecMap));
+  }
+  map[EncodableValue("codecs")] = EncodableValue(codecsList);
+  map[EncodableValue("headerExtensions")] = EncodableValue(EncodableList());
+  map[EncodableValue("fecMechanisms")] = EncodableValue(EncodableList());
 
-    RtpTransceiverGetCurrentDirection(pc, transceiverId, std::move(result));
-  } else if (method_call.method_name().compare("rtpTransceiverSetDirection") ==
-             0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("rtpTransceiverSetDirection",
-                    "rtpTransceiverSetDirection() peerConnection is null");
-      return;
-    }
+  result->Success(EncodableValue(map));
+}
 
-    const std::string transceiverId = findString(params, "transceiverId");
-    if (transceiverId.empty()) {
-      result->Error("rtpTransceiverSetDirection",
-                    "rtpTransceiverSetDirection() transceiverId is "
-                    "null or empty");
-      return;
-    }
+void FlutterWebRTC::HandleGetRtpReceiverCapabilities(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+
+  RTCMediaType mediaType = RTCMediaType::AUDIO;
+  const std::string kind = findString(params, "kind");
+  if (0 == kind.compare("video")) {
+    mediaType = RTCMediaType::VIDEO;
+  } else if (0 == kind.compare("audio")) {
+    mediaType = RTCMediaType::AUDIO;
+  } else {
+    result->Error("getRtpSenderCapabilities",
+                  "getRtpSenderCapabilities() kind is null or empty");
+    return;
+  }
+  auto capabilities = factory_->GetRtpReceiverCapabilities(mediaType);
+  EncodableMap map;
+  EncodableList codecsList;
+  for (auto codec : capabilities->codecs().std_vector()) {
+    EncodableMap codecMap;
+    codecMap[EncodableValue("mimeType")] =
+        EncodableValue(codec->mime_type().std_string());
+    codecMap[EncodableValue("clockRate")] =
+        EncodableValue(codec->clock_rate());
+    codecMap[EncodableValue("channels")] = EncodableValue(codec->channels());
+    codecMap[EncodableValue("sdpFmtpLine")] =
+        EncodableValue(codec->sdp_fmtp_line().std_string());
+    codecsList.push_back(EncodableValue(codecMap));
+  }
+  map[EncodableValue("codecs")] = EncodableValue(codecsList);
+  map[EncodableValue("headerExtensions")] = EncodableValue(EncodableList());
+  map[EncodableValue("fecMechanisms")] = EncodableValue(EncodableList());
 
-    const std::string direction = findString(params, "direction");
-    if (transceiverId.empty()) {
-      result->Error("rtpTransceiverSetDirection",
-                    "rtpTransceiverSetDirection() direction is null or empty");
-      return;
-    }
+  result->Success(EncodableValue(map));
+}
 
-    RtpTransceiverSetDirection(pc, transceiverId, direction, std::move(result));
-  } else if (method_call.method_name().compare("setConfiguration") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("setConfiguration",
-                    "setConfiguration() peerConnection is null");
-      return;
-    }
+void FlutterWebRTC::HandleSetCodecPreferences(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("setCodecPreferences",
+                  "setCodecPreferences() peerConnection is null");
+    return;
+  }
 
-    const EncodableMap configuration = findMap(params, "configuration");
-    if (configuration.empty()) {
-      result->Error("setConfiguration",
-                    "setConfiguration() configuration is null or empty");
-      return;
-    }
-    SetConfiguration(pc, configuration, std::move(result));
-  } else if (method_call.method_name().compare("captureFrame") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+  const std::string transceiverId = findString(params, "transceiverId");
+  if (transceiverId.empty()) {
+    result->Error("setCodecPreferences",
+                  "setCodecPreferences() transceiverId is null or empty");
+    return;
+  }
 
-    const std::string path = findString(params, "path");
-    if (path.empty()) {
-      result->Error("captureFrame", "captureFrame() path is null or empty");
-      return;
-    }
+  const EncodableList& codecs = findList(params, "codecs");
+  if (codecs.empty()) {
+    result->Error("Bad Arguments", "Codecs is required");
+    return;
+  }
+  RtpTransceiverSetCodecPreferences(pc, transceiverId, codecs,
+                                    std::move(result));
+}
 
-    const std::string trackId = findString(params, "trackId");
-    RTCMediaTrack* track = MediaTrackForId(trackId);
-    if (nullptr == track) {
-      result->Error("captureFrame", "captureFrame() track is null");
-      return;
-    }
-    std::string kind = track->kind().std_string();
-    if (0 != kind.compare("video")) {
-      result->Error("captureFrame", "captureFrame() track not is video track");
-      return;
-    }
-    CaptureFrame(reinterpret_cast<RTCVideoTrack*>(track), path,
-                 std::move(result));
-
-  } else if (method_call.method_name().compare("createLocalMediaStream") == 0) {
-    CreateLocalMediaStream(std::move(result));
-  } else if (method_call.method_name().compare("canInsertDtmf") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const std::string rtpSenderId = findString(params, "rtpSenderId");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("canInsertDtmf", "canInsertDtmf() peerConnection is null");
-      return;
-    }
+void FlutterWebRTC::HandleGetSignalingState(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
 
-    auto rtpSender = GetRtpSenderById(pc, rtpSenderId);
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
 
-    if (rtpSender == nullptr) {
-      result->Error("sendDtmf", "sendDtmf() rtpSender is null");
-      return;
-    }
-    auto dtmfSender = rtpSender->dtmf_sender();
-    bool canInsertDtmf = dtmfSender->CanInsertDtmf();
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("getSignalingState",
+                  "getSignalingState() peerConnection is null");
+    return;
+  }
+  EncodableMap state;
+  state[EncodableValue("state")] =
+      signalingStateString(pc->signaling_state());
+  result->Success(EncodableValue(state));
+}
 
-    result->Success(EncodableValue(canInsertDtmf));
-  } else if (method_call.method_name().compare("sendDtmf") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    const std::string rtpSenderId = findString(params, "rtpSenderId");
-    const std::string tone = findString(params, "tone");
-    int duration = findInt(params, "duration");
-    int gap = findInt(params, "gap");
-
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("sendDtmf", "sendDtmf() peerConnection is null");
-      return;
-    }
+void FlutterWebRTC::HandleGetIceGatheringState(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
 
-    auto rtpSender = GetRtpSenderById(pc, rtpSenderId);
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
 
-    if (rtpSender == nullptr) {
-      result->Error("sendDtmf", "sendDtmf() rtpSender is null");
-      return;
-    }
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("getIceGatheringState",
+                  "getIceGatheringState() peerConnection is null");
+    return;
+  }
+  EncodableMap state;
+  state[EncodableValue("state")] =
+      iceGatheringStateString(pc->ice_gathering_state());
+  result->Success(EncodableValue(state));
+}
 
-    auto dtmfSender = rtpSender->dtmf_sender();
-    dtmfSender->InsertDtmf(tone, duration, gap);
+void FlutterWebRTC::HandleGetIceConnectionState(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
 
-    result->Success();
-  } else if (method_call.method_name().compare("getRtpSenderCapabilities") ==
-             0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-
-    RTCMediaType mediaType = RTCMediaType::AUDIO;
-    const std::string kind = findString(params, "kind");
-    if (0 == kind.compare("video")) {
-      mediaType = RTCMediaType::VIDEO;
-    } else if (0 == kind.compare("audio")) {
-      mediaType = RTCMediaType::AUDIO;
-    } else {
-      result->Error("getRtpSenderCapabilities",
-                    "getRtpSenderCapabilities() kind is null or empty");
-      return;
-    }
-    auto capabilities = factory_->GetRtpSenderCapabilities(mediaType);
-    EncodableMap map;
-    EncodableList codecsList;
-    for (auto codec : capabilities->codecs().std_vector()) {
-      EncodableMap codecMap;
-      codecMap[EncodableValue("mimeType")] =
-          EncodableValue(codec->mime_type().std_string());
-      codecMap[EncodableValue("clockRate")] =
-          EncodableValue(codec->clock_rate());
-      codecMap[EncodableValue("channels")] = EncodableValue(codec->channels());
-      codecMap[EncodableValue("sdpFmtpLine")] =
-          EncodableValue(codec->sdp_fmtp_line().std_string());
-      codecsList.push_back(EncodableValue(codecMap));
-    }
-    map[EncodableValue("codecs")] = EncodableValue(codecsList);
-    map[EncodableValue("headerExtensions")] = EncodableValue(EncodableList());
-    map[EncodableValue("fecMechanisms")] = EncodableValue(EncodableList());
-
-    result->Success(EncodableValue(map));
-  } else if (method_call.method_name().compare("getRtpReceiverCapabilities") ==
-             0) {
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-
-    RTCMediaType mediaType = RTCMediaType::AUDIO;
-    const std::string kind = findString(params, "kind");
-    if (0 == kind.compare("video")) {
-      mediaType = RTCMediaType::VIDEO;
-    } else if (0 == kind.compare("audio")) {
-      mediaType = RTCMediaType::AUDIO;
-    } else {
-      result->Error("getRtpSenderCapabilities",
-                    "getRtpSenderCapabilities() kind is null or empty");
-      return;
-    }
-    auto capabilities = factory_->GetRtpReceiverCapabilities(mediaType);
-    EncodableMap map;
-    EncodableList codecsList;
-    for (auto codec : capabilities->codecs().std_vector()) {
-      EncodableMap codecMap;
-      codecMap[EncodableValue("mimeType")] =
-          EncodableValue(codec->mime_type().std_string());
-      codecMap[EncodableValue("clockRate")] =
-          EncodableValue(codec->clock_rate());
-      codecMap[EncodableValue("channels")] = EncodableValue(codec->channels());
-      codecMap[EncodableValue("sdpFmtpLine")] =
-          EncodableValue(codec->sdp_fmtp_line().std_string());
-      codecsList.push_back(EncodableValue(codecMap));
-    }
-    map[EncodableValue("codecs")] = EncodableValue(codecsList);
-    map[EncodableValue("headerExtensions")] = EncodableValue(EncodableList());
-    map[EncodableValue("fecMechanisms")] = EncodableValue(EncodableList());
-
-    result->Success(EncodableValue(map));
-  } else if (method_call.method_name().compare("setCodecPreferences") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("setCodecPreferences",
-                    "setCodecPreferences() peerConnection is null");
-      return;
-    }
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
 
-    const std::string transceiverId = findString(params, "transceiverId");
-    if (transceiverId.empty()) {
-      result->Error("setCodecPreferences",
-                    "setCodecPreferences() transceiverId is null or empty");
-      return;
-    }
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("getIceConnectionState",
+                  "getIceConnectionState() peerConnection is null");
+    return;
+  }
+  EncodableMap state;
+  state[EncodableValue("state")] =
+      iceConnectionStateString(pc->ice_connection_state());
+  result->Success(EncodableValue(state));
+}
 
-    const EncodableList codecs = findList(params, "codecs");
-    if (codecs.empty()) {
-      result->Error("Bad Arguments", "Codecs is required");
-      return;
-    }
-    RtpTransceiverSetCodecPreferences(pc, transceiverId, codecs,
-                                      std::move(result));
-  } else if (method_call.method_name().compare("getSignalingState") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+void FlutterWebRTC::HandleGetConnectionState(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
 
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
+  const std::string peerConnectionId = findString(params, "peerConnectionId");
 
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getSignalingState",
-                    "getSignalingState() peerConnection is null");
-      return;
-    }
-    EncodableMap state;
-    state[EncodableValue("state")] =
-        signalingStateString(pc->signaling_state());
-    result->Success(EncodableValue(state));
-  } else if (method_call.method_name().compare("getIceGatheringState") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+  scoped_refptr<RTCPeerConnection> pc = PeerConnectionForId(peerConnectionId);
+  if (pc == nullptr) {
+    result->Error("getConnectionState",
+                  "getConnectionState() peerConnection is null");
+    return;
+  }
+  EncodableMap state;
+  state[EncodableValue("state")] =
+      peerConnectionStateString(pc->peer_connection_state());
+  result->Success(EncodableValue(state));
+}
 
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
+void FlutterWebRTC::HandleSetThinValue(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const double value = findDouble(params, "value");
+  SetThinFaceValue(value);
+  result->Success();
+}
 
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getIceGatheringState",
-                    "getIceGatheringState() peerConnection is null");
-      return;
-    }
-    EncodableMap state;
-    state[EncodableValue("state")] =
-        iceGatheringStateString(pc->ice_gathering_state());
-    result->Success(EncodableValue(state));
-  } else if (method_call.method_name().compare("getIceConnectionState") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+void FlutterWebRTC::HandleSetBigEyeValue(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const double value = findDouble(params, "value");
+  SetBigEyeValue(value);
+  result->Success();
+}
 
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
+void FlutterWebRTC::HandleSetSmoothValue(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const double value = findDouble(params, "value");
+  SetSmoothValue(value);
+  result->Success();
+}
 
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getIceConnectionState",
-                    "getIceConnectionState() peerConnection is null");
-      return;
-    }
-    EncodableMap state;
-    state[EncodableValue("state")] =
-        iceConnectionStateString(pc->ice_connection_state());
-    result->Success(EncodableValue(state));
-  } else if (method_call.method_name().compare("getConnectionState") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
+void FlutterWebRTC::HandleSetLipstickValue(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const double value = findDouble(params, "value");
+  SetLipstickValue(value);
+  result->Success();
+}
 
-    const std::string peerConnectionId = findString(params, "peerConnectionId");
+void FlutterWebRTC::HandleSetBlusherValue(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
+  }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const double value = findDouble(params, "value");
+  SetBlusherValue(value);
+  result->Success();
+}
 
-    RTCPeerConnection* pc = PeerConnectionForId(peerConnectionId);
-    if (pc == nullptr) {
-      result->Error("getConnectionState",
-                    "getConnectionState() peerConnection is null");
-      return;
-    }
-    EncodableMap state;
-    state[EncodableValue("state")] =
-        peerConnectionStateString(pc->peer_connection_state());
-    result->Success(EncodableValue(state));
-  } else if (method_call.method_name().compare("setThinValue") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const double value = findDouble(params, "value");
-    SetThinFaceValue(value);
-    result->Success();
-  } else if (method_call.method_name().compare("setBigEyeValue") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const double value = findDouble(params, "value");
-    SetBigEyeValue(value);
-    result->Success();
-  } else if (method_call.method_name().compare("setSmoothValue") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const double value = findDouble(params, "value");
-    SetSmoothValue(value);
-    result->Success();
-  } else if (method_call.method_name().compare("setLipstickValue") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const double value = findDouble(params, "value");
-    SetLipstickValue(value);
-    result->Success();
-  } else if (method_call.method_name().compare("setBlusherValue") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const double value = findDouble(params, "value");
-    SetBlusherValue(value);
-    result->Success();
-  } else if (method_call.method_name().compare("setWhiteValue") == 0) {
-    if (!method_call.arguments()) {
-      result->Error("Bad Arguments", "Null constraints arguments received");
-      return;
-    }
-    const EncodableMap params =
-        GetValue<EncodableMap>(*method_call.arguments());
-    const double value = findDouble(params, "value");
-    SetWhiteValue(value);
-    result->Success();
-  } else {
-    if (HandleFrameCryptorMethodCall(method_call, std::move(result), &result)) {
-      return;
-    } else {
-      result->NotImplemented();
-    }
+void FlutterWebRTC::HandleSetWhiteValue(
+    const MethodCallProxy& method_call,
+    std::unique_ptr<MethodResultProxy> result) {
+  if (!method_call.arguments()) {
+    result->Error("Bad Arguments", "Null constraints arguments received");
+    return;
   }
+  const EncodableMap& params = GetValue<EncodableMap>(*method_call.arguments());
+  const double value = findDouble(params, "value");
+  SetWhiteValue(value);
+  result->Success();
 }
 
 }  // namespace flutter_webrtc_plus_plugin
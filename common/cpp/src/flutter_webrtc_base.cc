@@ -1,5 +1,8 @@
 #include "flutter_webrtc_base.h"
 
+#include <algorithm>
+#include <cctype>
+
 #include "flutter_data_channel.h"
 #include "flutter_peerconnection.h"
 
@@ -31,59 +34,62 @@ std::string FlutterWebRTCBase::GenerateUUID() {
   return uuidxx::uuid::Generate().ToString(false);
 }
 
-RTCPeerConnection* FlutterWebRTCBase::PeerConnectionForId(
+scoped_refptr<RTCPeerConnection> FlutterWebRTCBase::PeerConnectionForId(
     const std::string& id) {
+  std::shared_lock<std::shared_mutex> lock(peerconnections_mutex_);
   auto it = peerconnections_.find(id);
 
   if (it != peerconnections_.end())
-    return (*it).second.get();
+    return (*it).second;
 
   return nullptr;
 }
 
 void FlutterWebRTCBase::RemovePeerConnectionForId(const std::string& id) {
-  auto it = peerconnections_.find(id);
-  if (it != peerconnections_.end())
+  scoped_refptr<RTCPeerConnection> pc;
+  {
+    std::unique_lock<std::shared_mutex> lock(peerconnections_mutex_);
+    auto it = peerconnections_.find(id);
+    if (it == peerconnections_.end())
+      return;
+    pc = it->second;
     peerconnections_.erase(it);
-}
-
-RTCMediaTrack* FlutterWebRTCBase ::MediaTrackForId(const std::string& id) {
-  auto it = local_tracks_.find(id);
-
-  if (it != local_tracks_.end())
-    return (*it).second.get();
-
-  for (auto kv : peerconnection_observers_) {
-    auto pco = kv.second.get();
-    auto track = pco->MediaTrackForId(id);
-    if (track != nullptr)
-      return track;
+    rtp_indexes_.erase(pc.get());
   }
-
-  return nullptr;
+  // |pc| drops its last registry reference here, outside the lock.
 }
 
 void FlutterWebRTCBase::RemoveMediaTrackForId(const std::string& id) {
+  std::unique_lock<std::shared_mutex> lock(tracks_mutex_);
   auto it = local_tracks_.find(id);
   if (it != local_tracks_.end())
     local_tracks_.erase(it);
 }
 
-FlutterPeerConnectionObserver* FlutterWebRTCBase::PeerConnectionObserversForId(
-    const std::string& id) {
+std::shared_ptr<FlutterPeerConnectionObserver>
+FlutterWebRTCBase::PeerConnectionObserversForId(const std::string& id) {
+  std::shared_lock<std::shared_mutex> lock(peerconnections_mutex_);
   auto it = peerconnection_observers_.find(id);
 
   if (it != peerconnection_observers_.end())
-    return (*it).second.get();
+    return (*it).second;
 
   return nullptr;
 }
 
 void FlutterWebRTCBase::RemovePeerConnectionObserversForId(
     const std::string& id) {
-  auto it = peerconnection_observers_.find(id);
-  if (it != peerconnection_observers_.end())
+  std::shared_ptr<FlutterPeerConnectionObserver> observer;
+  {
+    std::unique_lock<std::shared_mutex> lock(peerconnections_mutex_);
+    auto it = peerconnection_observers_.find(id);
+    if (it == peerconnection_observers_.end())
+      return;
+    observer = std::move(it->second);
     peerconnection_observers_.erase(it);
+  }
+  // |observer| is released here, outside the lock, since its destructor
+  // unregisters remote tracks.
 }
 
 scoped_refptr<RTCMediaStream> FlutterWebRTCBase::MediaStreamForId(
@@ -96,6 +102,7 @@ scoped_refptr<RTCMediaStream> FlutterWebRTCBase::MediaStreamForId(
         return (*it).second;
       }
     } else {
+      std::shared_lock<std::shared_mutex> lock(peerconnections_mutex_);
       auto pco = peerconnection_observers_.find(ownerTag);
       if (peerconnection_observers_.end() != pco) {
         auto stream = pco->second->MediaStreamForId(id);
@@ -130,9 +137,9 @@ void FlutterWebRTCBase::ParseConstraints(
     const EncodableMap& src,
     scoped_refptr<RTCMediaConstraints> mediaConstraints,
     ParseConstraintType type /*= kMandatory*/) {
-  for (auto kv : src) {
-    EncodableValue k = kv.first;
-    EncodableValue v = kv.second;
+  for (const auto& kv : src) {
+    const EncodableValue& k = kv.first;
+    const EncodableValue& v = kv.second;
     std::string key = GetValue<std::string>(k);
     std::string value;
     if (TypeIs<EncodableList>(v) || TypeIs<EncodableMap>(v)) {
@@ -168,7 +175,7 @@ scoped_refptr<RTCMediaConstraints> FlutterWebRTCBase::ParseMediaConstraints(
 
   if (constraints.find(EncodableValue("mandatory")) != constraints.end()) {
     auto it = constraints.find(EncodableValue("mandatory"));
-    const EncodableMap mandatory = GetValue<EncodableMap>(it->second);
+    const EncodableMap& mandatory = GetValue<EncodableMap>(it->second);
     ParseConstraints(mandatory, media_constraints, kMandatory);
   } else {
     // Log.d(TAG, "mandatory constraints are not a map");
@@ -176,12 +183,12 @@ scoped_refptr<RTCMediaConstraints> FlutterWebRTCBase::ParseMediaConstraints(
 
   auto it = constraints.find(EncodableValue("optional"));
   if (it != constraints.end()) {
-    const EncodableValue optional = it->second;
+    const EncodableValue& optional = it->second;
     if (TypeIs<EncodableMap>(optional)) {
       ParseConstraints(GetValue<EncodableMap>(optional), media_constraints,
                        kOptional);
     } else if (TypeIs<EncodableList>(optional)) {
-      const EncodableList list = GetValue<EncodableList>(optional);
+      const EncodableList& list = GetValue<EncodableList>(optional);
       for (size_t i = 0; i < list.size(); i++) {
         ParseConstraints(GetValue<EncodableMap>(list[i]), media_constraints,
                          kOptional);
@@ -194,57 +201,90 @@ scoped_refptr<RTCMediaConstraints> FlutterWebRTCBase::ParseMediaConstraints(
   return media_constraints;
 }
 
-bool FlutterWebRTCBase::CreateIceServers(const EncodableList& iceServersArray,
-                                         IceServer* ice_servers) {
-  size_t size = iceServersArray.size();
-  for (size_t i = 0; i < size; i++) {
-    IceServer& ice_server = ice_servers[i];
-    EncodableMap iceServerMap = GetValue<EncodableMap>(iceServersArray[i]);
-
-    if (iceServerMap.find(EncodableValue("username")) != iceServerMap.end()) {
-      ice_server.username = GetValue<std::string>(
-          iceServerMap.find(EncodableValue("username"))->second);
-    }
-    if (iceServerMap.find(EncodableValue("credential")) != iceServerMap.end()) {
-      ice_server.password = GetValue<std::string>(
-          iceServerMap.find(EncodableValue("credential"))->second);
-    }
+// Lower ranks are kept first when the servers don't fit: STUN and UDP TURN
+// are cheapest to try, then TURN over TCP, then TURN over TLS.
+static int IceServerUrlRank(const std::string& url) {
+  std::string lower = url;
+  std::transform(lower.begin(), lower.end(), lower.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  if (lower.rfind("stun:", 0) == 0 || lower.rfind("stuns:", 0) == 0)
+    return 0;
+  if (lower.rfind("turns:", 0) == 0)
+    return 3;
+  if (lower.rfind("turn:", 0) == 0)
+    return lower.find("transport=tcp") != std::string::npos ? 2 : 1;
+  return 4;
+}
 
-    auto it = iceServerMap.find(EncodableValue("url"));
-    if (it != iceServerMap.end() && TypeIs<std::string>(it->second)) {
-      ice_server.uri = GetValue<std::string>(it->second);
-    }
-    it = iceServerMap.find(EncodableValue("urls"));
-    if (it != iceServerMap.end()) {
-      if (TypeIs<std::string>(it->second)) {
-        ice_server.uri = GetValue<std::string>(it->second);
-      }
-      if (TypeIs<EncodableList>(it->second)) {
-        const EncodableList urls = GetValue<EncodableList>(it->second);
-        for (auto url : urls) {
-          if (TypeIs<EncodableMap>(url)) {
-            const EncodableMap map = GetValue<EncodableMap>(url);
-            std::string value;
-            auto it2 = map.find(EncodableValue("url"));
-            if (it2 != map.end()) {
-              ice_server.uri = GetValue<std::string>(it2->second);
-            }
-          } else if (TypeIs<std::string>(url)) {
-            ice_server.uri = GetValue<std::string>(url);
-          }
+bool FlutterWebRTCBase::CreateIceServers(const EncodableList& iceServersArray,
+                                         IceServer* ice_servers,
+                                         EncodableList* dropped) {
+  struct Candidate {
+    int rank;
+    std::string url;
+    std::string username;
+    std::string credential;
+  };
+  // libwebrtc's IceServer holds one URL, so every URL of every server
+  // becomes its own entry.
+  std::vector<Candidate> candidates;
+  for (const EncodableValue& value : iceServersArray) {
+    if (!TypeIs<EncodableMap>(value))
+      continue;
+    const EncodableMap& iceServerMap = GetValue<EncodableMap>(value);
+    std::string username = findString(iceServerMap, "username");
+    std::string credential = findString(iceServerMap, "credential");
+
+    std::vector<std::string> urls;
+    const std::string& url = findString(iceServerMap, "url");
+    if (!url.empty())
+      urls.push_back(url);
+    const EncodableValue& urls_value = findEncodableValue(iceServerMap, "urls");
+    if (TypeIs<std::string>(urls_value)) {
+      urls.push_back(GetValue<std::string>(urls_value));
+    } else if (TypeIs<EncodableList>(urls_value)) {
+      for (const EncodableValue& item : GetValue<EncodableList>(urls_value)) {
+        if (TypeIs<EncodableMap>(item)) {
+          urls.push_back(findString(GetValue<EncodableMap>(item), "url"));
+        } else if (TypeIs<std::string>(item)) {
+          urls.push_back(GetValue<std::string>(item));
         }
       }
     }
+    for (const std::string& item : urls) {
+      if (!item.empty())
+        candidates.push_back(
+            {IceServerUrlRank(item), item, username, credential});
+    }
+  }
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const Candidate& a, const Candidate& b) {
+                     return a.rank < b.rank;
+                   });
+
+  for (int i = 0; i < kMaxIceServerSize; i++)
+    ice_servers[i] = IceServer();
+  for (size_t i = 0; i < candidates.size(); i++) {
+    if (i >= kMaxIceServerSize) {
+      if (dropped)
+        dropped->push_back(EncodableValue(candidates[i].url));
+      continue;
+    }
+    ice_servers[i].uri = candidates[i].url;
+    ice_servers[i].username = candidates[i].username;
+    ice_servers[i].password = candidates[i].credential;
   }
-  return size > 0;
+  return !candidates.empty();
 }
 
-bool FlutterWebRTCBase::ParseRTCConfiguration(const EncodableMap& map,
-                                              RTCConfiguration& conf) {
+bool FlutterWebRTCBase::ParseRTCConfiguration(
+    const EncodableMap& map,
+    RTCConfiguration& conf,
+    EncodableList* dropped_ice_servers) {
   auto it = map.find(EncodableValue("iceServers"));
-  if (it != map.end()) {
-    const EncodableList iceServersArray = GetValue<EncodableList>(it->second);
-    CreateIceServers(iceServersArray, conf.ice_servers);
+  if (it != map.end() && TypeIs<EncodableList>(it->second)) {
+    const EncodableList& iceServersArray = GetValue<EncodableList>(it->second);
+    CreateIceServers(iceServersArray, conf.ice_servers, dropped_ice_servers);
   }
   // iceTransportPolicy (public API)
   it = map.find(EncodableValue("iceTransportPolicy"));
@@ -312,30 +352,66 @@ bool FlutterWebRTCBase::ParseRTCConfiguration(const EncodableMap& map,
 
 scoped_refptr<RTCMediaTrack> FlutterWebRTCBase::MediaTracksForId(
     const std::string& id) {
+  std::shared_lock<std::shared_mutex> lock(tracks_mutex_);
   auto it = local_tracks_.find(id);
   if (it != local_tracks_.end()) {
     return (*it).second;
   }
 
-  for (auto it2 : peerconnection_observers_) {
-    auto pco = it2.second;
-    auto t = pco->MediaTrackForId(id);
-    if (t != nullptr) {
-      return t;
-    }
+  auto remote = remote_tracks_.find(id);
+  if (remote != remote_tracks_.end()) {
+    return remote->second.begin()->second;
   }
 
   return nullptr;
 }
 
 void FlutterWebRTCBase::RemoveTracksForId(const std::string& id) {
+  std::unique_lock<std::shared_mutex> lock(tracks_mutex_);
   auto it = local_tracks_.find(id);
   if (it != local_tracks_.end())
     local_tracks_.erase(it);
 }
 
+void FlutterWebRTCBase::AddLocalTrack(scoped_refptr<RTCMediaTrack> track) {
+  if (nullptr == track.get())
+    return;
+  std::unique_lock<std::shared_mutex> lock(tracks_mutex_);
+  local_tracks_[track->id().std_string()] = track;
+}
+
+void FlutterWebRTCBase::AddRemoteTrack(const std::string& peerconnection_id,
+                                       scoped_refptr<RTCMediaTrack> track) {
+  if (nullptr == track.get())
+    return;
+  std::unique_lock<std::shared_mutex> lock(tracks_mutex_);
+  remote_tracks_[track->id().std_string()][peerconnection_id] = track;
+}
+
+void FlutterWebRTCBase::RemoveRemoteTrack(const std::string& peerconnection_id,
+                                          const std::string& id) {
+  std::unique_lock<std::shared_mutex> lock(tracks_mutex_);
+  auto it = remote_tracks_.find(id);
+  if (it == remote_tracks_.end())
+    return;
+  it->second.erase(peerconnection_id);
+  if (it->second.empty())
+    remote_tracks_.erase(it);
+}
+
+std::shared_ptr<RtpObjectIndex> FlutterWebRTCBase::RtpIndexFor(
+    RTCPeerConnection* pc) {
+  std::shared_lock<std::shared_mutex> lock(peerconnections_mutex_);
+  auto it = rtp_indexes_.find(pc);
+  if (it != rtp_indexes_.end())
+    return it->second;
+  return nullptr;
+}
+
 libwebrtc::scoped_refptr<libwebrtc::RTCRtpSender>
 FlutterWebRTCBase::GetRtpSenderById(RTCPeerConnection* pc, std::string id) {
+  if (auto index = RtpIndexFor(pc))
+    return index->SenderForId(pc, id);
   libwebrtc::scoped_refptr<libwebrtc::RTCRtpSender> result;
   auto senders = pc->senders();
   for (scoped_refptr<RTCRtpSender> item : senders.std_vector()) {
@@ -349,6 +425,8 @@ FlutterWebRTCBase::GetRtpSenderById(RTCPeerConnection* pc, std::string id) {
 
 libwebrtc::scoped_refptr<libwebrtc::RTCRtpReceiver>
 FlutterWebRTCBase::GetRtpReceiverById(RTCPeerConnection* pc, std::string id) {
+  if (auto index = RtpIndexFor(pc))
+    return index->ReceiverForId(pc, id);
   libwebrtc::scoped_refptr<libwebrtc::RTCRtpReceiver> result;
   auto receivers = pc->receivers();
   for (scoped_refptr<RTCRtpReceiver> item : receivers.std_vector()) {
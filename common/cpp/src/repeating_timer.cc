@@ -0,0 +1,83 @@
+#include "repeating_timer.h"
+
+namespace flutter_webrtc_plus_plugin {
+
+RepeatingTimer::~RepeatingTimer() {
+  Stop();
+}
+
+void RepeatingTimer::Start(std::chrono::milliseconds interval, Task task) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  interval_ = interval;
+  task_ = std::move(task);
+  if (running_ && !*stop_) {
+    restart_ = true;
+    cv_.notify_all();
+    return;
+  }
+
+  // A previous run went idle on its own; its thread has already left Run().
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  running_ = true;
+  restart_ = false;
+  stop_ = std::make_shared<bool>(false);
+  thread_ = std::thread(&RepeatingTimer::Run, this, stop_);
+}
+
+void RepeatingTimer::Stop() {
+  std::thread thread;
+  std::shared_ptr<bool> stop;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stop = stop_;
+    if (stop) {
+      *stop = true;
+    }
+    cv_.notify_all();
+    thread = std::move(thread_);
+  }
+  if (thread.joinable()) {
+    if (thread.get_id() == std::this_thread::get_id()) {
+      thread.detach();
+    } else {
+      thread.join();
+    }
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  // Another thread may have started a new run while this one was joined.
+  if (stop_ == stop) {
+    running_ = false;
+    task_ = nullptr;
+  }
+}
+
+bool RepeatingTimer::IsRunning() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return running_ && !*stop_;
+}
+
+void RepeatingTimer::Run(std::shared_ptr<bool> stop) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    cv_.wait_for(lock, interval_, [&stop] { return *stop; });
+    if (*stop) {
+      return;
+    }
+    restart_ = false;
+    Task task = task_;
+    lock.unlock();
+    bool keep_running = task();
+    lock.lock();
+    if (*stop) {
+      return;
+    }
+    if (!keep_running && !restart_) {
+      running_ = false;
+      return;
+    }
+  }
+}
+
+}  // namespace flutter_webrtc_plus_plugin
@@ -34,23 +34,19 @@ class RTCFactoryNative extends RTCFactory {
   Future<RTCPeerConnection> createPeerConnection(
       Map<String, dynamic> configuration,
       [Map<String, dynamic> constraints = const {}]) async {
-    var defaultConstraints = <String, dynamic>{
-      'mandatory': {},
-      'optional': [
-        {'DtlsSrtpKeyAgreement': true},
-      ],
-    };
-
     final response = await WebRTC.invokeMethod(
       'createPeerConnection',
       <String, dynamic>{
         'configuration': configuration,
-        'constraints': constraints.isEmpty ? defaultConstraints : constraints
+        'constraints': constraints.isEmpty
+            ? defaultPeerConnectionConstraints
+            : constraints
       },
     );
 
     String peerConnectionId = response['peerConnectionId'];
-    return RTCPeerConnectionNative(peerConnectionId, configuration);
+    return RTCPeerConnectionNative(peerConnectionId, configuration,
+        List<String>.from(response['droppedIceServers'] ?? const []));
   }
 
   @override
@@ -15,6 +15,12 @@ final _typeStringToMessageType = <String, MessageType>{
   'binary': MessageType.binary
 };
 
+/// Reports the progress of a native file transfer. [totalBytes] is 0 for a
+/// receive sink without an expected size. [error] is only set on the final
+/// ([done]) call of a failed transfer.
+typedef RTCDataChannelFileProgressCallback = void Function(
+    String path, int bytes, int totalBytes, bool done, String? error);
+
 /// A class that represents a WebRTC datachannel.
 /// Can send and receive text and binary messages.
 class RTCDataChannelNative extends RTCDataChannel {
@@ -57,6 +63,12 @@ class RTCDataChannelNative extends RTCDataChannel {
   @override
   int? get bufferedAmount => _bufferedAmount;
 
+  /// Called with the progress of [sendFile].
+  RTCDataChannelFileProgressCallback? onFileSendProgress;
+
+  /// Called with the progress of [writeToFile].
+  RTCDataChannelFileProgressCallback? onFileReceiveProgress;
+
   final _stateChangeController =
       StreamController<RTCDataChannelState>.broadcast(sync: true);
   final _messageController =
@@ -90,6 +102,17 @@ class RTCDataChannelNative extends RTCDataChannel {
         _messageController.add(message);
         break;
 
+      case 'dataChannelReceiveMessages':
+        _dataChannelId = map['id'];
+        for (var data in map['messages']) {
+          final message = data is String
+              ? RTCDataChannelMessage(data)
+              : RTCDataChannelMessage.fromBinary(data);
+          onMessage?.call(message);
+          _messageController.add(message);
+        }
+        break;
+
       case 'dataChannelBufferedAmountChange':
         _bufferedAmount = map['bufferedAmount'];
         if (bufferedAmountLowThreshold != null) {
@@ -99,6 +122,21 @@ class RTCDataChannelNative extends RTCDataChannel {
         }
         onBufferedAmountChange?.call(_bufferedAmount, map['changedAmount']);
         break;
+
+      case 'dataChannelBufferedAmountLow':
+        _bufferedAmount = map['bufferedAmount'];
+        onBufferedAmountLow?.call(_bufferedAmount);
+        break;
+
+      case 'dataChannelFileSendProgress':
+        onFileSendProgress?.call(map['path'], map['bytes'], map['totalBytes'],
+            map['done'], map['error']);
+        break;
+
+      case 'dataChannelFileReceiveProgress':
+        onFileReceiveProgress?.call(map['path'], map['bytes'],
+            map['totalBytes'], map['done'], map['error']);
+        break;
     }
   }
 
@@ -134,6 +172,132 @@ class RTCDataChannelNative extends RTCDataChannel {
     });
   }
 
+  /// Enables native send pacing on Windows and Linux.
+  ///
+  /// While more than [high] bytes are buffered, [send] queues messages
+  /// natively instead of handing them to SCTP. The queue is drained
+  /// automatically, and [onBufferedAmountLow] fires once the buffered amount
+  /// drops to [low] or below. Passing a [high] of 0 disables pacing.
+  Future<void> setSendQueueWatermarks(int high, int low) async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      bufferedAmountLowThreshold = low;
+      return;
+    }
+    await WebRTC.invokeMethod(
+        'dataChannelSetSendQueueWatermarks', <String, dynamic>{
+      'peerConnectionId': _peerConnectionId,
+      'dataChannelId': _flutterId,
+      'highWatermark': high,
+      'lowWatermark': low,
+    });
+  }
+
+  /// Enables native receive batching on Windows and Linux.
+  ///
+  /// Incoming messages are delivered in order, but in groups of up to
+  /// [maxMessages] messages or [maxBytes] bytes, and at most [maxDelay] after
+  /// the first message of a group arrived. This saves a platform-channel hop
+  /// per message for high-rate channels. A [maxMessages] of 1 turns batching
+  /// off. Other platforms always deliver messages one at a time.
+  Future<void> setReceiveBatching(
+      {int maxMessages = 64,
+      int maxBytes = 256 * 1024,
+      Duration maxDelay = const Duration(milliseconds: 16)}) async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      return;
+    }
+    await WebRTC.invokeMethod(
+        'dataChannelSetReceiveBatching', <String, dynamic>{
+      'peerConnectionId': _peerConnectionId,
+      'dataChannelId': _flutterId,
+      'maxMessages': maxMessages,
+      'maxBytes': maxBytes,
+      'maxDelayMs': maxDelay.inMilliseconds,
+    });
+  }
+
+  /// Sends [messages] in order using a single method-channel round trip.
+  /// Only Windows and Linux batch natively; other platforms fall back to
+  /// sending one message at a time.
+  Future<void> sendBatch(List<RTCDataChannelMessage> messages) async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      for (var message in messages) {
+        await send(message);
+      }
+      return;
+    }
+    final Map<dynamic, dynamic> response = await WebRTC.invokeMethod(
+        'dataChannelSendBatch', <String, dynamic>{
+      'peerConnectionId': _peerConnectionId,
+      'dataChannelId': _flutterId,
+      'messages': messages
+          .map((message) => message.isBinary ? message.binary : message.text)
+          .toList(),
+    });
+    _bufferedAmount = response['bufferedAmount'];
+  }
+
+  /// Streams the file at [path] natively as binary messages of [chunkSize]
+  /// bytes, paced by the buffered amount. Returns the size of the file;
+  /// progress is reported through [onFileSendProgress].
+  /// Only supported on Windows and Linux.
+  Future<int> sendFile(String path, {int chunkSize = 16 * 1024}) async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      throw UnsupportedError('sendFile is only supported on desktop');
+    }
+    final Map<dynamic, dynamic> response = await WebRTC.invokeMethod(
+        'dataChannelSendFile', <String, dynamic>{
+      'peerConnectionId': _peerConnectionId,
+      'dataChannelId': _flutterId,
+      'path': path,
+      'chunkSize': chunkSize,
+    });
+    return response['totalBytes'];
+  }
+
+  /// Writes incoming binary messages to [path] natively instead of delivering
+  /// them to [onMessage], until [expectedBytes] have arrived or the sink is
+  /// replaced. Passing a null [path] closes the current sink. Progress is
+  /// reported through [onFileReceiveProgress].
+  /// Only supported on Windows and Linux.
+  Future<void> writeToFile(String? path, {int expectedBytes = 0}) async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      throw UnsupportedError('writeToFile is only supported on desktop');
+    }
+    await WebRTC.invokeMethod('dataChannelWriteToFile', <String, dynamic>{
+      'peerConnectionId': _peerConnectionId,
+      'dataChannelId': _flutterId,
+      'path': path ?? '',
+      'expectedBytes': expectedBytes,
+    });
+  }
+
+  /// Runs the native data channel benchmark on Windows and Linux.
+  ///
+  /// Two in-process peer connections exchange [messagesPerSize] binary
+  /// messages of each of [messageSizes] bytes over loopback, with received
+  /// events counted natively instead of being sent to Dart. Returns one map
+  /// per size with `messagesPerSecond`, `megabytesPerSecond`, `p50LatencyUs`
+  /// and `p99LatencyUs`. A [receiveBatchSize] greater than 1 measures the
+  /// receiver with [setReceiveBatching] enabled.
+  static Future<List<Map<dynamic, dynamic>>> runBenchmark(
+      {List<int> messageSizes = const [64, 1024, 16 * 1024, 64 * 1024],
+      int messagesPerSize = 1000,
+      int receiveBatchSize = 0,
+      Duration timeout = const Duration(seconds: 30)}) async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      throw UnsupportedError('runBenchmark is only supported on desktop');
+    }
+    final Map<dynamic, dynamic> response = await WebRTC.invokeMethod(
+        'dataChannelBenchmark', <String, dynamic>{
+      'messageSizes': messageSizes,
+      'messagesPerSize': messagesPerSize,
+      'receiveBatchSize': receiveBatchSize,
+      'timeoutMs': timeout.inMilliseconds,
+    });
+    return List<Map<dynamic, dynamic>>.from(response['runs']);
+  }
+
   @override
   Future<void> close() async {
     await _stateChangeController.close();
@@ -2,6 +2,7 @@
 import 'dart:async';
 
 // Flutter imports:
+import 'package:flutter/foundation.dart';
 import 'package:flutter/services.dart';
 
 // Package imports:
@@ -17,11 +18,22 @@ import 'rtc_rtp_sender_impl.dart';
 import 'rtc_rtp_transceiver_impl.dart';
 import 'utils.dart';
 
+/// Constraints createPeerConnection sends when the caller passes none.
+/// Pooled connections are keyed by the constraints actually sent, so the
+/// pool uses the same default.
+const defaultPeerConnectionConstraints = <String, dynamic>{
+  'mandatory': {},
+  'optional': [
+    {'DtlsSrtpKeyAgreement': true},
+  ],
+};
+
 /*
  *  PeerConnection
  */
 class RTCPeerConnectionNative extends RTCPeerConnection {
-  RTCPeerConnectionNative(this._peerConnectionId, this._configuration) {
+  RTCPeerConnectionNative(this._peerConnectionId, this._configuration,
+      [this._droppedIceServers = const []]) {
     _eventSubscription = _eventChannelFor(_peerConnectionId)
         .receiveBroadcastStream()
         .listen(eventListener, onError: errorListener);
@@ -38,6 +50,20 @@ class RTCPeerConnectionNative extends RTCPeerConnection {
   RTCIceGatheringState? _iceGatheringState;
   RTCIceConnectionState? _iceConnectionState;
   RTCPeerConnectionState? _connectionState;
+  // Transceiver maps as of [_transceiverVersion], kept up to date from the
+  // diffs getTransceivers returns on desktop.
+  final _transceiverStates = <String, Map<dynamic, dynamic>>{};
+  int _transceiverVersion = -1;
+  List<String> _droppedIceServers;
+
+  /// Called with each sample of [startStatsStream]. Every report is a map
+  /// with `id`, `type` and `metrics`.
+  void Function(List<Map<dynamic, dynamic>> reports)? onStats;
+
+  /// Called with each batch of local candidates once
+  /// [setIceCandidateBatching] is enabled, in gathering order. When unset,
+  /// [onIceCandidate] is called for every candidate of the batch instead.
+  void Function(List<RTCIceCandidate> candidates)? onIceCandidates;
 
   final Map<String, dynamic> defaultSdpConstraints = {
     'mandatory': {
@@ -165,6 +191,17 @@ class RTCPeerConnectionNative extends RTCPeerConnection {
             cand['candidate'], cand['sdpMid'], cand['sdpMLineIndex']);
         onIceCandidate?.call(candidate);
         break;
+      case 'onIceCandidates':
+        final candidates = (map['candidates'] as List<dynamic>)
+            .map((cand) => RTCIceCandidate(
+                cand['candidate'], cand['sdpMid'], cand['sdpMLineIndex']))
+            .toList();
+        if (onIceCandidates != null) {
+          onIceCandidates!(candidates);
+        } else {
+          candidates.forEach((candidate) => onIceCandidate?.call(candidate));
+        }
+        break;
       case 'onAddStream':
         String streamId = map['streamId'];
 
@@ -263,6 +300,10 @@ class RTCPeerConnectionNative extends RTCPeerConnection {
             transceiver: transceiver));
         break;
 
+      case 'peerConnectionStats':
+        onStats?.call(List<Map<dynamic, dynamic>>.from(map['reports']));
+        break;
+
       /// Other
       case 'onSelectedCandidatePairChanged':
 
@@ -311,6 +352,12 @@ class RTCPeerConnectionNative extends RTCPeerConnection {
   @override
   Map<String, dynamic> get getConfiguration => _configuration;
 
+  /// ICE server URLs from the configuration that didn't fit in the native
+  /// peer connection, which holds a fixed number of servers. STUN and UDP
+  /// TURN URLs are kept first, then TURN over TCP, then TURN over TLS.
+  /// Only reported on Windows and Linux.
+  List<String> get droppedIceServers => _droppedIceServers;
+
   @override
   Future<void> setConfiguration(Map<String, dynamic> configuration) async {
     _configuration = configuration;
@@ -324,6 +371,39 @@ class RTCPeerConnectionNative extends RTCPeerConnection {
     }
   }
 
+  /// Like [setConfiguration], but reports what happened: `applied` and
+  /// `unsupported` list the configuration fields (and `iceRestart`) that
+  /// took effect or changed without taking effect. With [iceRestart], ICE
+  /// is restarted in place instead of rebuilding the peer connection.
+  /// [getConfiguration] only reflects [configuration] if nothing in it was
+  /// unsupported. Only supported on Windows and Linux.
+  Future<Map<String, dynamic>> updateConfiguration(
+      Map<String, dynamic> configuration,
+      {bool iceRestart = false}) async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      throw UnsupportedError(
+          'updateConfiguration is only supported on desktop');
+    }
+    try {
+      final response =
+          await WebRTC.invokeMethod('setConfiguration', <String, dynamic>{
+        'peerConnectionId': _peerConnectionId,
+        'configuration': configuration,
+        'iceRestart': iceRestart,
+      });
+      // Keep reporting the configuration in effect: a field listed as
+      // unsupported changed nothing on the native side.
+      if ((response['unsupported'] as List?)?.isEmpty ?? true) {
+        _configuration = configuration;
+        _droppedIceServers =
+            List<String>.from(response['droppedIceServers'] ?? const []);
+      }
+      return Map<String, dynamic>.from(response);
+    } on PlatformException catch (e) {
+      throw 'Unable to RTCPeerConnection::setConfiguration: ${e.message}';
+    }
+  }
+
   @override
   Future<RTCSessionDescription> createOffer(
       [Map<String, dynamic>? constraints]) async {
@@ -452,6 +532,47 @@ class RTCPeerConnectionNative extends RTCPeerConnection {
     }
   }
 
+  /// Adds [candidates] in order with a single native call where supported.
+  /// Returns the indexes of the candidates that could not be parsed.
+  Future<List<int>> addCandidates(List<RTCIceCandidate> candidates) async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      for (final candidate in candidates) {
+        await addCandidate(candidate);
+      }
+      return <int>[];
+    }
+    try {
+      final response =
+          await WebRTC.invokeMethod('addCandidates', <String, dynamic>{
+        'peerConnectionId': _peerConnectionId,
+        'candidates': candidates.map((c) => c.toMap()).toList(),
+      });
+      return List<int>.from(response['failed']);
+    } on PlatformException catch (e) {
+      throw 'Unable to RTCPeerConnection::addCandidates: ${e.message}';
+    }
+  }
+
+  /// Coalesces local candidates into batches delivered to [onIceCandidates]
+  /// at most [maxDelay] after the first pending one, and when gathering
+  /// completes. [Duration.zero] turns batching off.
+  /// Only supported on Windows and Linux; elsewhere this is a no-op.
+  Future<void> setIceCandidateBatching(Duration maxDelay) async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      return;
+    }
+    try {
+      await WebRTC.invokeMethod(
+          'peerConnectionSetIceCandidateBatching', <String, dynamic>{
+        'peerConnectionId': _peerConnectionId,
+        'maxDelayMs': maxDelay.inMilliseconds,
+      });
+    } on PlatformException catch (e) {
+      throw 'Unable to RTCPeerConnection::setIceCandidateBatching: '
+          '${e.message}';
+    }
+  }
+
   @override
   Future<List<StatsReport>> getStats([MediaStreamTrack? track]) async {
     try {
@@ -474,6 +595,344 @@ class RTCPeerConnectionNative extends RTCPeerConnection {
     }
   }
 
+  /// Like [getStats], but only returns the reports and members listed in
+  /// [fields], given as `type.member` or as a report type to keep all of its
+  /// members. Filtering happens natively on Windows and Linux.
+  Future<List<StatsReport>> getFilteredStats(List<String> fields,
+      [MediaStreamTrack? track]) async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      final reports = await getStats(track);
+      return reports
+          .where((report) =>
+              fields.contains(report.type) ||
+              fields.any((field) => field.startsWith('${report.type}.')))
+          .map((report) {
+        if (fields.contains(report.type)) return report;
+        final values = Map<dynamic, dynamic>.from(report.values)
+          ..removeWhere(
+              (name, _) => !fields.contains('${report.type}.$name'));
+        return StatsReport(report.id, report.type, report.timestamp, values);
+      }).toList();
+    }
+    try {
+      final response = await WebRTC.invokeMethod('getStats', <String, dynamic>{
+        'peerConnectionId': _peerConnectionId,
+        'trackId': track?.id,
+        'fields': fields,
+      });
+      return (response['stats'] as List<dynamic>)
+          .map((report) => StatsReport(report['id'], report['type'],
+              (report['timestamp'] as num).toDouble(), report['values']))
+          .toList();
+    } on PlatformException catch (e) {
+      throw 'Unable to RTCPeerConnection::getStats: ${e.message}';
+    }
+  }
+
+  /// Returns stats as one table per report type: `type`, `ids`,
+  /// `timestamps`, the `fields` names and one entry in `columns` per field.
+  /// Numeric and boolean columns are Float64Lists with NaN for missing
+  /// values; string columns are lists with nulls. [fields] filters like in
+  /// [getFilteredStats]; an empty list keeps everything.
+  /// Only supported on Windows and Linux.
+  Future<List<Map<dynamic, dynamic>>> getColumnarStats(
+      {List<String> fields = const [], MediaStreamTrack? track}) async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      throw UnsupportedError('getColumnarStats is only supported on desktop');
+    }
+    try {
+      final response = await WebRTC.invokeMethod('getStats', <String, dynamic>{
+        'peerConnectionId': _peerConnectionId,
+        'trackId': track?.id,
+        'fields': fields,
+        'format': 'columnar',
+      });
+      return List<Map<dynamic, dynamic>>.from(response['tables']);
+    } on PlatformException catch (e) {
+      throw 'Unable to RTCPeerConnection::getStats: ${e.message}';
+    }
+  }
+
+  /// Keeps [size] peer connections pre-created for [configuration] and
+  /// [constraints], so `createPeerConnection` with exactly the same maps
+  /// returns a warm one and the pool refills in the background. When
+  /// [configuration] has no `iceCandidatePoolSize`, [iceCandidatePoolSize]
+  /// is used so pooled connections also pre-gather candidates. A [size] of
+  /// 0 stops pooling that configuration.
+  /// Only supported on Windows and Linux; elsewhere this is a no-op.
+  static Future<void> configurePool(Map<String, dynamic> configuration,
+      {Map<String, dynamic> constraints = const {},
+      int size = 1,
+      int iceCandidatePoolSize = -1}) async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      return;
+    }
+    try {
+      await WebRTC.invokeMethod(
+          'configurePeerConnectionPool', <String, dynamic>{
+        'configuration': configuration,
+        'constraints': constraints.isEmpty
+            ? defaultPeerConnectionConstraints
+            : constraints,
+        'size': size,
+        'iceCandidatePoolSize': iceCandidatePoolSize,
+      });
+    } on PlatformException catch (e) {
+      throw 'Unable to RTCPeerConnection::configurePool: ${e.message}';
+    }
+  }
+
+  /// Pool sizes, hits and misses per configuration and the average time
+  /// pooled connections took to create.
+  static Future<Map<String, dynamic>> poolStats() async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      return <String, dynamic>{};
+    }
+    final response = await WebRTC.invokeMethod('peerConnectionPoolStats');
+    return Map<String, dynamic>.from(response ?? {});
+  }
+
+  /// Times [iterations] cold peer connection creations against takes from a
+  /// filled pool. Both are timed from asking for a connection until ICE
+  /// gathering completes for an offer, so [iceCandidatePoolSize] works as it
+  /// does in [configurePool]. Returns `cold` and `warm` maps with `meanUs`,
+  /// `p50Us` and `maxUs`. Only supported on Windows and Linux.
+  static Future<Map<String, dynamic>> benchmarkPool(
+      Map<String, dynamic> configuration,
+      {Map<String, dynamic> constraints = const {},
+      int iterations = 4,
+      int iceCandidatePoolSize = -1}) async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      throw UnsupportedError('benchmarkPool is only supported on desktop');
+    }
+    try {
+      final response = await WebRTC.invokeMethod(
+          'peerConnectionPoolBenchmark', <String, dynamic>{
+        'configuration': configuration,
+        'constraints': constraints.isEmpty
+            ? defaultPeerConnectionConstraints
+            : constraints,
+        'iterations': iterations,
+        'iceCandidatePoolSize': iceCandidatePoolSize,
+      });
+      return Map<String, dynamic>.from(response);
+    } on PlatformException catch (e) {
+      throw 'Unable to RTCPeerConnection::benchmarkPool: ${e.message}';
+    }
+  }
+
+  /// Adds and removes tracks in the native registries from [writers]
+  /// threads while [readers] threads look them up, for [duration]. Run it
+  /// against a plugin built with ThreadSanitizer (-fsanitize=thread), which
+  /// reports any registry access the locks miss. Blocks the platform
+  /// thread while it runs. Returns the `writes`, `lookups` and `hits`
+  /// counts. Only supported on Windows and Linux.
+  static Future<Map<String, dynamic>> stressRegistries(
+      {int writers = 4,
+      int readers = 4,
+      Duration duration = const Duration(milliseconds: 500)}) async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      throw UnsupportedError('stressRegistries is only supported on desktop');
+    }
+    try {
+      final response = await WebRTC.invokeMethod(
+          'registryStressTest', <String, dynamic>{
+        'writers': writers,
+        'readers': readers,
+        'durationMs': duration.inMilliseconds,
+      });
+      return Map<String, dynamic>.from(response);
+    } on PlatformException catch (e) {
+      throw 'Unable to RTCPeerConnection::stressRegistries: ${e.message}';
+    }
+  }
+
+  /// Registers [tracks] remote tracks natively, [tracksPerPeer] per peer
+  /// connection, and times [rounds] passes of the track id lookup every
+  /// track handler goes through, over known and unknown ids. Returns `hit`
+  /// and `miss` maps with `meanNs`, `p50Ns` and `maxNs` per lookup. Runs
+  /// on the platform thread. Only supported on Windows and Linux.
+  static Future<Map<String, dynamic>> benchmarkRemoteTrackLookup(
+      {int tracks = 500, int tracksPerPeer = 10, int rounds = 100}) async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      throw UnsupportedError(
+          'benchmarkRemoteTrackLookup is only supported on desktop');
+    }
+    try {
+      final response = await WebRTC.invokeMethod(
+          'remoteTrackLookupBenchmark', <String, dynamic>{
+        'tracks': tracks,
+        'tracksPerPeer': tracksPerPeer,
+        'rounds': rounds,
+      });
+      return Map<String, dynamic>.from(response);
+    } on PlatformException catch (e) {
+      throw 'Unable to RTCPeerConnection::benchmarkRemoteTrackLookup: '
+          '${e.message}';
+    }
+  }
+
+  /// Times [rounds] dispatch table lookups for every registered method
+  /// channel call name, plus one unknown name. Returns `methods` (name to
+  /// nanoseconds per lookup) and its `meanNs`, `p50Ns` and `maxNs`. Only
+  /// supported on Windows and Linux.
+  static Future<Map<String, dynamic>> benchmarkMethodDispatch(
+      {int rounds = 10000}) async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      throw UnsupportedError(
+          'benchmarkMethodDispatch is only supported on desktop');
+    }
+    try {
+      final response = await WebRTC.invokeMethod(
+          'methodDispatchBenchmark', <String, dynamic>{'rounds': rounds});
+      return Map<String, dynamic>.from(response);
+    } on PlatformException catch (e) {
+      throw 'Unable to RTCPeerConnection::benchmarkMethodDispatch: '
+          '${e.message}';
+    }
+  }
+
+  /// Encodes and decodes an SDP string, a stats report, a 64 KB binary
+  /// message, typed lists and a nested list [rounds] times each with the
+  /// native StandardMessageCodec. Returns per payload `bytes`, `encodeUs`
+  /// and `decodeUs`, and throws if any payload does not decode to the
+  /// value it was encoded from. Only supported on Windows and Linux.
+  static Future<Map<String, dynamic>> benchmarkCodec({int rounds = 100}) async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      throw UnsupportedError('benchmarkCodec is only supported on desktop');
+    }
+    try {
+      final response = await WebRTC.invokeMethod(
+          'codecBenchmark', <String, dynamic>{'rounds': rounds});
+      return Map<String, dynamic>.from(response);
+    } on PlatformException catch (e) {
+      throw 'Unable to RTCPeerConnection::benchmarkCodec: ${e.message}';
+    }
+  }
+
+  /// Collects stats from every open peer connection with one native call.
+  ///
+  /// Returns `peerConnections`, mapping each peer connection id to the reply
+  /// [getFilteredStats] (or [getColumnarStats] when [columnar] is set) would
+  /// have produced, and `errors`, mapping ids whose collection failed to the
+  /// error message. Only supported on Windows and Linux.
+  static Future<Map<String, dynamic>> getStatsForAll(
+      {List<String> fields = const [], bool columnar = false}) async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      throw UnsupportedError('getStatsForAll is only supported on desktop');
+    }
+    try {
+      final response =
+          await WebRTC.invokeMethod('getStatsForAll', <String, dynamic>{
+        'fields': fields,
+        if (columnar) 'format': 'columnar',
+      });
+      return Map<String, dynamic>.from(response);
+    } on PlatformException catch (e) {
+      throw 'Unable to RTCPeerConnection::getStatsForAll: ${e.message}';
+    }
+  }
+
+  /// Samples stats natively every [interval] and delivers them to [onStats].
+  ///
+  /// Only the members listed in [fields] are sent, as `type.member` or as a
+  /// report type to keep all of its members; an empty list selects common
+  /// RTP and candidate-pair metrics. Counters also get a `<member>PerSecond`
+  /// rate, and `bitrate`, `packetLossFraction`, `jitterMs` and
+  /// `jitterBufferDelayMs` are derived where the inputs are present.
+  /// Only supported on Windows and Linux.
+  Future<void> startStatsStream(Duration interval,
+      {List<String> fields = const []}) async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      throw UnsupportedError('startStatsStream is only supported on desktop');
+    }
+    try {
+      await WebRTC.invokeMethod(
+          'peerConnectionStartStatsStream', <String, dynamic>{
+        'peerConnectionId': _peerConnectionId,
+        'intervalMs': interval.inMilliseconds,
+        'fields': fields,
+      });
+    } on PlatformException catch (e) {
+      throw 'Unable to RTCPeerConnection::startStatsStream: ${e.message}';
+    }
+  }
+
+  Future<void> stopStatsStream() async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      return;
+    }
+    try {
+      await WebRTC.invokeMethod(
+          'peerConnectionStopStatsStream', <String, dynamic>{
+        'peerConnectionId': _peerConnectionId,
+      });
+    } on PlatformException catch (e) {
+      throw 'Unable to RTCPeerConnection::stopStatsStream: ${e.message}';
+    }
+  }
+
+  /// Records stats every [interval] into a binary ring file at [path] that
+  /// keeps the last [capacity] records, without crossing the method channel.
+  /// Each sample takes one record per RTP stream plus one for the nominated
+  /// candidate pair, so the default keeps about 12 minutes of an audio+video
+  /// call at the default interval. Convert the file with
+  /// [exportStatsRecording].
+  /// Only supported on Windows and Linux.
+  Future<void> startStatsRecording(String path,
+      {Duration interval = const Duration(milliseconds: 100),
+      int capacity = 36000}) async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      throw UnsupportedError(
+          'startStatsRecording is only supported on desktop');
+    }
+    try {
+      await WebRTC.invokeMethod(
+          'peerConnectionStartStatsRecording', <String, dynamic>{
+        'peerConnectionId': _peerConnectionId,
+        'path': path,
+        'intervalMs': interval.inMilliseconds,
+        'capacity': capacity,
+      });
+    } on PlatformException catch (e) {
+      throw 'Unable to RTCPeerConnection::startStatsRecording: ${e.message}';
+    }
+  }
+
+  /// Stops recording and returns its overhead: `records`, `samples`,
+  /// `skippedSamples`, `averageWriteUs` and `maxWriteUs`.
+  Future<Map<String, dynamic>> stopStatsRecording() async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      return <String, dynamic>{};
+    }
+    try {
+      final response = await WebRTC.invokeMethod(
+          'peerConnectionStopStatsRecording', <String, dynamic>{
+        'peerConnectionId': _peerConnectionId,
+      });
+      return Map<String, dynamic>.from(response ?? {});
+    } on PlatformException catch (e) {
+      throw 'Unable to RTCPeerConnection::stopStatsRecording: ${e.message}';
+    }
+  }
+
+  /// Converts a recording made by [startStatsRecording] to CSV, oldest
+  /// record first.
+  static Future<void> exportStatsRecording(String path, String csvPath) async {
+    if (!WebRTC.platformIsWindows && !WebRTC.platformIsLinux) {
+      throw UnsupportedError(
+          'exportStatsRecording is only supported on desktop');
+    }
+    try {
+      await WebRTC.invokeMethod('exportStatsRecording', <String, dynamic>{
+        'path': path,
+        'csvPath': csvPath,
+      });
+    } on PlatformException catch (e) {
+      throw 'Unable to RTCPeerConnection::exportStatsRecording: ${e.message}';
+    }
+  }
+
   @override
   List<MediaStream> getLocalStreams() {
     return _localStreams;
@@ -557,6 +1016,9 @@ class RTCPeerConnectionNative extends RTCPeerConnection {
 
   @override
   Future<List<RTCRtpTransceiver>> getTransceivers() async {
+    if (WebRTC.platformIsWindows || WebRTC.platformIsLinux) {
+      return getTransceiversSince();
+    }
     try {
       final response = await WebRTC.invokeMethod('getTransceivers',
           <String, dynamic>{'peerConnectionId': _peerConnectionId});
@@ -567,6 +1029,47 @@ class RTCPeerConnectionNative extends RTCPeerConnection {
     }
   }
 
+  /// Asks only for the transceiver fields that changed after the last
+  /// version applied to [_transceiverStates] and merges them in.
+  /// [getTransceivers] uses this on Windows and Linux.
+  @visibleForTesting
+  Future<List<RTCRtpTransceiver>> getTransceiversSince() async {
+    try {
+      final response =
+          await WebRTC.invokeMethod('getTransceivers', <String, dynamic>{
+        'peerConnectionId': _peerConnectionId,
+        'sinceVersion': _transceiverVersion,
+      });
+      final int version = response['version'];
+      // A reply overtaken by a newer one must not roll fields back.
+      if (response['full'] == true || version > _transceiverVersion) {
+        if (response['full'] == true) {
+          _transceiverStates.clear();
+        }
+        for (final id in response['removed']) {
+          _transceiverStates.remove(id);
+        }
+        for (final Map<dynamic, dynamic> changes in response['transceivers']) {
+          final state = _transceiverStates.putIfAbsent(
+              changes['transceiverId'], () => <dynamic, dynamic>{});
+          changes.forEach((key, value) {
+            if (value is Map && state[key] is Map) {
+              state[key] = <dynamic, dynamic>{...state[key], ...value};
+            } else {
+              state[key] = value;
+            }
+          });
+        }
+        _transceiverVersion = version;
+      }
+      return RTCRtpTransceiverNative.fromMaps(
+          _transceiverStates.values.toList(),
+          peerConnectionId: _peerConnectionId);
+    } on PlatformException catch (e) {
+      throw 'Unable to RTCPeerConnection::getTransceivers: ${e.message}';
+    }
+  }
+
   @override
   Future<RTCRtpSender> addTrack(MediaStreamTrack track,
       [MediaStream? stream]) async {
@@ -78,6 +78,87 @@ EncodedType EncodedTypeForValue(const EncodableValue& value) {
   return EncodedType::kNull;
 }
 
+// Returns the number of bytes WriteSize uses to encode |size|.
+size_t EncodedSizeOfSize(size_t size) {
+  if (size < 254) {
+    return 1;
+  } else if (size <= 0xffff) {
+    return 3;
+  }
+  return 5;
+}
+
+// Returns the encoded size of a fixed-type list of |count| elements of
+// |element_size| bytes, including the worst-case alignment padding.
+size_t EncodedSizeOfVector(size_t count, size_t element_size) {
+  size_t size = EncodedSizeOfSize(count);
+  if (count > 0) {
+    size += (element_size > 1 ? element_size - 1 : 0) + count * element_size;
+  }
+  return size;
+}
+
+// Returns an upper bound on the number of bytes WriteValue will produce for
+// |value|, so encoders can size their output buffer once up front instead of
+// growing it while writing. Custom types are not counted.
+size_t EstimateEncodedSize(const EncodableValue& value) {
+  size_t size = 1;  // Type byte.
+  switch (value.index()) {
+    case 2:
+      size += 4;
+      break;
+    case 3:
+      size += 8;
+      break;
+    case 4:
+      size += 7 + 8;
+      break;
+    case 5: {
+      size_t length = std::get<std::string>(value).size();
+      size += EncodedSizeOfSize(length) + length;
+      break;
+    }
+    case 6:
+      size += EncodedSizeOfVector(std::get<std::vector<uint8_t>>(value).size(),
+                                  sizeof(uint8_t));
+      break;
+    case 7:
+      size += EncodedSizeOfVector(std::get<std::vector<int32_t>>(value).size(),
+                                  sizeof(int32_t));
+      break;
+    case 8:
+      size += EncodedSizeOfVector(std::get<std::vector<int64_t>>(value).size(),
+                                  sizeof(int64_t));
+      break;
+    case 9:
+      size += EncodedSizeOfVector(std::get<std::vector<double>>(value).size(),
+                                  sizeof(double));
+      break;
+    case 10: {
+      const auto& list = std::get<EncodableList>(value);
+      size += EncodedSizeOfSize(list.size());
+      for (const auto& item : list) {
+        size += EstimateEncodedSize(item);
+      }
+      break;
+    }
+    case 11: {
+      const auto& map = std::get<EncodableMap>(value);
+      size += EncodedSizeOfSize(map.size());
+      for (const auto& pair : map) {
+        size += EstimateEncodedSize(pair.first);
+        size += EstimateEncodedSize(pair.second);
+      }
+      break;
+    }
+    case 13:
+      size += EncodedSizeOfVector(std::get<std::vector<float>>(value).size(),
+                                  sizeof(float));
+      break;
+  }
+  return size;
+}
+
 }  // namespace
 
 StandardCodecSerializer::StandardCodecSerializer() = default;
@@ -187,8 +268,10 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
       size_t size = ReadSize(stream);
       std::string string_value;
       string_value.resize(size);
-      stream->ReadBytes(reinterpret_cast<uint8_t*>(&string_value[0]), size);
-      return EncodableValue(string_value);
+      if (size > 0) {
+        stream->ReadBytes(reinterpret_cast<uint8_t*>(&string_value[0]), size);
+      }
+      return EncodableValue(std::move(string_value));
     }
     case EncodedType::kUInt8List:
       return ReadVector<uint8_t>(stream);
@@ -205,7 +288,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
       for (size_t i = 0; i < length; ++i) {
         list_value.push_back(ReadValue(stream));
       }
-      return EncodableValue(list_value);
+      return EncodableValue(std::move(list_value));
     }
     case EncodedType::kMap: {
       size_t length = ReadSize(stream);
@@ -215,7 +298,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
         EncodableValue value = ReadValue(stream);
         map_value.emplace(std::move(key), std::move(value));
       }
-      return EncodableValue(map_value);
+      return EncodableValue(std::move(map_value));
     }
     case EncodedType::kFloat32List: {
       return ReadVector<float>(stream);
@@ -266,13 +349,15 @@ EncodableValue StandardCodecSerializer::ReadVector(
   if (type_size > 1) {
     stream->ReadAlignment(type_size);
   }
-  stream->ReadBytes(reinterpret_cast<uint8_t*>(vector.data()),
-                    count * type_size);
-  return EncodableValue(vector);
+  if (count > 0) {
+    stream->ReadBytes(reinterpret_cast<uint8_t*>(vector.data()),
+                      count * type_size);
+  }
+  return EncodableValue(std::move(vector));
 }
 
 template <typename T>
-void StandardCodecSerializer::WriteVector(const std::vector<T> vector,
+void StandardCodecSerializer::WriteVector(const std::vector<T>& vector,
                                           ByteStreamWriter* stream) const {
   size_t count = vector.size();
   WriteSize(count, stream);
@@ -329,6 +414,7 @@ std::unique_ptr<std::vector<uint8_t>>
 StandardMessageCodec::EncodeMessageInternal(
     const EncodableValue& message) const {
   auto encoded = std::make_unique<std::vector<uint8_t>>();
+  encoded->reserve(EstimateEncodedSize(message));
   ByteBufferStreamWriter stream(encoded.get());
   serializer_->WriteValue(message, &stream);
   return encoded;
@@ -383,6 +469,11 @@ std::unique_ptr<std::vector<uint8_t>>
 StandardMethodCodec::EncodeMethodCallInternal(
     const MethodCall<EncodableValue>& method_call) const {
   auto encoded = std::make_unique<std::vector<uint8_t>>();
+  encoded->reserve(
+      EncodedSizeOfSize(method_call.method_name().size()) + 1 +
+      method_call.method_name().size() +
+      (method_call.arguments() ? EstimateEncodedSize(*method_call.arguments())
+                               : 1));
   ByteBufferStreamWriter stream(encoded.get());
   serializer_->WriteValue(EncodableValue(method_call.method_name()), &stream);
   if (method_call.arguments()) {
@@ -397,6 +488,7 @@ std::unique_ptr<std::vector<uint8_t>>
 StandardMethodCodec::EncodeSuccessEnvelopeInternal(
     const EncodableValue* result) const {
   auto encoded = std::make_unique<std::vector<uint8_t>>();
+  encoded->reserve(1 + (result ? EstimateEncodedSize(*result) : 1));
   ByteBufferStreamWriter stream(encoded.get());
   stream.WriteByte(0);
   if (result) {
@@ -1,3 +1,6 @@
+// Dart imports:
+import 'dart:typed_data';
+
 // Flutter imports:
 import 'package:flutter/services.dart';
 
@@ -35,6 +38,7 @@ void main() {
       'iceGatheringState',
       'iceConnectionState',
       'onCandidate',
+      'onIceCandidates',
       'onAddStream',
       'onRemoveStream',
       'onAddTrack',
@@ -51,6 +55,18 @@ void main() {
         'flutterId': '',
         'state': 'open'
       });
+      channel.eventListener(<String, dynamic>{
+        'event': 'dataChannelReceiveMessages',
+        'id': 0,
+        'flutterId': '',
+        'messages': ['', Uint8List(0)]
+      });
+      channel.eventListener(<String, dynamic>{
+        'event': 'dataChannelBufferedAmountLow',
+        'id': 0,
+        'flutterId': '',
+        'bufferedAmount': 0
+      });
     };
 
     for (var event in events) {
@@ -63,6 +79,11 @@ void main() {
         //Minimum values for onCandidate
         'candidate': {'candidate': '', 'sdpMid': '', 'sdpMLineIndex': 1},
 
+        //Minimum values for onIceCandidates
+        'candidates': [
+          {'candidate': '', 'sdpMid': '', 'sdpMLineIndex': 1}
+        ],
+
         //Minimum values for onAddStream
         'streamId': '',
         'audioTracks': [],
@@ -84,4 +105,105 @@ void main() {
       });
     }
   });
+
+  test('Batched candidates fall back to onIceCandidate', () {
+    final pc = RTCPeerConnectionNative('', {});
+    final received = <String?>[];
+    pc.onIceCandidate = (candidate) => received.add(candidate.candidate);
+    pc.eventListener(<String, dynamic>{
+      'event': 'onIceCandidates',
+      'candidates': [
+        {'candidate': 'a', 'sdpMid': '0', 'sdpMLineIndex': 0},
+        {'candidate': 'b', 'sdpMid': '0', 'sdpMLineIndex': 0},
+      ],
+    });
+    expect(received, ['a', 'b']);
+  });
+
+  group('getTransceiversSince', () {
+    Map<String, dynamic> rtpParameters() => {
+          'transactionId': '',
+          'rtcp': {'cname': '', 'reducedSize': false},
+          'headerExtensions': [],
+          'encodings': [],
+          'codecs': [],
+        };
+
+    Map<String, dynamic> track(String id) =>
+        {'id': id, 'label': id, 'kind': 'audio', 'enabled': true};
+
+    Map<String, dynamic> transceiver(String id) => {
+          'transceiverId': id,
+          'mid': '',
+          'direction': 'sendrecv',
+          'sender': {
+            'senderId': 'sender-$id',
+            'ownsTrack': false,
+            'track': {},
+            'rtpParameters': rtpParameters(),
+          },
+          'receiver': {
+            'receiverId': 'receiver-$id',
+            'track': track('remote-$id'),
+            'rtpParameters': rtpParameters(),
+          },
+        };
+
+    test('merges full, diff and stale replies', () async {
+      final replies = <Map<String, dynamic>>[
+        {
+          'version': 1,
+          'full': true,
+          'removed': [],
+          'transceivers': [transceiver('t0'), transceiver('t1')],
+        },
+        {
+          'version': 2,
+          'full': false,
+          'removed': ['t1'],
+          'transceivers': [
+            {
+              'transceiverId': 't0',
+              'mid': '0',
+              'sender': {'track': track('local-audio')},
+            },
+            transceiver('t2'),
+          ],
+        },
+        // Overtaken by version 2; must not change anything.
+        {
+          'version': 1,
+          'full': false,
+          'removed': ['t0'],
+          'transceivers': [
+            {'transceiverId': 't2', 'mid': 'stale'},
+          ],
+        },
+      ];
+      final sinceVersions = <dynamic>[];
+      channel.setMockMethodCallHandler((MethodCall methodCall) async {
+        expect(methodCall.method, 'getTransceivers');
+        sinceVersions.add(methodCall.arguments['sinceVersion']);
+        return replies.removeAt(0);
+      });
+      final pc = RTCPeerConnectionNative('', {});
+
+      var transceivers = await pc.getTransceiversSince();
+      expect(transceivers.map((t) => t.transceiverId), ['t0', 't1']);
+
+      transceivers = await pc.getTransceiversSince();
+      expect(transceivers.map((t) => t.transceiverId), ['t0', 't2']);
+      final merged = transceivers.first;
+      expect(merged.mid, '0');
+      expect(merged.sender.senderId, 'sender-t0');
+      expect(merged.sender.track?.id, 'local-audio');
+      expect(merged.receiver.track.id, 'remote-t0');
+
+      transceivers = await pc.getTransceiversSince();
+      expect(transceivers.map((t) => t.transceiverId), ['t0', 't2']);
+      expect(transceivers.last.mid, '');
+
+      expect(sinceVersions, [-1, 1, 2]);
+    });
+  });
 }
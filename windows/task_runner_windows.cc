@@ -41,7 +41,7 @@
  void TaskRunnerWindows::EnqueueTask(TaskClosure task) {
    {
      std::lock_guard<std::mutex> lock(tasks_mutex_);
-     tasks_.push(task);
+     tasks_.push(std::move(task));
    }
    if (!PostMessage(window_handle_, WM_NULL, 0, 0)) {
      DWORD error_code = GetLastError();
@@ -57,7 +57,7 @@
    for (;;) {
      std::lock_guard<std::mutex> lock(tasks_mutex_);
      if (tasks_.empty()) break;
-     TaskClosure task = tasks_.front();
+     TaskClosure task = std::move(tasks_.front());
      tasks_.pop();
      task();
    }